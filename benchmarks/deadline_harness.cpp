@@ -0,0 +1,590 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+  Drives a plugin chain from a simulated driver thread with the deadlines of a real quantum. The driver asks for
+  SCHED_FIFO like the PipeWire data thread and sleeps until the start of every cycle. Meanwhile the main thread plays
+  the part of the user interface: it changes parameters, switches the quantum and applies whole presets at a time.
+
+  For the chain and for every plugin it reports the distribution of the block processing times, the deadline misses,
+  the wake up latency of the driver and the waits for the data mutex of each plugin. Blocks in which the quantum
+  changed are reported apart because they run setup(), like on_process() does.
+*/
+
+#include <gio/gio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "effects_base.hpp"
+#include "tags_app.hpp"
+#include "tags_plugin_name.hpp"
+#include "util.hpp"
+
+namespace {
+
+const std::string log_tag = "deadline harness: ";
+
+constexpr auto quanta = std::to_array<uint>({64U, 128U, 256U, 512U, 1024U, 2048U});
+
+constexpr auto max_quantum = 2048U;
+
+// Bypass would leave most of the chain idle and the sidechain links need a PipeWire graph.
+constexpr auto ignored_keys = std::to_array<std::string_view>({"bypass", "sidechain-type", "sidechain-input-device"});
+
+class LatencyHistogram {
+ public:
+  void record(const uint64_t& ns) {
+    const auto bin = (ns <= min_ns) ? 0U
+                                    : std::min(static_cast<size_t>(bins_per_decade *
+                                                                   std::log10(static_cast<double>(ns) / min_ns)),
+                                               n_bins - 1U);
+
+    bins[bin]++;
+
+    n_values++;
+
+    total_ns += ns;
+
+    worst_ns = std::max(worst_ns, ns);
+  }
+
+  [[nodiscard]] auto percentile(const double& p) const -> double {
+    const auto target = static_cast<uint64_t>(std::ceil(p * static_cast<double>(n_values)));
+
+    uint64_t count = 0U;
+
+    for (size_t n = 0U; n < n_bins; n++) {
+      count += bins[n];
+
+      if (count >= target) {
+        // the upper edge of the bin, but never more than what was measured
+
+        return std::min(min_ns * std::pow(10.0, static_cast<double>(n + 1U) / bins_per_decade),
+                        static_cast<double>(worst_ns));
+      }
+    }
+
+    return static_cast<double>(worst_ns);
+  }
+
+  [[nodiscard]] auto to_json() const -> nlohmann::json {
+    if (n_values == 0U) {
+      return {{"count", 0}};
+    }
+
+    return {{"count", n_values},
+            {"mean_ns", static_cast<double>(total_ns) / static_cast<double>(n_values)},
+            {"p50_ns", percentile(0.5)},
+            {"p90_ns", percentile(0.9)},
+            {"p99_ns", percentile(0.99)},
+            {"p999_ns", percentile(0.999)},
+            {"worst_ns", worst_ns}};
+  }
+
+ private:
+  // 50 bins per decade from 100 ns to 1 s, so each bin is about 5 % wide
+
+  static constexpr double min_ns = 100.0;
+
+  static constexpr double bins_per_decade = 50.0;
+
+  static constexpr size_t n_bins = 7U * 50U + 1U;
+
+  std::array<uint64_t, n_bins> bins{};
+
+  uint64_t n_values = 0U, total_ns = 0U, worst_ns = 0U;
+};
+
+struct Parameter {
+  GSettings* settings = nullptr;
+
+  std::string key;
+
+  char type = 'b';  // b, d, i or s for enums
+
+  double min = 0.0, max = 0.0;
+
+  std::vector<std::string> choices;
+};
+
+struct Driver {
+  std::vector<std::shared_ptr<PluginBase>> chain;
+
+  uint rate = 48000U;
+
+  int priority = 88;
+
+  std::atomic<uint> quantum = 256U;
+
+  std::atomic<bool> running = true;
+
+  bool realtime = false;
+
+  uint64_t n_cycles = 0U, n_misses = 0U, n_quantum_changes = 0U, n_quantum_change_misses = 0U;
+
+  LatencyHistogram chain_blocks, setup_blocks, wakeup;
+
+  std::vector<LatencyHistogram> plugin_blocks;
+
+  void run();
+};
+
+struct Harness {
+  Driver driver;
+
+  std::vector<Parameter> parameters;
+
+  std::mt19937 generator;
+
+  GMainLoop* loop = nullptr;
+
+  uint64_t n_parameter_changes = 0U, n_preset_switches = 0U;
+};
+
+auto elapsed_ns(const std::chrono::steady_clock::time_point& t0, const std::chrono::steady_clock::time_point& t1)
+    -> uint64_t {
+  return static_cast<uint64_t>(std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(), 0L));
+}
+
+void Driver::run() {
+  sched_param param{};
+
+  param.sched_priority = priority;
+
+  realtime = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+
+  if (!realtime) {
+    util::warning(log_tag + "could not set SCHED_FIFO. The results will include the scheduling noise.");
+  }
+
+  plugin_blocks.resize(chain.size());
+
+  // The plugins are allowed to change their input, so a fresh copy of the noise is used in every cycle.
+
+  std::vector<float> noise_left(max_quantum), noise_right(max_quantum);
+
+  std::mt19937 noise_generator(1234U);
+
+  std::uniform_real_distribution<float> distribution(-0.25F, 0.25F);
+
+  for (uint n = 0U; n < max_quantum; n++) {
+    noise_left[n] = distribution(noise_generator);
+    noise_right[n] = distribution(noise_generator);
+  }
+
+  std::vector<float> left_a(max_quantum), right_a(max_quantum), left_b(max_quantum), right_b(max_quantum);
+
+  uint current_quantum = 0U;
+
+  auto next_cycle = std::chrono::steady_clock::now();
+
+  while (running.load(std::memory_order_relaxed)) {
+    const auto q = quantum.load(std::memory_order_relaxed);
+
+    const auto quantum_changed = q != current_quantum;
+
+    current_quantum = q;
+
+    const auto period = std::chrono::nanoseconds(static_cast<uint64_t>(q) * 1000000000U / rate);
+
+    std::copy_n(noise_left.begin(), q, left_a.begin());
+    std::copy_n(noise_right.begin(), q, right_a.begin());
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::span<float> left_in(left_a.data(), q);
+    std::span<float> right_in(right_a.data(), q);
+    std::span<float> left_out(left_b.data(), q);
+    std::span<float> right_out(right_b.data(), q);
+
+    auto t_plugin = t0;
+
+    for (size_t n = 0U; n < chain.size(); n++) {
+      if (quantum_changed) {
+        chain[n]->setup_offline(rate, q);
+      }
+
+      chain[n]->process_offline(left_in, right_in, left_out, right_out, rate);
+
+      const auto t = std::chrono::steady_clock::now();
+
+      if (!quantum_changed) {
+        plugin_blocks[n].record(elapsed_ns(t_plugin, t));
+      }
+
+      t_plugin = t;
+
+      std::swap(left_in, left_out);
+      std::swap(right_in, right_out);
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    // the first cycle only initializes the plugins
+
+    if (n_cycles > 0U) {
+      wakeup.record(elapsed_ns(next_cycle, t0));
+
+      const auto missed = t1 > next_cycle + period;
+
+      n_misses += missed ? 1U : 0U;
+
+      if (quantum_changed) {
+        n_quantum_changes++;
+
+        n_quantum_change_misses += missed ? 1U : 0U;
+
+        setup_blocks.record(elapsed_ns(t0, t1));
+      } else {
+        chain_blocks.record(elapsed_ns(t0, t1));
+      }
+    }
+
+    n_cycles++;
+
+    // After an overrun a real driver starts the next cycle right away instead of trying to catch up.
+
+    next_cycle = std::max(next_cycle + period, std::chrono::steady_clock::now());
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(next_cycle.time_since_epoch()).count();
+
+    timespec deadline{.tv_sec = ns / 1000000000, .tv_nsec = ns % 1000000000};
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+  }
+}
+
+auto list_parameters(const std::shared_ptr<PluginBase>& plugin) -> std::vector<Parameter> {
+  std::vector<Parameter> parameters;
+
+  auto* settings = plugin->get_settings();
+
+  GSettingsSchema* schema = nullptr;
+
+  g_object_get(settings, "settings-schema", &schema, nullptr);
+
+  auto* keys = g_settings_schema_list_keys(schema);
+
+  for (size_t k = 0U; keys[k] != nullptr; k++) {
+    if (std::ranges::find(ignored_keys, std::string_view(keys[k])) != ignored_keys.end()) {
+      continue;
+    }
+
+    auto* schema_key = g_settings_schema_get_key(schema, keys[k]);
+
+    auto* range = g_settings_schema_key_get_range(schema_key);
+
+    const gchar* kind = nullptr;
+    GVariant* detail = nullptr;
+
+    g_variant_get(range, "(&sv)", &kind, &detail);
+
+    Parameter parameter{.settings = settings, .key = keys[k]};
+
+    if (std::strcmp(kind, "range") == 0 && g_variant_is_of_type(detail, G_VARIANT_TYPE("(dd)")) != 0) {
+      parameter.type = 'd';
+
+      g_variant_get(detail, "(dd)", &parameter.min, &parameter.max);
+
+      parameters.push_back(parameter);
+    } else if (std::strcmp(kind, "range") == 0 && g_variant_is_of_type(detail, G_VARIANT_TYPE("(ii)")) != 0) {
+      int min = 0;
+      int max = 0;
+
+      g_variant_get(detail, "(ii)", &min, &max);
+
+      parameter.type = 'i';
+      parameter.min = min;
+      parameter.max = max;
+
+      parameters.push_back(parameter);
+    } else if (std::strcmp(kind, "enum") == 0) {
+      parameter.type = 's';
+
+      for (size_t n = 0U; n < g_variant_n_children(detail); n++) {
+        const gchar* choice = nullptr;
+
+        g_variant_get_child(detail, n, "&s", &choice);
+
+        parameter.choices.emplace_back(choice);
+      }
+
+      parameters.push_back(parameter);
+    } else if (std::strcmp(kind, "type") == 0 &&
+               g_variant_type_equal(g_settings_schema_key_get_value_type(schema_key), G_VARIANT_TYPE_BOOLEAN) != 0) {
+      parameter.type = 'b';
+
+      parameters.push_back(parameter);
+    }
+
+    g_variant_unref(detail);
+    g_variant_unref(range);
+    g_settings_schema_key_unref(schema_key);
+  }
+
+  g_strfreev(keys);
+
+  g_settings_schema_unref(schema);
+
+  return parameters;
+}
+
+void change_parameter(const Parameter& parameter, std::mt19937& generator) {
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+  const auto x = distribution(generator);
+
+  switch (parameter.type) {
+    case 'd':
+      g_settings_set_double(parameter.settings, parameter.key.c_str(),
+                            parameter.min + x * (parameter.max - parameter.min));
+      break;
+    case 'i':
+      g_settings_set_int(parameter.settings, parameter.key.c_str(),
+                         static_cast<int>(std::lround(parameter.min + x * (parameter.max - parameter.min))));
+      break;
+    case 's':
+      g_settings_set_string(
+          parameter.settings, parameter.key.c_str(),
+          parameter.choices[std::min(static_cast<size_t>(x * static_cast<double>(parameter.choices.size())),
+                                     parameter.choices.size() - 1U)]
+              .c_str());
+      break;
+    default:
+      g_settings_set_boolean(parameter.settings, parameter.key.c_str(), static_cast<gboolean>(x < 0.5));
+      break;
+  }
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  // The harness changes the settings of the plugins. They must never reach the settings of the user.
+
+  g_setenv("GSETTINGS_BACKEND", "memory", 1);
+
+  double seconds = 10.0;
+  int rate = 48000;
+  int initial_quantum = 256;
+  int priority = 88;
+  int parameter_interval = 50;
+  int quantum_interval = 2000;
+  int preset_interval = 5000;
+  int seed = 1;
+  int max_misses = -1;
+  gchar* output_path = nullptr;
+  gchar* plugins_arg = nullptr;
+
+  std::array<GOptionEntry, 12U> entries{
+      {{"seconds", 's', 0, G_OPTION_ARG_DOUBLE, &seconds, "Duration of the run. The default is 10 s", "S"},
+       {"rate", 'r', 0, G_OPTION_ARG_INT, &rate, "Sampling rate. The default is 48000 Hz", "HZ"},
+       {"quantum", 'q', 0, G_OPTION_ARG_INT, &initial_quantum, "Initial quantum. The default is 256 frames", "N"},
+       {"priority", 0, 0, G_OPTION_ARG_INT, &priority, "SCHED_FIFO priority of the driver. The default is 88", "N"},
+       {"parameter-interval", 0, 0, G_OPTION_ARG_INT, &parameter_interval,
+        "Milliseconds between parameter changes. The default is 50", "MS"},
+       {"quantum-interval", 0, 0, G_OPTION_ARG_INT, &quantum_interval,
+        "Milliseconds between quantum changes. The default is 2000", "MS"},
+       {"preset-interval", 0, 0, G_OPTION_ARG_INT, &preset_interval,
+        "Milliseconds between preset switches. The default is 5000", "MS"},
+       {"seed", 0, 0, G_OPTION_ARG_INT, &seed, "Seed of the random changes", "N"},
+       {"max-misses", 0, 0, G_OPTION_ARG_INT, &max_misses, "Fail when there are more deadline misses than N", "N"},
+       {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output_path, "Write the results to FILE instead of stdout", "FILE"},
+       {"plugins", 'p', 0, G_OPTION_ARG_STRING, &plugins_arg,
+        "Comma separated list of plugins in the chain. The default is all", "LIST"},
+       {nullptr}}};
+
+  auto* context = g_option_context_new("- run a plugin chain against realtime deadlines");
+
+  g_option_context_add_main_entries(context, entries.data(), nullptr);
+
+  if (GError* error = nullptr; g_option_context_parse(context, &argc, &argv, &error) == 0) {
+    std::cerr << error->message << std::endl;
+
+    g_error_free(error);
+    g_option_context_free(context);
+
+    return EXIT_FAILURE;
+  }
+
+  g_option_context_free(context);
+
+  std::vector<std::string> plugin_names(tags::plugin_name::list.begin(), tags::plugin_name::list.end());
+
+  if (plugins_arg != nullptr) {
+    plugin_names.clear();
+
+    std::istringstream stream(plugins_arg);
+
+    for (std::string name; std::getline(stream, name, ',');) {
+      plugin_names.push_back(name);
+    }
+  }
+
+  Harness harness;
+
+  harness.generator.seed(static_cast<uint>(seed));
+
+  harness.driver.rate = static_cast<uint>(std::max(rate, 1));
+  harness.driver.priority = priority;
+  harness.driver.quantum = std::clamp(static_cast<uint>(std::max(initial_quantum, 1)), 1U, max_quantum);
+
+  for (const auto& name : plugin_names) {
+    auto plugin = EffectsBase::create_plugin(name + "#0", log_tag, tags::app::path_stream_outputs, nullptr);
+
+    if (plugin == nullptr || !plugin->package_installed) {
+      util::warning(log_tag + "skipping " + name);
+
+      continue;
+    }
+
+    const auto parameters = list_parameters(plugin);
+
+    harness.parameters.insert(harness.parameters.end(), parameters.begin(), parameters.end());
+
+    harness.driver.chain.push_back(plugin);
+  }
+
+  if (harness.driver.chain.empty()) {
+    std::cerr << "The chain is empty" << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  // The main thread changes the settings like the user interface would. The plugins react to them in this thread.
+
+  harness.loop = g_main_loop_new(nullptr, 0);
+
+  if (parameter_interval > 0 && !harness.parameters.empty()) {
+    g_timeout_add(parameter_interval, GSourceFunc(+[](Harness* h) {
+                    std::uniform_int_distribution<size_t> choice(0U, h->parameters.size() - 1U);
+
+                    change_parameter(h->parameters[choice(h->generator)], h->generator);
+
+                    h->n_parameter_changes++;
+
+                    return G_SOURCE_CONTINUE;
+                  }),
+                  &harness);
+  }
+
+  if (quantum_interval > 0) {
+    g_timeout_add(quantum_interval, GSourceFunc(+[](Harness* h) {
+                    std::uniform_int_distribution<size_t> choice(0U, quanta.size() - 1U);
+
+                    h->driver.quantum = quanta[choice(h->generator)];
+
+                    return G_SOURCE_CONTINUE;
+                  }),
+                  &harness);
+  }
+
+  if (preset_interval > 0) {
+    // A preset switch changes every parameter of every plugin in one go.
+
+    g_timeout_add(preset_interval, GSourceFunc(+[](Harness* h) {
+                    for (const auto& parameter : h->parameters) {
+                      change_parameter(parameter, h->generator);
+                    }
+
+                    h->n_preset_switches++;
+
+                    return G_SOURCE_CONTINUE;
+                  }),
+                  &harness);
+  }
+
+  g_timeout_add(static_cast<uint>(1000.0 * seconds), GSourceFunc(+[](Harness* h) {
+                  g_main_loop_quit(h->loop);
+
+                  return G_SOURCE_REMOVE;
+                }),
+                &harness);
+
+  std::thread driver_thread([&]() { harness.driver.run(); });
+
+  g_main_loop_run(harness.loop);
+
+  harness.driver.running = false;
+
+  driver_thread.join();
+
+  g_main_loop_unref(harness.loop);
+
+  const auto& driver = harness.driver;
+
+  nlohmann::json plugins = nlohmann::json::array();
+
+  for (size_t n = 0U; n < driver.chain.size(); n++) {
+    const auto lock_stats = driver.chain[n]->get_lock_stats();
+
+    plugins.push_back({{"plugin", driver.chain[n]->name},
+                       {"blocks", driver.plugin_blocks[n].to_json()},
+                       {"lock_waits",
+                        {{"count", lock_stats.n_waits},
+                         {"total_ns", lock_stats.total_wait_ns},
+                         {"worst_ns", lock_stats.worst_wait_ns}}}});
+  }
+
+  const nlohmann::json report = {{"version", VERSION},
+                                 {"rate", driver.rate},
+                                 {"seconds", seconds},
+                                 {"realtime", driver.realtime},
+                                 {"cycles", driver.n_cycles},
+                                 {"deadline_misses", driver.n_misses},
+                                 {"quantum_changes", driver.n_quantum_changes},
+                                 {"deadline_misses_on_quantum_change", driver.n_quantum_change_misses},
+                                 {"parameter_changes", harness.n_parameter_changes},
+                                 {"preset_switches", harness.n_preset_switches},
+                                 {"chain_blocks", driver.chain_blocks.to_json()},
+                                 {"setup_blocks", driver.setup_blocks.to_json()},
+                                 {"wakeup", driver.wakeup.to_json()},
+                                 {"plugins", plugins}};
+
+  if (output_path != nullptr) {
+    std::ofstream(output_path) << report.dump(2) << std::endl;
+  } else {
+    std::cout << report.dump(2) << std::endl;
+  }
+
+  g_free(output_path);
+  g_free(plugins_arg);
+
+  return (max_misses >= 0 && driver.n_misses > static_cast<uint64_t>(max_misses)) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
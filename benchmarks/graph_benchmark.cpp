@@ -0,0 +1,385 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+/*
+  Measures the graph operations of Easy Effects against the in_process PipeWire backend, so the numbers do not depend
+  on the daemon, the session manager or the devices of the machine. Three scenarios are run:
+
+  connect_filters: set_bypass(false) on the output pipeline, which destroys and creates every link of the chain.
+  preset_switch: two output presets with different plugin lists are loaded one after the other.
+  hotplug_storm: a burst of sinks is created and destroyed and we wait until PipeManager saw all of them come and go.
+
+  Every scenario is repeated for each value of --round-trip-us, the delay added to each PipeManager round trip. For
+  each iteration the report splits the wall time into the time spent waiting on round trips and the rest, which is
+  our own code plus the in-process server. The hotplug storm polls the node list every 100 us and this granularity
+  is part of its own time.
+*/
+
+#include <gio/gio.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "config.h"
+#include "pipe_manager.hpp"
+#include "preset_type.hpp"
+#include "presets_manager.hpp"
+#include "stream_output_effects.hpp"
+#include "tags_pipewire.hpp"
+#include "tags_schema.hpp"
+#include "util.hpp"
+
+namespace {
+
+const std::string log_tag = "graph benchmark: ";
+
+constexpr auto output_device_name = "ee_benchmark_output";
+
+constexpr auto hotplug_name_prefix = "ee_benchmark_hotplug_";
+
+// Only plugins implemented by us or by libraries we link to, so the benchmark does not depend on the LV2 bundles.
+
+constexpr auto default_chain = "autogain#0,crossfeed#0,crystalizer#0,pitch#0";
+
+constexpr auto default_alternative_chain = "crystalizer#0,speex#0";
+
+struct Iteration {
+  uint64_t total_ns = 0U;
+
+  uint64_t round_trip_ns = 0U;
+
+  uint64_t n_round_trips = 0U;
+};
+
+auto elapsed_ns(const std::chrono::steady_clock::time_point& t0, const std::chrono::steady_clock::time_point& t1)
+    -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+}
+
+auto split(const std::string& list) -> std::vector<std::string> {
+  std::vector<std::string> output;
+
+  std::istringstream stream(list);
+
+  for (std::string name; std::getline(stream, name, ',');) {
+    output.push_back(name);
+  }
+
+  return output;
+}
+
+// The signals of PipeManager reach us through idle sources. Nothing runs the main loop here, so we do it ourselves.
+
+void iterate_main_context() {
+  while (g_main_context_iteration(nullptr, 0) != 0) {
+  }
+}
+
+auto count_nodes(PipeManager& pm, const std::string& prefix) -> size_t {
+  // node_map is only modified by the PipeWire thread while it holds the loop lock
+
+  pm.lock();
+
+  const auto n = std::ranges::count_if(pm.node_map, [&](const auto& p) { return p.second.name.starts_with(prefix); });
+
+  pm.unlock();
+
+  return static_cast<size_t>(n);
+}
+
+auto wait_for_nodes(PipeManager& pm, const std::string& prefix, const size_t& n) -> bool {
+  const auto t0 = std::chrono::steady_clock::now();
+
+  while (count_nodes(pm, prefix) != n) {
+    iterate_main_context();
+
+    if (std::chrono::steady_clock::now() - t0 > std::chrono::seconds(10)) {
+      util::warning(log_tag + "timeout while waiting for the nodes " + prefix);
+
+      return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  return true;
+}
+
+// The caller has to hold the PipeWire loop lock
+
+auto create_sink(PipeManager& pm, const std::string& name) -> pw_proxy* {
+  pw_properties* props = pw_properties_new(nullptr, nullptr);
+
+  pw_properties_set(props, PW_KEY_NODE_NAME, name.c_str());
+  pw_properties_set(props, PW_KEY_NODE_DESCRIPTION, name.c_str());
+  pw_properties_set(props, PW_KEY_OBJECT_LINGER, "false");
+  pw_properties_set(props, "factory.name", "support.null-audio-sink");
+  pw_properties_set(props, PW_KEY_MEDIA_CLASS, tags::pipewire::media_class::sink);
+  pw_properties_set(props, "audio.position", "FL,FR");
+  pw_properties_set(props, "adapter.auto-port-config", "{ mode = dsp monitor = false position = preserve }");
+
+  auto* proxy = static_cast<pw_proxy*>(
+      pw_core_create_object(pm.core, "adapter", PW_TYPE_INTERFACE_Node, PW_VERSION_NODE, &props->dict, 0));
+
+  pw_properties_free(props);
+
+  return proxy;
+}
+
+auto measure(PipeManager& pm, const int& iterations, const std::function<void(const int&)>& callback)
+    -> std::vector<Iteration> {
+  std::vector<Iteration> output;
+
+  output.reserve(static_cast<size_t>(iterations));
+
+  for (int n = 0; n < iterations; n++) {
+    iterate_main_context();
+
+    pm.reset_round_trip_stats();
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    callback(n);
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    const auto stats = pm.get_round_trip_stats();
+
+    output.push_back(
+        {.total_ns = elapsed_ns(t0, t1), .round_trip_ns = stats.wait_ns, .n_round_trips = stats.n_round_trips});
+  }
+
+  return output;
+}
+
+auto to_json(const std::string& scenario, const uint& delay_us, std::vector<Iteration> iterations) -> nlohmann::json {
+  if (iterations.empty()) {
+    return {{"scenario", scenario}, {"round_trip_delay_us", delay_us}, {"iterations", 0}};
+  }
+
+  const auto n = static_cast<double>(iterations.size());
+
+  double total = 0.0;
+  double round_trips = 0.0;
+  double n_round_trips = 0.0;
+
+  for (const auto& it : iterations) {
+    total += static_cast<double>(it.total_ns);
+    round_trips += static_cast<double>(it.round_trip_ns);
+    n_round_trips += static_cast<double>(it.n_round_trips);
+  }
+
+  std::ranges::sort(iterations, {}, &Iteration::total_ns);
+
+  return {{"scenario", scenario},
+          {"round_trip_delay_us", delay_us},
+          {"iterations", iterations.size()},
+          {"mean_ms", total / n * 1e-6},
+          {"median_ms", static_cast<double>(iterations[iterations.size() / 2U].total_ns) * 1e-6},
+          {"max_ms", static_cast<double>(iterations.back().total_ns) * 1e-6},
+          {"round_trips_per_iteration", n_round_trips / n},
+          {"round_trip_ms", round_trips / n * 1e-6},
+          {"own_ms", (total - round_trips) / n * 1e-6},
+          {"round_trip_fraction", (total > 0.0) ? round_trips / total : 0.0}};
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+  using namespace std::string_literals;
+
+  /*
+    The benchmark changes the settings of the output pipeline and writes presets. They must never reach the settings
+    and the presets of the user.
+  */
+
+  const auto config_dir = std::filesystem::temp_directory_path() / "easyeffects-graph-benchmark";
+
+  g_setenv("GSETTINGS_BACKEND", "memory", 1);
+  g_setenv("XDG_CONFIG_HOME", config_dir.c_str(), 1);
+
+  int iterations = 20;
+  int storm_size = 32;
+  gchar* delays_arg = nullptr;
+  gchar* output_path = nullptr;
+  gchar* plugins_arg = nullptr;
+  gchar* alternative_arg = nullptr;
+
+  std::array<GOptionEntry, 7U> entries{
+      {{"iterations", 'n', 0, G_OPTION_ARG_INT, &iterations, "Repetitions of each scenario. The default is 20", "N"},
+       {"storm-size", 's', 0, G_OPTION_ARG_INT, &storm_size, "Sinks created in each hotplug storm. The default is 32",
+        "N"},
+       {"round-trip-us", 'r', 0, G_OPTION_ARG_STRING, &delays_arg,
+        "Comma separated delays added to each round trip. The default is 0,100,1000", "LIST"},
+       {"plugins", 'p', 0, G_OPTION_ARG_STRING, &plugins_arg, "Comma separated plugin chain of the output pipeline",
+        "LIST"},
+       {"alternative-plugins", 'a', 0, G_OPTION_ARG_STRING, &alternative_arg,
+        "Plugin chain of the second preset used by preset_switch", "LIST"},
+       {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output_path, "Write the results to FILE instead of stdout", "FILE"},
+       {nullptr}}};
+
+  auto* context = g_option_context_new("- benchmark the Easy Effects graph operations");
+
+  g_option_context_add_main_entries(context, entries.data(), nullptr);
+
+  if (GError* error = nullptr; g_option_context_parse(context, &argc, &argv, &error) == 0) {
+    std::cerr << error->message << std::endl;
+
+    g_error_free(error);
+    g_option_context_free(context);
+
+    return EXIT_FAILURE;
+  }
+
+  g_option_context_free(context);
+
+  std::vector<uint> delays;
+
+  for (const auto& value : split((delays_arg != nullptr) ? delays_arg : "0,100,1000")) {
+    delays.push_back(static_cast<uint>(std::strtoul(value.c_str(), nullptr, 10)));
+  }
+
+  const auto chain = split((plugins_arg != nullptr) ? plugins_arg : default_chain);
+  const auto alternative_chain = split((alternative_arg != nullptr) ? alternative_arg : default_alternative_chain);
+
+  std::filesystem::create_directories(config_dir);
+
+  PipeManager pm(PipeManager::Backend::in_process);
+
+  pm.lock();
+
+  auto* output_device = create_sink(pm, output_device_name);
+
+  pm.sync_wait_unlock();
+
+  if (!wait_for_nodes(pm, output_device_name, 1U)) {
+    return EXIT_FAILURE;
+  }
+
+  auto* settings = g_settings_new(tags::schema::id_output);
+
+  g_settings_set_boolean(settings, "use-default-output-device", 0);
+  g_settings_set_string(settings, "output-device", output_device_name);
+
+  PresetsManager presets_manager;
+
+  // The two presets are saved with the default parameters of their plugins.
+
+  g_settings_set_strv(settings, "plugins", util::make_gchar_pointer_vector(alternative_chain).data());
+
+  presets_manager.save_preset_file(PresetType::output, "benchmark_b");
+
+  g_settings_set_strv(settings, "plugins", util::make_gchar_pointer_vector(chain).data());
+
+  presets_manager.save_preset_file(PresetType::output, "benchmark_a");
+
+  auto soe = std::make_unique<StreamOutputEffects>(&pm);
+
+  iterate_main_context();
+
+  nlohmann::json results = nlohmann::json::array();
+
+  for (const auto& delay : delays) {
+    pm.round_trip_delay_us = delay;
+
+    results.push_back(to_json("connect_filters", delay,
+                              measure(pm, iterations, [&](const int& /*n*/) { soe->set_bypass(false); })));
+
+    results.push_back(to_json("preset_switch", delay, measure(pm, iterations, [&](const int& n) {
+                                presets_manager.load_preset_file(PresetType::output,
+                                                                 (n % 2 == 0) ? "benchmark_b" : "benchmark_a");
+
+                                iterate_main_context();
+                              })));
+
+    // Leaving the main chain in place, like it is when a device appears while Easy Effects is running.
+
+    presets_manager.load_preset_file(PresetType::output, "benchmark_a");
+
+    results.push_back(to_json("hotplug_storm", delay, measure(pm, iterations, [&](const int& /*n*/) {
+                                std::vector<pw_proxy*> sinks;
+
+                                pm.lock();
+
+                                for (int m = 0; m < storm_size; m++) {
+                                  sinks.push_back(create_sink(pm, hotplug_name_prefix + util::to_string(m)));
+                                }
+
+                                pm.sync_wait_unlock();
+
+                                wait_for_nodes(pm, hotplug_name_prefix, static_cast<size_t>(storm_size));
+
+                                pm.lock();
+
+                                for (auto* proxy : sinks) {
+                                  pw_proxy_destroy(proxy);
+                                }
+
+                                pm.sync_wait_unlock();
+
+                                wait_for_nodes(pm, hotplug_name_prefix, 0U);
+                              })));
+
+    util::info(log_tag + "round trip delay of " + util::to_string(delay) + " us done");
+  }
+
+  pm.round_trip_delay_us = 0U;
+
+  soe.reset();
+
+  pm.lock();
+
+  pw_proxy_destroy(output_device);
+
+  pm.sync_wait_unlock();
+
+  g_object_unref(settings);
+
+  std::filesystem::remove_all(config_dir);
+
+  const nlohmann::json report = {{"version", VERSION},
+                                 {"library_version", pm.library_version},
+                                 {"storm_size", storm_size},
+                                 {"plugins", chain},
+                                 {"alternative_plugins", alternative_chain},
+                                 {"results", results}};
+
+  if (output_path != nullptr) {
+    std::ofstream(output_path) << report.dump(2) << std::endl;
+  } else {
+    std::cout << report.dump(2) << std::endl;
+  }
+
+  g_free(delays_arg);
+  g_free(output_path);
+  g_free(plugins_arg);
+  g_free(alternative_arg);
+
+  return EXIT_SUCCESS;
+}
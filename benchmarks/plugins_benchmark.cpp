@@ -0,0 +1,446 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+  Measures the process() path of every plugin outside PipeWire. Each plugin is driven through
+  PluginBase::process_offline() with util/test.wav and synthetic signals at every combination of quantum and rate.
+
+  The results are written as JSON. ns_per_sample is the average processing time divided by the number of samples in
+  the block counting both channels, real_time_factor is the processing time divided by the duration of the audio and
+  allocations_per_block counts the calls to operator new made while the plugin was processing. Every run starts with
+  PluginBase::prepare_offline(), which is not measured.
+
+  Plugins with one of the paired_keys below are measured with that key off and on, one run after the other, and
+  latency_seconds reports the delay each mode added. The runs with parallel-channels on also report the time the
+  calling thread waited at the barrier of the channel worker, per block and as a fraction of the processing time.
+*/
+
+#include <glib.h>
+#include <sndfile.hh>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <nlohmann/json.hpp>
+#include <numbers>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "config.h"
+#include "effects_base.hpp"
+#include "resampler.hpp"
+#include "tags_app.hpp"
+#include "tags_plugin_name.hpp"
+#include "tags_schema.hpp"
+#include "util.hpp"
+
+namespace {
+
+std::atomic<uint64_t> n_allocations = 0U;
+
+constexpr auto quanta = std::to_array<size_t>({64U, 128U, 256U, 512U, 1024U, 2048U, 4096U, 8192U});
+
+constexpr auto rates = std::to_array<uint>({44100U, 48000U, 96000U});
+
+const std::string log_tag = "benchmark: ";
+
+// the analyzers are not in the plugin list because they are always at the end of the pipeline
+
+constexpr auto spectrum_name = "spectrum";
+
+constexpr auto output_level_name = "output_level";
+
+// Boolean settings whose cost is compared by running the plugins that have them with the key off and on
+constexpr auto paired_keys = std::to_array<const char*>({"parallel-channels", "low-latency"});
+
+struct Signal {
+  std::string name;
+
+  std::vector<float> left, right;
+};
+
+auto read_wav(const std::string& path, const uint& rate) -> Signal {
+  SndfileHandle file(path);
+
+  if (file.error() != SF_ERR_NO_ERROR || file.channels() <= 0 || file.frames() == 0) {
+    util::warning(log_tag + "could not read " + path);
+
+    return {};
+  }
+
+  const auto n_channels = static_cast<size_t>(file.channels());
+
+  std::vector<float> buffer(static_cast<size_t>(file.frames()) * n_channels);
+
+  file.readf(buffer.data(), file.frames());
+
+  Signal signal{.name = "test.wav"};
+
+  for (size_t n = 0U; n < buffer.size(); n += n_channels) {
+    signal.left.push_back(buffer[n]);
+    signal.right.push_back(buffer[n + ((n_channels > 1U) ? 1U : 0U)]);
+  }
+
+  if (static_cast<uint>(file.samplerate()) != rate) {
+    auto resampler = Resampler(file.samplerate(), static_cast<int>(rate), 2);
+
+    resampler.process(signal.left, signal.right, true);
+
+    signal.left = resampler.get_output_left();
+    signal.right = resampler.get_output_right();
+  }
+
+  return signal;
+}
+
+auto make_signals(const std::string& wav_path, const uint& rate, const double& seconds) -> std::vector<Signal> {
+  const auto n_frames = std::max(static_cast<size_t>(seconds * rate), static_cast<size_t>(1U));
+
+  std::vector<Signal> signals;
+
+  if (!wav_path.empty()) {
+    if (auto signal = read_wav(wav_path, rate); !signal.left.empty()) {
+      signals.push_back(signal);
+    }
+  }
+
+  Signal sine{.name = "sine", .left = std::vector<float>(n_frames), .right = std::vector<float>(n_frames)};
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    sine.left[n] = 0.5F * static_cast<float>(std::sin(2.0 * std::numbers::pi * 1000.0 * n / rate));
+    sine.right[n] = sine.left[n];
+  }
+
+  signals.push_back(sine);
+
+  Signal noise{.name = "noise", .left = std::vector<float>(n_frames), .right = std::vector<float>(n_frames)};
+
+  std::mt19937 generator(1234U);
+
+  std::uniform_real_distribution<float> distribution(-0.5F, 0.5F);
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    noise.left[n] = distribution(generator);
+    noise.right[n] = distribution(generator);
+  }
+
+  signals.push_back(noise);
+
+  // silence exercises the denormal handling and the silence gates of the plugins that have them
+
+  signals.push_back({.name = "silence", .left = std::vector<float>(n_frames), .right = std::vector<float>(n_frames)});
+
+  return signals;
+}
+
+auto write_impulse_response(const std::filesystem::path& path) -> bool {
+  // Half a second of exponentially decaying noise. Long enough to exercise the partitioned convolution.
+
+  constexpr int ir_rate = 48000;
+
+  const auto n_frames = static_cast<size_t>(ir_rate / 2);
+
+  std::vector<float> buffer(2U * n_frames);
+
+  std::mt19937 generator(4321U);
+
+  std::uniform_real_distribution<float> distribution(-1.0F, 1.0F);
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    const auto envelope = std::exp(-8.0F * static_cast<float>(n) / static_cast<float>(n_frames));
+
+    buffer[2U * n] = envelope * distribution(generator);
+    buffer[2U * n + 1U] = envelope * distribution(generator);
+  }
+
+  SndfileHandle file(path.string(), SFM_WRITE, SF_FORMAT_WAV | SF_FORMAT_FLOAT, 2, ir_rate);
+
+  return file.writef(buffer.data(), static_cast<sf_count_t>(n_frames)) == static_cast<sf_count_t>(n_frames);
+}
+
+auto create_plugin(const std::string& name) -> std::shared_ptr<PluginBase> {
+  using namespace std::string_literals;
+
+  const std::string base_path = tags::app::path_stream_outputs;
+
+  if (name == spectrum_name) {
+    return std::make_shared<Spectrum>(log_tag, tags::schema::spectrum::id, tags::app::path + "/spectrum/"s, nullptr);
+  }
+
+  if (name == output_level_name) {
+    return std::make_shared<OutputLevel>(log_tag, tags::schema::output_level::id, base_path + "outputlevel/", nullptr);
+  }
+
+  return EffectsBase::create_plugin(name + "#0", log_tag, base_path, nullptr);
+}
+
+auto run(PluginBase& plugin, const Signal& signal, const uint& rate, const size_t& quantum, const double& seconds)
+    -> nlohmann::json {
+  std::vector<float> left_in(quantum), right_in(quantum), left_out(quantum), right_out(quantum);
+
+  std::span<float> l_in = left_in;
+  std::span<float> r_in = right_in;
+  std::span<float> l_out = left_out;
+  std::span<float> r_out = right_out;
+
+  size_t position = 0U;
+
+  const auto next_block = [&]() {
+    for (size_t n = 0U; n < quantum; n++, position = (position + 1U) % signal.left.size()) {
+      left_in[n] = signal.left[position];
+      right_in[n] = signal.right[position];
+    }
+  };
+
+  plugin.prepare_offline(rate, static_cast<uint>(quantum));
+
+  const auto n_blocks = std::max(static_cast<size_t>(seconds * rate) / quantum, static_cast<size_t>(1U));
+
+  uint64_t total_ns = 0U;
+  uint64_t worst_ns = 0U;
+  uint64_t allocations = 0U;
+
+  const auto worker_before = plugin.get_channel_worker_stats();
+
+  for (size_t n = 0U; n < n_blocks; n++) {
+    next_block();
+
+    const auto allocations_before = n_allocations.load(std::memory_order_relaxed);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    plugin.process_offline(l_in, r_in, l_out, r_out, rate);
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    allocations += n_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+    const auto block_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+    total_ns += block_ns;
+
+    worst_ns = std::max(worst_ns, block_ns);
+  }
+
+  const auto n_samples = static_cast<double>(2U * quantum * n_blocks);
+
+  const auto audio_ns = 1e9 * static_cast<double>(quantum * n_blocks) / static_cast<double>(rate);
+
+  const auto n_blocks_d = static_cast<double>(n_blocks);
+
+  nlohmann::json result = {{"plugin", plugin.name},
+                            {"signal", signal.name},
+                            {"rate", rate},
+                            {"quantum", quantum},
+                            {"blocks", n_blocks},
+                            {"ns_per_sample", static_cast<double>(total_ns) / n_samples},
+                            {"real_time_factor", static_cast<double>(total_ns) / audio_ns},
+                            {"worst_block_ns", worst_ns},
+                            {"latency_seconds", plugin.get_latency_seconds()},
+                            {"allocations_per_block", static_cast<double>(allocations) / n_blocks_d}};
+
+  if (const auto worker_after = plugin.get_channel_worker_stats(); worker_after.n_runs > worker_before.n_runs) {
+    const auto wait_ns = static_cast<double>(worker_after.wait_ns - worker_before.wait_ns);
+
+    result["barrier_wait_ns_per_block"] = wait_ns / n_blocks_d;
+    result["barrier_wait_fraction"] = wait_ns / static_cast<double>(std::max(total_ns, static_cast<uint64_t>(1U)));
+    result["channel_worker_runs"] = worker_after.n_runs - worker_before.n_runs;
+    result["channel_worker_inline_runs"] = worker_after.n_inline_runs - worker_before.n_inline_runs;
+  }
+
+  return result;
+}
+
+void set_key(PluginBase& plugin, const char* key, const bool& state) {
+  g_settings_set_boolean(plugin.get_settings(), key, static_cast<gboolean>(state));
+
+  // the plugins react to the change in their changed signal handlers and in idle callbacks
+
+  while (g_main_context_iteration(nullptr, 0) != 0) {
+  }
+}
+
+}  // namespace
+
+// Every allocation made with new is counted. Allocations made by the C libraries through malloc are not.
+
+auto operator new(std::size_t size) -> void* {
+  n_allocations.fetch_add(1U, std::memory_order_relaxed);
+
+  if (auto* p = std::malloc(std::max(size, static_cast<std::size_t>(1U))); p != nullptr) {
+    return p;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t size) noexcept {
+  std::free(p);
+}
+
+auto main(int argc, char* argv[]) -> int {
+  using namespace std::string_literals;
+
+  // The benchmark writes to the settings of the convolver. They must never reach the settings of the user.
+
+  g_setenv("GSETTINGS_BACKEND", "memory", 1);
+
+  double seconds = 1.0;
+  gchar* wav_path = nullptr;
+  gchar* output_path = nullptr;
+  gchar* plugins_arg = nullptr;
+  gboolean meters = 0;
+
+  std::array<GOptionEntry, 6U> entries{
+      {{"seconds", 's', 0, G_OPTION_ARG_DOUBLE, &seconds, "Audio processed in each run. The default is 1 s", "S"},
+       {"wav", 'w', 0, G_OPTION_ARG_FILENAME, &wav_path, "Audio file used as the test signal", "FILE"},
+       {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output_path, "Write the results to FILE instead of stdout", "FILE"},
+       {"plugins", 'p', 0, G_OPTION_ARG_STRING, &plugins_arg, "Comma separated list of plugins. The default is all",
+        "LIST"},
+       {"meters", 'm', 0, G_OPTION_ARG_NONE, &meters, "Measure the levels like when the meters are visible", nullptr},
+       {nullptr}}};
+
+  auto* context = g_option_context_new("- benchmark the Easy Effects plugins");
+
+  g_option_context_add_main_entries(context, entries.data(), nullptr);
+
+  if (GError* error = nullptr; g_option_context_parse(context, &argc, &argv, &error) == 0) {
+    std::cerr << error->message << std::endl;
+
+    g_error_free(error);
+    g_option_context_free(context);
+
+    return EXIT_FAILURE;
+  }
+
+  g_option_context_free(context);
+
+  std::vector<std::string> plugin_names(tags::plugin_name::list.begin(), tags::plugin_name::list.end());
+
+  plugin_names.emplace_back(spectrum_name);
+  plugin_names.emplace_back(output_level_name);
+
+  if (plugins_arg != nullptr) {
+    plugin_names.clear();
+
+    std::istringstream stream(plugins_arg);
+
+    for (std::string name; std::getline(stream, name, ',');) {
+      plugin_names.push_back(name);
+    }
+  }
+
+  // Without an impulse response the convolver would only copy its input.
+
+  const auto ir_path = std::filesystem::temp_directory_path() / "easyeffects-benchmark.irs";
+
+  if (write_impulse_response(ir_path)) {
+    auto* settings = g_settings_new_with_path(tags::schema::convolver::id,
+                                              (tags::app::path_stream_outputs + "convolver/0/"s).c_str());
+
+    g_settings_set_string(settings, "kernel-path", ir_path.c_str());
+
+    g_object_unref(settings);
+  }
+
+  nlohmann::json results = nlohmann::json::array();
+
+  for (const auto& name : plugin_names) {
+    auto plugin = create_plugin(name);
+
+    if (plugin == nullptr) {
+      util::warning(log_tag + "unknown plugin: " + name);
+
+      continue;
+    }
+
+    if (!plugin->package_installed) {
+      results.push_back({{"plugin", name}, {"installed", false}});
+
+      continue;
+    }
+
+    plugin->set_post_messages(meters != 0);
+
+    const char* paired_key = nullptr;
+
+    for (const auto* key : paired_keys) {
+      if (util::gsettings_has_key(plugin->get_settings(), key)) {
+        paired_key = key;
+      }
+    }
+
+    for (const auto& rate : rates) {
+      const auto signals = make_signals((wav_path != nullptr) ? wav_path : "", rate, seconds);
+
+      for (const auto& quantum : quanta) {
+        for (const auto& signal : signals) {
+          if (paired_key == nullptr) {
+            results.push_back(run(*plugin, signal, rate, quantum, seconds));
+
+            continue;
+          }
+
+          for (const auto state : {false, true}) {
+            set_key(*plugin, paired_key, state);
+
+            auto result = run(*plugin, signal, rate, quantum, seconds);
+
+            result["key"] = paired_key;
+            result["key_state"] = state;
+
+            results.push_back(result);
+          }
+        }
+      }
+    }
+
+    util::info(log_tag + name + " done");
+  }
+
+  std::filesystem::remove(ir_path);
+
+  const nlohmann::json report = {
+      {"version", VERSION}, {"seconds", seconds}, {"meters", meters != 0}, {"results", results}};
+
+  if (output_path != nullptr) {
+    std::ofstream(output_path) << report.dump(2) << std::endl;
+  } else {
+    std::cout << report.dump(2) << std::endl;
+  }
+
+  g_free(wav_path);
+  g_free(output_path);
+  g_free(plugins_arg);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+
+/*
+  Non realtime thread shared by the analyzers (spectrum, level meter, ...). The realtime side of a plugin only copies
+  samples into a lock free tap and calls wake(). The expensive computations are done by the jobs registered here.
+
+  The thread is started when the first job is added and stopped when the last one is removed. While nothing wakes it
+  up it just sleeps on a semaphore.
+*/
+
+class AnalysisThread {
+ public:
+  AnalysisThread(const AnalysisThread&) = delete;
+  auto operator=(const AnalysisThread&) -> AnalysisThread& = delete;
+  AnalysisThread(const AnalysisThread&&) = delete;
+  auto operator=(const AnalysisThread&&) -> AnalysisThread& = delete;
+  ~AnalysisThread();
+
+  static auto get() -> AnalysisThread&;
+
+  auto add_job(std::function<void()> job) -> uint;
+
+  // After remove_job returns the job is not running and it will not be called again.
+  void remove_job(const uint& id);
+
+  // Can be called from the realtime thread. Wake ups that happen while the jobs are running are merged.
+  void wake();
+
+ private:
+  AnalysisThread() = default;
+
+  std::atomic<bool> running = false;
+
+  uint next_id = 1U;
+
+  std::mutex control_mutex;  // serializes start() and stop()
+
+  std::mutex jobs_mutex;
+
+  std::map<uint, std::function<void()>> jobs;
+
+  std::counting_semaphore<> semaphore{0};
+
+  std::thread thread;
+
+  void start();
+
+  void stop();
+
+  void loop();
+};
@@ -0,0 +1,52 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <span>
+#include "ring_buffer.hpp"
+
+/*
+  In process analysis point. When attached to a plugin the plugin copies its input or output block to the ring buffers
+  from its own process callback. No PipeWire node or link is needed to look at the audio between two plugins.
+
+  The owner of the tap is the only reader. While external is false the owner feeds the tap with its own input.
+*/
+
+class AnalyzerTap {
+ public:
+  enum class Position { input, output };
+
+  explicit AnalyzerTap(const size_t& capacity) {
+    left.resize(capacity);
+    right.resize(capacity);
+  }
+
+  std::atomic<Position> position = Position::output;
+
+  std::atomic<bool> external = false;
+
+  RingBuffer<float> left, right;
+
+  void write(const std::span<const float>& left_data, const std::span<const float>& right_data) {
+    left.push(left_data);
+    right.push(right_data);
+  }
+};
@@ -22,6 +22,7 @@
 #include <adwaita.h>
 #include <glib/gi18n.h>
 #include <string>
+#include "metrics_server.hpp"
 #include "pipe_manager.hpp"
 #include "presets_manager.hpp"
 #include "stream_input_effects.hpp"
@@ -55,6 +56,7 @@ struct _Application {
   StreamOutputEffects* soe;
   StreamInputEffects* sie;
   PresetsManager* presets_manager;
+  MetricsServer* metrics;
 
   Data* data;
 };
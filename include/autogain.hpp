@@ -19,7 +19,7 @@
 
 #pragma once
 
-#include <ebur128.h>
+#include "loudness_meter.hpp"
 #include "plugin_base.hpp"
 
 class AutoGain : public PluginBase {
@@ -53,6 +53,8 @@ class AutoGain : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  void wait_setup() override;
+
   sigc::signal<void(const double,  // loudness
                     const double,  // gain
                     const double,  // momentary
@@ -70,7 +72,7 @@ class AutoGain : public PluginBase {
   double loudness = 0.0;
 
  private:
-  bool ebur128_ready = false;
+  bool meter_ready = false;
 
   uint old_rate = 0U;
 
@@ -80,13 +82,11 @@ class AutoGain : public PluginBase {
 
   Reference reference = Reference::geometric_mean_msi;
 
-  std::vector<float> data;
-
-  ebur128_state* ebur_state = nullptr;
+  LoudnessMeter meter;
 
   std::vector<std::thread> mythreads;
 
-  auto init_ebur128() -> bool;
+  auto init_meter() -> bool;
 
   static auto parse_reference_key(const std::string& key) -> Reference;
 
@@ -0,0 +1,172 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <semaphore>
+#include <thread>
+#include <type_traits>
+
+/*
+  Runs the right channel of a plugin on a helper thread while the calling thread takes care of the left one. Both
+  tasks have to be independent. run() only returns after both are finished, so the tasks may capture references to
+  the caller stack.
+
+  The helper gets the scheduling policy and priority of the first thread that calls run(). Until then, and for good
+  if it could not get them, both channels are run by the caller. If the helper has not picked up the right channel
+  when the caller is done with the left one, the caller runs it too.
+*/
+
+class ChannelWorker {
+ public:
+  ChannelWorker() = default;
+  ChannelWorker(const ChannelWorker&) = delete;
+  auto operator=(const ChannelWorker&) -> ChannelWorker& = delete;
+  ChannelWorker(const ChannelWorker&&) = delete;
+  auto operator=(const ChannelWorker&&) -> ChannelWorker& = delete;
+  ~ChannelWorker();
+
+  struct Stats {
+    uint64_t n_runs = 0U;
+
+    uint64_t n_inline_runs = 0U;  // runs in which the caller had to take the right channel back
+
+    uint64_t total_ns = 0U;  // time spent inside run()
+
+    uint64_t wait_ns = 0U;  // time the caller waited at the barrier after finishing its own channel
+  };
+
+  void start();
+
+  void stop();
+
+  [[nodiscard]] auto is_running() const -> bool;
+
+  [[nodiscard]] auto get_stats() const -> Stats;
+
+  void reset_stats();
+
+  template <typename F1, typename F2>
+  void run(F1&& left_task, F2&& right_task) {
+    if (!running || helper_priority.load(std::memory_order_acquire) != HelperPriority::ready) {
+      if (running && helper_priority.load(std::memory_order_acquire) == HelperPriority::unknown) {
+        request_caller_priority();
+      }
+
+      left_task();
+      right_task();
+
+      return;
+    }
+
+    using T = std::remove_reference_t<F2>;
+
+    task_context = static_cast<void*>(&right_task);
+    task_function = [](void* context) { (*static_cast<T*>(context))(); };
+
+    task_state.store(TaskState::pending, std::memory_order_release);
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    start_semaphore.release();
+
+    left_task();
+
+    const auto t1 = std::chrono::steady_clock::now();
+
+    /*
+      The right channel takes about as long as the left one, so spinning is cheaper than sleeping here. But the wait
+      is bounded. If the helper did not claim the task in time we take it back and run it ourselves.
+    */
+
+    for (uint n = 0U; n < max_spins && task_state.load(std::memory_order_acquire) == TaskState::pending; n++) {
+      std::this_thread::yield();
+    }
+
+    auto expected = TaskState::pending;
+
+    if (task_state.compare_exchange_strong(expected, TaskState::idle, std::memory_order_acquire)) {
+      right_task();
+
+      n_inline_runs.fetch_add(1U, std::memory_order_relaxed);
+    } else {
+      // The helper has the same priority as we do, so it is running on another core and will finish soon.
+
+      while (task_state.load(std::memory_order_acquire) != TaskState::finished) {
+        std::this_thread::yield();
+      }
+
+      task_state.store(TaskState::idle, std::memory_order_relaxed);
+    }
+
+    const auto t2 = std::chrono::steady_clock::now();
+
+    n_runs.fetch_add(1U, std::memory_order_relaxed);
+
+    total_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t0).count(),
+                       std::memory_order_relaxed);
+
+    wait_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count(),
+                      std::memory_order_relaxed);
+  }
+
+ private:
+  enum class TaskState { idle, pending, claimed, finished };
+
+  enum class HelperPriority { unknown, requested, ready, failed };
+
+  static constexpr uint max_spins = 256U;
+
+  std::atomic<bool> running = false;
+
+  std::atomic<bool> stopping = false;
+
+  std::atomic<TaskState> task_state = TaskState::idle;
+
+  std::atomic<HelperPriority> helper_priority = HelperPriority::unknown;
+
+  // scheduling of the thread that calls run(). Written before helper_priority becomes requested.
+
+  int caller_policy = SCHED_OTHER;
+
+  sched_param caller_param{};
+
+  std::atomic<uint64_t> n_runs = 0U, n_inline_runs = 0U, total_ns = 0U, wait_ns = 0U;
+
+  void* task_context = nullptr;
+
+  void (*task_function)(void*) = nullptr;
+
+  // Tokens left by runs whose right channel was taken back only cause an empty wake up of the helper.
+
+  std::counting_semaphore<> start_semaphore{0};
+
+  std::thread thread;
+
+  void request_caller_priority();
+
+  void apply_caller_priority();
+
+  void loop();
+};
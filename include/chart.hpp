@@ -43,7 +43,7 @@ G_DECLARE_FINAL_TYPE(Chart, chart, EE, CHART, GtkWidget)
 
 G_END_DECLS
 
-enum class ChartType { bar, line, dots };
+enum class ChartType { bar, line, dots, waterfall };
 
 enum class ChartScale { linear, logarithmic };
 
@@ -79,6 +79,9 @@ void set_y_unit(Chart* self, const std::string& value);
 
 void set_margin(Chart* self, const float& v);
 
+// Each row of the waterfall shows the peaks of frames_per_row consecutive frames given to set_y_data.
+void set_waterfall_rows(Chart* self, const uint& n_rows, const uint& frames_per_row = 1U);
+
 auto get_is_visible(Chart* self) -> bool;
 
 void set_dynamic_y_scale(Chart* self, const bool& v);
@@ -22,6 +22,8 @@
 #include <zita-convolver.h>
 #include <algorithm>
 #include <deque>
+#include <future>
+#include <optional>
 #include <sndfile.hh>
 #include "plugin_base.hpp"
 #include "resampler.hpp"
@@ -70,6 +72,20 @@ class Convolver : public PluginBase {
 
   std::vector<std::thread> mythreads;
 
+  struct KernelFile {
+    int rate = 0;
+
+    std::vector<float> left, right;
+  };
+
+  // The kernel file is decoded in the background while the rest of the pipeline is being created.
+
+  std::string prefetched_kernel_path;
+
+  std::future<std::optional<KernelFile>> kernel_prefetch;
+
+  [[nodiscard]] auto load_kernel_file(const std::string& path) const -> std::optional<KernelFile>;
+
   void read_kernel_file();
 
   void apply_kernel_autogain();
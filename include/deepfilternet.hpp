@@ -22,6 +22,8 @@
 #include "ladspa_wrapper.hpp"
 #include "plugin_base.hpp"
 #include "resampler.hpp"
+#include "ring_buffer.hpp"
+#include "silence_gate.hpp"
 
 class DeepFilterNet : public PluginBase {
  public:
@@ -48,11 +50,25 @@ class DeepFilterNet : public PluginBase {
   std::unique_ptr<ladspa::LadspaWrapper> ladspa_wrapper;
 
   bool resample = false;
-  bool resampler_ready = true;
+  bool buffers_ready = false;
+  bool enable_gate = false;
+  bool notify_latency = false;
 
-  std::unique_ptr<Resampler> resampler_inL, resampler_outL;
-  std::unique_ptr<Resampler> resampler_inR, resampler_outR;
+  static constexpr uint df_rate = 48000U;
 
-  std::vector<float> resampled_outL, resampled_outR;
-  std::vector<float> carryover_l, carryover_r;
+  // DeepFilterNet works with 10 ms hops. Feeding whole hops avoids extra buffering inside the LADSPA plugin.
+  static constexpr uint hop_size = 480U;
+
+  // Algorithmic delay of the model itself (lookahead).
+  static constexpr float model_latency = 0.02F;
+
+  uint latency_n_frames = 0U;
+
+  SilenceGate gate;
+
+  std::unique_ptr<Resampler> resampler_in, resampler_out;
+
+  RingBuffer<float> fifo_in_L, fifo_in_R, fifo_out_L, fifo_out_R;
+
+  std::vector<float> frame_in_L, frame_in_R, frame_out_L, frame_out_R;
 };
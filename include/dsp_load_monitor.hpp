@@ -0,0 +1,95 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+  Keeps a histogram of how much of the quantum period a node needs to process a cycle. record() is called from the
+  realtime thread and only touches atomics. get_stats() can be called from any thread.
+
+  A monitor can also sum the time of all nodes of an effects chain. In this case accumulate() is called by every node
+  with the graph cycle it is processing. When a cycle goes over the quantum the node that took the largest part of it
+  is blamed for the overrun.
+*/
+
+class DspLoadMonitor {
+ public:
+  DspLoadMonitor();
+
+  struct Stats {
+    uint64_t n_cycles = 0U;
+
+    uint64_t n_overruns = 0U;  // cycles that took longer than the quantum period
+
+    uint64_t n_blamed = 0U;  // chain overruns where this node was the largest contributor
+
+    uint64_t busy_ns = 0U;  // total processing time
+
+    float load = 0.0F;  // average fraction of the quantum period
+
+    float p99 = 0.0F;
+
+    float worst = 0.0F;
+  };
+
+  void record(const uint64_t& busy_ns, const uint64_t& period_ns);
+
+  void accumulate(const uint64_t& cycle, const uint64_t& busy_ns, const uint64_t& period_ns, DspLoadMonitor& node);
+
+  // The values are cleared by the realtime thread the next time it records something.
+  void reset();
+
+  [[nodiscard]] auto get_stats() const -> Stats;
+
+ private:
+  static constexpr uint n_bins = 200U;  // 1 % of the quantum each. The last one also holds everything above 2x.
+
+  static std::atomic<uint> next_id;
+
+  const uint id;
+
+  std::array<std::atomic<uint32_t>, n_bins> histogram{};
+
+  std::atomic<uint64_t> n_cycles = 0U, n_overruns = 0U, n_blamed = 0U;
+
+  std::atomic<uint64_t> total_busy_ns = 0U, total_period_ns = 0U;
+
+  std::atomic<float> worst = 0.0F;
+
+  std::atomic<bool> reset_requested = false;
+
+  // state of the chain cycle being summed
+
+  uint64_t cycle_position = 0U, cycle_busy_ns = 0U, cycle_period_ns = 0U, cycle_largest_ns = 0U;
+
+  uint cycle_largest_id = 0U;
+
+  std::atomic<uint64_t> overrun_serial = 0U;
+
+  std::atomic<uint> overrun_culprit = 0U;
+
+  uint64_t seen_overrun_serial = 0U;  // used by the node monitors
+
+  void clear();
+};
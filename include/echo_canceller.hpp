@@ -75,4 +75,11 @@ class EchoCanceller : public PluginBase {
   void free_speex();
 
   void init_speex();
+
+  void process_channel(const std::span<float>& in,
+                       std::span<float>& out,
+                       std::vector<spx_int16_t>& data,
+                       std::vector<spx_int16_t>& filtered,
+                       SpeexEchoState* echo_state,
+                       SpeexPreprocessState* state);
 };
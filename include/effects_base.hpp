@@ -97,8 +97,33 @@ class EffectsBase {
 
   auto get_pipeline_latency() -> float;
 
+  // The plugins of the pipeline in their order, together with their instance names
+  auto get_pipeline_plugins() -> std::vector<std::pair<std::string, std::shared_ptr<PluginBase>>>;
+
   void reset_settings();
 
+  // Moves the spectrum and the output level meter to the input or output of a plugin. An empty name moves them back to
+  // the end of the pipeline.
+  void set_analyzer_tap(const std::string& plugin_name, const AnalyzerTap::Position& position);
+
+  [[nodiscard]] auto get_analyzer_tap_plugin() const -> std::string;
+
+  // One line for the whole chain followed by one line for each plugin in the pipeline order.
+  auto get_dsp_load_report() -> std::string;
+
+  void reset_dsp_load();
+
+  /*
+    Creates the plugin called name with its settings under schema_base_path. A null pm gives a plugin that is not
+    part of the PipeWire graph and has to be driven by PluginBase::process_offline().
+  */
+  static auto create_plugin(const std::string& name,
+                            const std::string& log_tag,
+                            const std::string& schema_base_path,
+                            PipeManager* pm) -> std::shared_ptr<PluginBase>;
+
+  DspLoadMonitor dsp_load;  // sum of all the nodes of this chain in each graph cycle
+
   sigc::signal<void(const float&)> pipeline_latency;
 
   template <typename T>
@@ -113,6 +138,8 @@ class EffectsBase {
 
   std::map<std::string, std::shared_ptr<PluginBase>> plugins;
 
+  std::string analyzer_tap_plugin;
+
   std::vector<pw_proxy*> list_proxies, list_proxies_listen_mic;
 
   std::vector<sigc::connection> connections;
@@ -121,6 +148,9 @@ class EffectsBase {
 
   void create_filters_if_necessary();
 
+  // Starts the connection of the listed filters that are not in the graph yet. See PluginBase::connect_to_pw().
+  void request_filters_connection(const std::vector<std::string>& list);
+
   void remove_unused_filters();
 
   void activate_filters();
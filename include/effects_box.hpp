@@ -20,7 +20,6 @@
 #pragma once
 
 #include <adwaita.h>
-#include <gsl/gsl_spline.h>
 #include "application.hpp"
 #include "apps_box.hpp"
 #include "blocklist_menu.hpp"
@@ -28,6 +27,7 @@
 #include "effects_base.hpp"
 #include "pipeline_type.hpp"
 #include "plugins_box.hpp"
+#include "spectrum_mapping.hpp"
 #include "tags_resources.hpp"
 
 namespace ui::effects_box {
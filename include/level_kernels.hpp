@@ -0,0 +1,126 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+
+/*
+  Gain and level measurement in a single pass over the buffer. The loops work on blocks of a fixed number of lanes
+  with one accumulator per lane. This is what lets the compiler turn them into vector instructions at -O2 without
+  reordering the floating point sums. The few samples left at the end are handled one by one.
+*/
+
+namespace level_kernels {
+
+inline constexpr size_t lanes = 8U;
+
+struct Levels {
+  float peak = 0.0F;  // largest absolute sample value
+
+  float sum_of_squares = 0.0F;
+};
+
+inline void apply_gain(const std::span<float>& data, const float& gain) {
+  const auto g = gain;  // a reference to the gain could point into the buffer
+
+  auto* ptr = data.data();
+
+  const auto n = data.size();
+  const auto n_vector = n - n % lanes;
+
+  for (size_t i = 0U; i < n_vector; i += lanes) {
+    for (size_t k = 0U; k < lanes; k++) {
+      ptr[i + k] *= g;
+    }
+  }
+
+  for (size_t i = n_vector; i < n; i++) {
+    ptr[i] *= g;
+  }
+}
+
+inline void apply_gain(const std::span<float>& left, const std::span<float>& right, const float& gain) {
+  apply_gain(left, gain);
+  apply_gain(right, gain);
+}
+
+// Multiplies the buffer by gain and measures the scaled samples. The buffer is not written when the gain is 1.
+inline auto apply_gain_and_measure(const std::span<float>& data, const float& gain) -> Levels {
+  const auto g = gain;
+
+  std::array<float, lanes> peak{}, sum{};
+
+  auto* ptr = data.data();
+
+  const auto n = data.size();
+  const auto n_vector = n - n % lanes;
+
+  if (g == 1.0F) {
+    for (size_t i = 0U; i < n_vector; i += lanes) {
+      for (size_t k = 0U; k < lanes; k++) {
+        const auto v = ptr[i + k];
+
+        peak[k] = std::max(peak[k], std::fabs(v));
+        sum[k] += v * v;
+      }
+    }
+  } else {
+    for (size_t i = 0U; i < n_vector; i += lanes) {
+      std::array<float, lanes> v{};
+
+      for (size_t k = 0U; k < lanes; k++) {
+        v[k] = ptr[i + k] * g;
+      }
+
+      for (size_t k = 0U; k < lanes; k++) {
+        ptr[i + k] = v[k];
+
+        peak[k] = std::max(peak[k], std::fabs(v[k]));
+        sum[k] += v[k] * v[k];
+      }
+    }
+  }
+
+  for (size_t i = n_vector; i < n; i++) {
+    const auto v = ptr[i] * g;
+
+    if (g != 1.0F) {
+      ptr[i] = v;
+    }
+
+    peak[0] = std::max(peak[0], std::fabs(v));
+    sum[0] += v * v;
+  }
+
+  Levels levels;
+
+  for (size_t k = 0U; k < lanes; k++) {
+    levels.peak = std::max(levels.peak, peak[k]);
+    levels.sum_of_squares += sum[k];
+  }
+
+  return levels;
+}
+
+}  // namespace level_kernels
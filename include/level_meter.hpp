@@ -19,8 +19,13 @@
 
 #pragma once
 
-#include <ebur128.h>
+#include <optional>
+#include "analysis_thread.hpp"
+#include "loudness_log.hpp"
+#include "loudness_meter.hpp"
 #include "plugin_base.hpp"
+#include "ring_buffer.hpp"
+#include "tags_schema.hpp"
 
 class LevelMeter : public PluginBase {
  public:
@@ -43,8 +48,22 @@ class LevelMeter : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  void wait_setup() override;
+
   void reset_history();
 
+  struct Loudness {
+    double momentary = 0.0;
+    double shortterm = 0.0;
+    double integrated = 0.0;
+    double range = 0.0;
+    double true_peak_L = 0.0;  // dBTP
+    double true_peak_R = 0.0;
+  };
+
+  // Empty while the meter is not analyzing, which happens when no window shows it and the log is disabled.
+  auto get_loudness() -> std::optional<Loudness>;
+
   sigc::signal<void(const double,  // momentary
                     const double,  // shortterm
                     const double,  // integrated
@@ -56,7 +75,7 @@ class LevelMeter : public PluginBase {
       results;  // range
 
  private:
-  bool ebur128_ready = false;
+  bool meter_ready = false;
 
   uint old_rate = 0U;
 
@@ -69,11 +88,37 @@ class LevelMeter : public PluginBase {
   double true_peak_L = 0.0;
   double true_peak_R = 0.0;
 
-  std::vector<float> data;
+  uint analysis_job_id = 0U;
+
+  static constexpr size_t tap_capacity = 32768U;
+
+  std::atomic<bool> frame_due = false;
+
+  std::atomic<bool> log_enabled = false;
+
+  std::filesystem::path log_directory;
+
+  RingBuffer<float> tap_L, tap_R;
 
-  ebur128_state* ebur_state = nullptr;
+  // the meters and the buffers below are used by the analysis thread
+
+  std::mutex analysis_mutex;
+
+  std::vector<float> chunk_L, chunk_R;
+
+  LoudnessMeter meter;
+
+  TruePeakDetector true_peak_detector_L, true_peak_detector_R;
+
+  float log_true_peak = 0.0F;  // largest true peak since the last log record
+
+  std::unique_ptr<LoudnessLog> loudness_log;
 
   std::vector<std::thread> mythreads;
 
-  auto init_ebur128() -> bool;
+  auto init_meter() -> bool;
+
+  void set_log_enabled(const bool& state);
+
+  void analyze();
 };
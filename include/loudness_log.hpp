@@ -0,0 +1,111 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "ring_buffer.hpp"
+
+/*
+  Append only log of the Level Meter results. There is one file per UTC day. After a 16 bytes header the file has
+  one 10 bytes record for every 100 ms of the day. The position of a record is given by its time, so the file can be
+  mapped in memory and queried without an index. A full day takes 8.6 MB and periods without data are left as holes.
+
+  push() only copies the record to a lock free queue. The files are written once per second by a thread owned by
+  this class.
+*/
+
+class LoudnessLog {
+ public:
+  explicit LoudnessLog(std::filesystem::path directory);
+  LoudnessLog(const LoudnessLog&) = delete;
+  auto operator=(const LoudnessLog&) -> LoudnessLog& = delete;
+  LoudnessLog(const LoudnessLog&&) = delete;
+  auto operator=(const LoudnessLog&&) -> LoudnessLog& = delete;
+  ~LoudnessLog();
+
+  struct Entry {
+    int64_t time_ms = 0;  // unix time
+
+    double momentary = 0.0;
+    double shortterm = 0.0;
+    double integrated = 0.0;
+    double range = 0.0;
+    double true_peak = 0.0;  // dB, largest of both channels
+  };
+
+  static constexpr uint record_interval_ms = 100U;
+
+  // Logs of all Level Meter instances are kept in subfolders of this directory.
+  static auto base_directory() -> std::filesystem::path;
+
+  // Safe to call from one thread at a time. Records are dropped if the writer falls more than a minute behind.
+  void push(const Entry& entry);
+
+  static auto read(const std::filesystem::path& directory, const int64_t& start_ms, const int64_t& end_ms)
+      -> std::vector<Entry>;
+
+  static void write_csv(const std::vector<Entry>& entries, std::ostream& stream);
+
+ private:
+  struct Record {
+    uint16_t momentary;   // 0.01 LU steps with an offset of 600 LU. 0 means that there is no data
+    uint16_t shortterm;   // same as above
+    uint16_t integrated;  // same as above
+    uint16_t range;       // 0.1 LU steps
+    int16_t true_peak;    // 0.1 dB steps. The smallest value means -inf
+  };
+
+  static_assert(sizeof(Record) == 10U);
+
+  std::filesystem::path directory;
+
+  RingBuffer<Entry> queue;
+
+  bool stop = false;
+
+  std::mutex mutex;
+
+  std::condition_variable cv;
+
+  int fd = -1;
+
+  int64_t file_day = -1;
+
+  std::thread writer;
+
+  void loop();
+
+  void write(const Entry& entry);
+
+  auto open_day(const int64_t& day) -> bool;
+
+  static auto encode(const Entry& entry) -> Record;
+
+  static auto decode(const Record& record, const int64_t& time_ms) -> Entry;
+
+  static auto file_name(const int64_t& day) -> std::string;
+};
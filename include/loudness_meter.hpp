@@ -0,0 +1,129 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <span>
+#include <vector>
+
+/*
+  Incremental EBU R128 loudness meter for stereo streams.
+
+  The K-weighted energy is accumulated in 100 ms blocks. Every finished block updates the momentary and short term
+  windows and adds one gating block to the integrated and loudness range histograms. Blocks older than the maximum
+  history are removed from the histograms as new ones arrive, so the per block cost does not depend on the history
+  length. Only the queries walk the histograms and they are meant to be called at the notification rate.
+*/
+
+class LoudnessMeter {
+ public:
+  void init(const uint& rate);
+
+  // 0 keeps the whole history
+  void set_max_history(const uint& seconds);
+
+  void reset();
+
+  // Returns the number of 100 ms blocks finished by this call.
+  auto add_frames(const std::span<const float>& left, const std::span<const float>& right) -> uint;
+
+  [[nodiscard]] auto momentary() const -> double;
+
+  [[nodiscard]] auto shortterm() const -> double;
+
+  [[nodiscard]] auto integrated() const -> double;
+
+  [[nodiscard]] auto relative_threshold() const -> double;
+
+  [[nodiscard]] auto loudness_range() const -> double;
+
+ private:
+  static constexpr uint n_momentary_blocks = 4U;  // 400 ms
+
+  static constexpr uint n_shortterm_blocks = 30U;  // 3 s
+
+  static constexpr double absolute_gate = -70.0;
+
+  static constexpr double histogram_step = 0.1;  // LU per bin
+
+  static constexpr uint n_bins = 1000U;
+
+  // Both channels are filtered together so the compiler can keep them in the two lanes of a vector register.
+
+  struct Biquad {
+    std::array<double, 3> b{};
+    std::array<double, 2> a{};
+
+    std::array<double, 2> s1{}, s2{};  // transposed direct form II state of each channel
+  };
+
+  struct Histogram {
+    std::array<uint, n_bins> count{};
+
+    std::array<double, n_bins> energy{};
+
+    uint n_blocks = 0U;
+
+    double total_energy = 0.0;
+
+    // circular list of the blocks in the history, used to remove the oldest one
+
+    std::vector<int> ring_bin;
+
+    std::vector<double> ring_energy;
+
+    uint ring_pos = 0U, ring_size = 0U;
+
+    void clear();
+
+    void resize(const uint& capacity);
+
+    void add(const double& block_energy);
+
+    [[nodiscard]] auto gate(const double& relative_lu) const -> int;
+  };
+
+  uint rate = 0U;
+
+  uint block_size = 0U;
+
+  uint block_fill = 0U;
+
+  double block_energy = 0.0;
+
+  uint n_finished_blocks = 0U;
+
+  std::array<Biquad, 2> filters;
+
+  std::array<double, n_shortterm_blocks> recent_blocks{};
+
+  uint recent_pos = 0U;
+
+  double momentary_energy = 0.0, shortterm_energy = 0.0;
+
+  Histogram integrated_histogram, range_histogram;
+
+  void finish_block();
+
+  static auto energy_to_loudness(const double& energy) -> double;
+
+  static auto loudness_to_bin(const double& loudness) -> int;
+};
@@ -32,6 +32,7 @@
 #include <lv2/parameters/parameters.h>
 #include <lv2/ui/ui.h>
 #include <array>
+#include <memory>
 #include <mutex>
 #include <span>
 #include <thread>
@@ -69,6 +70,14 @@ struct Port {
   bool optional;  // True if the connection is optional
 };
 
+/*
+  Scanning the LV2 bundles is the slowest part of creating a wrapper. All the wrappers share one world that is loaded
+  only once, and preload_world() starts loading it on a worker thread so the scan can overlap with other work at
+  startup. If it was not called the first wrapper loads the world.
+*/
+
+void preload_world();
+
 class Lv2Wrapper {
  public:
   Lv2Wrapper(const std::string& plugin_uri);
@@ -243,6 +252,8 @@ class Lv2Wrapper {
  private:
   std::string plugin_uri;
 
+  std::shared_ptr<LilvWorld> shared_world;
+
   LilvWorld* world = nullptr;
 
   const LilvPlugin* plugin = nullptr;
@@ -0,0 +1,72 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <gio/gio.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "effects_base.hpp"
+
+/*
+  Serves a Prometheus text snapshot of the DSP load, latency, clock jumps, quantum, rate, loudness and memory use of
+  the effects chains. Clients connect to the UNIX socket set in the metrics-socket key and receive one snapshot.
+  Relative socket paths are placed in the user runtime directory. The snapshot can also be written to the file set in
+  metrics-file every metrics-file-interval seconds.
+
+  Everything is collected on the main thread when a snapshot is requested. The realtime side only updates the atomic
+  counters it already keeps, so there is no cost while nobody is reading.
+*/
+
+class MetricsServer {
+ public:
+  MetricsServer(EffectsBase* output_effects, EffectsBase* input_effects);
+  MetricsServer(const MetricsServer&) = delete;
+  auto operator=(const MetricsServer&) -> MetricsServer& = delete;
+  MetricsServer(const MetricsServer&&) = delete;
+  auto operator=(const MetricsServer&&) -> MetricsServer& = delete;
+  ~MetricsServer();
+
+  auto snapshot() -> std::string;
+
+ private:
+  GSettings* settings = nullptr;
+
+  EffectsBase *soe = nullptr, *sie = nullptr;
+
+  GSocketService* service = nullptr;
+
+  std::filesystem::path socket_path;
+
+  guint file_timeout_id = 0U;
+
+  std::vector<gulong> gconnections;
+
+  void start_socket();
+
+  void stop_socket();
+
+  void start_file_writer();
+
+  void stop_file_writer();
+
+  void write_file();
+};
@@ -0,0 +1,76 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+/*
+  std::mutex that records how long its callers had to wait for it. The uncontended path is a single try_lock, so it
+  costs the same as a plain std::mutex in the realtime thread. The statistics may be read from any thread.
+*/
+
+class MonitoredMutex {
+ public:
+  struct Stats {
+    uint64_t n_waits = 0U;  // lock() calls that found the mutex taken
+
+    uint64_t total_wait_ns = 0U;
+
+    uint64_t worst_wait_ns = 0U;
+  };
+
+  void lock() {
+    if (mutex.try_lock()) {
+      return;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    mutex.lock();
+
+    const auto wait_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+
+    n_waits.fetch_add(1U, std::memory_order_relaxed);
+
+    total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+
+    auto worst = worst_wait_ns.load(std::memory_order_relaxed);
+
+    while (wait_ns > worst && !worst_wait_ns.compare_exchange_weak(worst, wait_ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  auto try_lock() -> bool { return mutex.try_lock(); }
+
+  void unlock() { mutex.unlock(); }
+
+  [[nodiscard]] auto get_stats() const -> Stats {
+    return {.n_waits = n_waits.load(), .total_wait_ns = total_wait_ns.load(), .worst_wait_ns = worst_wait_ns.load()};
+  }
+
+ private:
+  std::mutex mutex;
+
+  std::atomic<uint64_t> n_waits = 0U, total_wait_ns = 0U, worst_wait_ns = 0U;
+};
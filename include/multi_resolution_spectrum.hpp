@@ -0,0 +1,99 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <fftw3.h>
+#include <sys/types.h>
+#include <memory>
+#include <span>
+#include <vector>
+#include "spectrum_mapping.hpp"
+
+/*
+  Multi-resolution spectrum analyzer. The input goes through a cascade of half band decimators and every level runs
+  a FFT of the same size. Each display frequency is computed at the first level whose bins are narrower than its band,
+  so high frequencies keep a short window while low frequencies get a fine resolution without a huge FFT.
+
+  The result is already on the logarithmic display axis and in dB.
+*/
+
+class MultiResolutionSpectrum {
+ public:
+  MultiResolutionSpectrum(const uint& rate,
+                          const uint& fft_size,
+                          const std::vector<double>& x_axis,
+                          const double& smoothing);
+  MultiResolutionSpectrum(const MultiResolutionSpectrum&) = delete;
+  auto operator=(const MultiResolutionSpectrum&) -> MultiResolutionSpectrum& = delete;
+  MultiResolutionSpectrum(const MultiResolutionSpectrum&&) = delete;
+  auto operator=(const MultiResolutionSpectrum&&) -> MultiResolutionSpectrum& = delete;
+  ~MultiResolutionSpectrum();
+
+  static constexpr uint n_levels = 5U;
+
+  void add_samples(const std::span<const float>& mono);
+
+  void compute(std::vector<double>& output_db);
+
+  [[nodiscard]] auto get_rate() const -> uint;
+
+  [[nodiscard]] auto get_frequencies() const -> const std::vector<double>&;
+
+ private:
+  static constexpr uint n_taps = 47U;  // decimation filter
+
+  struct Level {
+    std::vector<float> history;  // last fft_size samples at this level rate
+
+    uint history_pos = 0U;
+
+    std::vector<float> delay;  // input of the decimation filter feeding the next level
+
+    uint delay_pos = 0U;
+
+    bool odd = false;
+
+    std::vector<float> real_input;
+
+    fftwf_complex* complex_output = nullptr;
+
+    fftwf_plan plan = nullptr;
+
+    std::vector<double> power;
+
+    std::vector<uint> points;  // display points computed at this level
+
+    std::vector<double> mapped_db;
+
+    SpectrumMapping mapping;
+  };
+
+  uint rate = 0U;
+
+  uint fft_size = 0U;
+
+  std::vector<double> x_axis;
+
+  std::vector<float> window;
+
+  std::vector<float> taps;
+
+  std::vector<std::unique_ptr<Level>> levels;
+};
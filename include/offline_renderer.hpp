@@ -0,0 +1,82 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "plugin_base.hpp"
+#include "preset_type.hpp"
+
+/*
+  Runs the effects chain of a preset over audio files without PipeWire. The plugins are the same classes used by the
+  realtime pipeline, created without a PipeManager and fed fixed size blocks as fast as the CPU allows.
+
+  The preset has to be loaded into GSettings before the renderer is created. The output always has two channels and
+  the latency of the chain measured after the first block is removed, so it stays aligned with the input.
+*/
+
+class OfflineRenderer {
+ public:
+  struct Options {
+    uint quantum = 1024U;  // frames per block
+
+    uint rate = 0U;  // 0 keeps the rate of each input file
+
+    uint n_threads = 0U;  // 0 uses one worker per core
+  };
+
+  OfflineRenderer(const PresetType& preset_type, const Options& options);
+
+  /*
+    Renders input into output. When input is a directory every audio file in it is rendered to a file with the same
+    name in the output directory. Each file gets a new chain prepared on the calling thread and the files are spread
+    over a pool of worker threads that only run the DSP.
+  */
+  auto render(const std::filesystem::path& input, const std::filesystem::path& output) -> bool;
+
+ private:
+  using Chain = std::vector<std::shared_ptr<PluginBase>>;
+
+  std::string log_tag = "offline: ";
+
+  std::string schema_base_path;
+
+  std::vector<std::string> plugin_names;
+
+  Options options;
+
+  [[nodiscard]] auto create_chain() const -> Chain;
+
+  // Creates a chain and waits until all of its plugins are set up for the rate. Called from the main thread.
+  [[nodiscard]] auto prepare_chain(const uint& rate) const -> Chain;
+
+  // Destroys a chain on the main thread, after the idle callbacks its plugins queued while rendering are done.
+  static void release_chain(Chain& chain);
+
+  [[nodiscard]] auto render_rate(const std::filesystem::path& input) const -> uint;
+
+  auto render_file(Chain& chain, const std::filesystem::path& input, const std::filesystem::path& output) const
+      -> bool;
+
+  auto render_directory(const std::filesystem::path& input_dir, const std::filesystem::path& output_dir) -> bool;
+};
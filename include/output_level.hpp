@@ -19,7 +19,11 @@
 
 #pragma once
 
+#include <atomic>
+#include "analysis_thread.hpp"
 #include "plugin_base.hpp"
+#include "ring_buffer.hpp"
+#include "true_peak_detector.hpp"
 
 class OutputLevel : public PluginBase {
  public:
@@ -41,4 +45,31 @@ class OutputLevel : public PluginBase {
                std::span<float>& right_out) override;
 
   auto get_latency_seconds() -> float override;
+
+  // Fed by the plugin it is attached to. When it is not attached the meter reads its own input.
+  AnalyzerTap tap{16384U};
+
+ private:
+  std::vector<float> tap_L, tap_R;
+
+  /*
+    The meter shows the true peak. The oversampling is done on the analysis thread. The realtime thread copies the
+    measured samples to these taps and takes the largest true peak found since the last notification.
+  */
+
+  uint analysis_job_id = 0U;
+
+  RingBuffer<float> true_peak_tap_L, true_peak_tap_R;
+
+  std::atomic<float> true_peak_L = 0.0F, true_peak_R = 0.0F;
+
+  // used by the analysis thread
+
+  std::vector<float> chunk_L, chunk_R;
+
+  TruePeakDetector true_peak_detector_L, true_peak_detector_R;
+
+  void measure(std::span<float>& left, std::span<float>& right);
+
+  void analyze();
 };
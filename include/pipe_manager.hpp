@@ -31,6 +31,8 @@
 #include <spa/utils/result.h>
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <span>
@@ -194,7 +196,16 @@ struct DeviceInfo {
 
 class PipeManager {
  public:
-  PipeManager();
+  /*
+    daemon connects to the PipeWire server of the session. in_process runs a private PipeWire graph inside our own
+    context and connects to it with pw_context_connect_self. Nodes, ports, links and the default metadata object are
+    real PipeWire objects, but there is no driver and no session manager, so nothing is ever processed. It exists so
+    the graph code can be exercised headless and deterministically, like in benchmarks/graph_benchmark.cpp.
+  */
+
+  enum class Backend { daemon, in_process };
+
+  explicit PipeManager(const Backend& backend = Backend::daemon);
   PipeManager(const PipeManager&) = delete;
   auto operator=(const PipeManager&) -> PipeManager& = delete;
   PipeManager(const PipeManager&&) = delete;
@@ -244,6 +255,19 @@ class PipeManager {
   std::string default_max_quantum = "0";
   std::string default_quantum = "0";
 
+  /*
+    Extra time added to every sync_wait_unlock() call after the server answered. It emulates the cost of a round trip
+    to a busy daemon when the in_process backend is used.
+  */
+
+  std::atomic<uint> round_trip_delay_us = 0U;
+
+  struct RoundTripStats {
+    uint64_t n_round_trips = 0U;
+
+    uint64_t wait_ns = 0U;  // time spent blocked in sync_wait_unlock()
+  };
+
   auto node_map_at_id(const uint& id) -> NodeInfo&;
 
   auto stream_is_connected(const uint& id, const std::string& media_class) -> bool;
@@ -285,6 +309,10 @@ class PipeManager {
 
   auto wait_full() const -> int;
 
+  [[nodiscard]] auto get_round_trip_stats() const -> RoundTripStats;
+
+  void reset_round_trip_stats();
+
   static void lock_node_map();
 
   static void unlock_node_map();
@@ -319,6 +347,10 @@ class PipeManager {
   pw_context* context = nullptr;
   pw_proxy *proxy_stream_output_sink = nullptr, *proxy_stream_input_source = nullptr;
 
+  pw_proxy* proxy_default_metadata = nullptr;  // only created by the in_process backend
+
+  mutable std::atomic<uint64_t> n_round_trips = 0U, round_trip_ns = 0U;
+
   spa_hook core_listener{}, registry_listener{};
 
   void set_metadata_target_node(const uint& origin_id, const uint& target_id, const uint64_t& target_serial) const;
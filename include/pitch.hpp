@@ -19,9 +19,9 @@
 
 #pragma once
 
-#include <deque>
 #include "SoundTouch.h"
 #include "plugin_base.hpp"
+#include "ring_buffer.hpp"
 
 class Pitch : public PluginBase {
  public:
@@ -53,12 +53,22 @@ class Pitch : public PluginBase {
 
   uint latency_n_frames = 0U;
 
-  std::vector<float> data_L, data_R, data;
+  // PipeWire does not go above this quantum. The buffers are sized for it so a quantum change does not allocate.
+  static constexpr uint max_quantum = 8192U;
 
-  std::deque<float> deque_out_L, deque_out_R;
+  std::vector<float> data;
+
+  RingBuffer<float> fifo_out;  // interleaved stereo
 
   soundtouch::SoundTouch* snd_touch = nullptr;
 
+  bool low_latency = false;
+
+  // Short windows suited for speech. They trade some quality with music for a much smaller processing delay.
+  static constexpr int low_latency_sequence_ms = 20;
+  static constexpr int low_latency_seek_window_ms = 10;
+  static constexpr int low_latency_overlap_ms = 4;
+
   bool anti_alias = false;
   bool quick_seek = false;
 
@@ -78,5 +88,7 @@ class Pitch : public PluginBase {
   void set_anti_alias();
   void set_tempo_difference();
   void set_rate_difference();
+  void allocate_buffers();
   void init_soundtouch();
+  void reset_soundtouch();
 };
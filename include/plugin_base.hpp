@@ -20,12 +20,21 @@
 #pragma once
 
 #include <pipewire/filter.h>
+#include <pthread.h>
 #include <spa/param/latency-utils.h>
+#include <atomic>
 #include <mutex>
 #include <ranges>
+#include <semaphore>
 #include <span>
+#include <thread>
+#include "analyzer_tap.hpp"
+#include "channel_worker.hpp"
+#include "dsp_load_monitor.hpp"
 #include "lv2_wrapper.hpp"
+#include "monitored_mutex.hpp"
 #include "pipe_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"  // IWYU pragma: export
 
 class PluginBase {
@@ -72,6 +81,8 @@ class PluginBase {
 
   bool can_get_node_id = false;
 
+  bool connection_requested = false;
+
   bool enable_probe = false;
 
   uint n_samples = 0U;
@@ -86,22 +97,53 @@ class PluginBase {
 
   bool send_notifications = false;
 
+  std::atomic<bool> async_mode = false;
+
+  std::atomic<uint> async_overruns = 0U;
+
+  std::atomic<bool> async_setup_pending = false;  // set by the realtime thread when setup() has to run
+
+  /*
+    Copies of rate and n_samples and a count of the cycles in which the graph clock did not continue from the
+    previous one, which happens on xruns and when the graph is suspended. Written by the realtime thread.
+  */
+
+  std::atomic<uint> graph_rate = 0U, graph_quantum = 0U;
+
+  std::atomic<uint64_t> n_clock_jumps = 0U;
+
+  uint64_t next_clock_position = 0U;
+
   float delta_t = 0.0F;
 
   float notification_time_window = 1.0F / 20.0F;  // seconds
 
   float latency_value = 0.0F;  // seconds
 
-  std::chrono::time_point<std::chrono::system_clock> clock_start;
+  std::chrono::time_point<std::chrono::steady_clock> clock_start;
+
+  DspLoadMonitor dsp_load;
+
+  // Set by the effects chain the plugin belongs to. It has to outlive the plugin.
+  std::atomic<DspLoadMonitor*> chain_dsp_load = nullptr;
 
   std::vector<float> dummy_left, dummy_right;
 
+  std::string audit_setup_label;  // rt_audit reports what setup() does on the realtime thread under this name
+
   [[nodiscard]] auto get_node_id() const -> uint;
 
   void set_active(const bool& state) const;
 
   void set_post_messages(const bool& state);
 
+  /*
+    connect_to_pw() waits until PipeWire created the node of the filter and its ports. request_connection_to_pw()
+    only starts the connection, so the waits of several filters can overlap. connect_to_pw() finishes it.
+  */
+
+  auto request_connection_to_pw() -> bool;
+
   auto connect_to_pw() -> bool;
 
   void disconnect_from_pw();
@@ -128,16 +170,74 @@ class PluginBase {
                        std::span<float>& probe_left,
                        std::span<float>& probe_right);
 
+  /*
+    Runs setup() for offline processing at the given rate and block size and returns when the plugin is ready. It has
+    to be called from the main thread: the idle callbacks queued by setup() run there, so the FFT plans and the other
+    state they create belong to the main thread and not to the worker that will call process_offline().
+  */
+  void prepare_offline(const uint& sample_rate, const uint& block_size);
+
+  /*
+    Does what on_process() does when the rate or the quantum changes: setup() runs on the calling thread and its idle
+    callbacks wait for the thread that runs the main loop. Used by the harnesses that simulate the realtime thread.
+  */
+  void setup_offline(const uint& sample_rate, const uint& block_size);
+
+  // Blocks until the initialization that setup() started in a thread is done. Only needed offline.
+  virtual void wait_setup();
+
+  /*
+    Runs the plugin without PipeWire. Used by the offline renderer on plugins created with a null PipeManager and
+    prepared by prepare_offline() for the rate and block size used here. It never runs setup() itself.
+  */
+  void process_offline(std::span<float>& left_in,
+                       std::span<float>& right_in,
+                       std::span<float>& left_out,
+                       std::span<float>& right_out,
+                       const uint& sample_rate);
+
   virtual void update_probe_links();
 
   virtual auto get_latency_seconds() -> float;
 
-  sigc::signal<void(const float, const float)> input_level;
-  sigc::signal<void(const float, const float)> output_level;
+  [[nodiscard]] auto get_async_latency_seconds() const -> float;
+
+  [[nodiscard]] auto get_channel_worker_stats() const -> ChannelWorker::Stats;
+
+  // Time other threads made the realtime thread wait for the plugin data and the other way around.
+  [[nodiscard]] auto get_lock_stats() const -> MonitoredMutex::Stats;
+
+  // Used by the test harnesses to change parameters the same way the user interface does.
+  [[nodiscard]] auto get_settings() const -> GSettings*;
+
+  // Called from the main thread. The tap has to outlive the time it stays attached.
+  auto attach_analyzer_tap(AnalyzerTap* tap) -> bool;
+
+  void detach_analyzer_tap(AnalyzerTap* tap);
+
+  void write_analyzer_taps(const AnalyzerTap::Position& position,
+                           const std::span<float>& left,
+                           const std::span<float>& right);
+
+  void process_async(std::span<float>& left_in,
+                     std::span<float>& right_in,
+                     std::span<float>& left_out,
+                     std::span<float>& right_out);
+
+  /*
+    setup() reallocates the buffers process() works on, so in async mode it runs on the worker between two blocks.
+    The realtime thread only raises the request and drops the queued blocks. It never waits for the worker.
+  */
+
+  void request_async_setup();
+
+  // peak left, peak right, rms left and rms right in dB
+  sigc::signal<void(const float, const float, const float, const float)> input_level;
+  sigc::signal<void(const float, const float, const float, const float)> output_level;
   sigc::signal<void()> latency;
 
  protected:
-  std::mutex data_mutex;
+  MonitoredMutex data_mutex;
 
   GSettings* settings = nullptr;
 
@@ -156,12 +256,16 @@ class PluginBase {
 
   std::unique_ptr<lv2::Lv2Wrapper> lv2_wrapper;
 
+  ChannelWorker channel_worker;
+
   std::vector<gulong> gconnections;
 
   void setup_input_output_gain();
 
   void initialize_listener();
 
+  void create_filter(const std::string& description);
+
   void notify();
 
   void get_peaks(const std::span<float>& left_in,
@@ -171,11 +275,76 @@ class PluginBase {
 
   static void apply_gain(std::span<float>& left, std::span<float>& right, const float& gain);
 
+  /*
+    Apply the gain and, when the level meters are visible, measure the result in the same pass over the buffers.
+    Plugins that use them do not have to call get_peaks.
+  */
+
+  void apply_input_gain(std::span<float>& left, std::span<float>& right, const float& gain);
+
+  void apply_output_gain(std::span<float>& left, std::span<float>& right, const float& gain);
+
   void update_filter_params();
 
  private:
+  /*
+    Blocks handed to the async worker go through these slots. The realtime thread only touches a slot when it is
+    free or done and the worker only touches it when it is queued or busy.
+  */
+
+  enum class AsyncSlotState { free, queued, busy, done };
+
+  struct AsyncSlot {
+    std::atomic<AsyncSlotState> state = AsyncSlotState::free;
+
+    uint n_samples = 0U;
+
+    uint64_t cycle = 0U;  // value of async_cycle when the block was queued
+
+    uint generation = 0U;  // value of async_generation when the block was queued
+
+    std::vector<float> in_left, in_right, out_left, out_right;
+  };
+
+  static constexpr uint async_capacity = 8192U;
+
+  bool async_enabled = false;
+
+  uint async_index = 0U;
+
+  uint64_t async_cycle = 0U;
+
+  std::array<AsyncSlot, 2U> async_slots;
+
+  std::atomic<bool> async_worker_running = false;
+
+  std::counting_semaphore<> async_semaphore{0};
+
+  std::atomic<uint> async_generation = 0U;  // incremented by the realtime thread when the quantum or rate change
+
+  std::thread async_worker;
+
+  void start_async_worker();
+
+  void stop_async_worker();
+
+  void async_worker_loop();
+
+  void run_async_setup();
+
   uint node_id = 0U;
 
   float input_peak_left = util::minimum_linear_level, input_peak_right = util::minimum_linear_level;
   float output_peak_left = util::minimum_linear_level, output_peak_right = util::minimum_linear_level;
+
+  // sums of squares since the last notification
+
+  float input_power_left = 0.0F, input_power_right = 0.0F;
+  float output_power_left = 0.0F, output_power_right = 0.0F;
+
+  size_t input_power_count = 0U, output_power_count = 0U;
+
+  static constexpr uint max_analyzer_taps = 2U;  // the spectrum and the output level
+
+  std::array<std::atomic<AnalyzerTap*>, max_analyzer_taps> analyzer_taps{};
 };
@@ -95,6 +95,9 @@ class PresetsManager {
 
   auto load_preset_file(const PresetType& preset_type, const std::string& name) -> bool;
 
+  // Same as load_preset_file() but the preset can be anywhere on the filesystem.
+  auto load_preset_from_path(const PresetType& preset_type, const std::filesystem::path& input_file) -> bool;
+
   auto read_plugins_preset(const PresetType& preset_type,
                            const std::vector<std::string>& plugins,
                            const nlohmann::json& json) -> bool;
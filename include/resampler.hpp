@@ -20,13 +20,14 @@
 #pragma once
 
 #include <samplerate.h>
+#include <algorithm>
 #include <cmath>
 #include <span>
 #include <vector>
 
 class Resampler {
  public:
-  Resampler(const int& input_rate, const int& output_rate);
+  Resampler(const int& input_rate, const int& output_rate, const int& n_channels = 1);
   Resampler(const Resampler&) = delete;
   auto operator=(const Resampler&) -> Resampler& = delete;
   Resampler(const Resampler&&) = delete;
@@ -62,6 +63,54 @@ class Resampler {
     return output;
   }
 
+  /*
+    Stereo variant for resamplers created with two channels. Both channels share the same libsamplerate state, so
+    they always have the same delay. The result is available through get_output_left() and get_output_right().
+  */
+
+  template <typename T>
+  auto process(const T& left, const T& right, const bool& end_of_input) -> size_t {
+    const auto n = std::min(left.size(), right.size());
+
+    const auto max_output_frames = static_cast<size_t>(std::ceil(1.5 * resample_ratio * n)) + 1U;
+
+    interleaved_in.resize(2U * n);
+    output.resize(2U * max_output_frames);
+
+    for (size_t i = 0U; i < n; i++) {
+      interleaved_in[2U * i] = left[i];
+      interleaved_in[2U * i + 1U] = right[i];
+    }
+
+    src_data.input_frames = static_cast<long>(n);
+    src_data.data_in = interleaved_in.data();
+    src_data.output_frames = static_cast<long>(max_output_frames);
+    src_data.data_out = output.data();
+    src_data.src_ratio = resample_ratio;
+    src_data.end_of_input = static_cast<int>(end_of_input);
+
+    src_process(src_state, &src_data);
+
+    const auto n_out = static_cast<size_t>(src_data.output_frames_gen);
+
+    output_left.resize(n_out);
+    output_right.resize(n_out);
+
+    for (size_t i = 0U; i < n_out; i++) {
+      output_left[i] = output[2U * i];
+      output_right[i] = output[2U * i + 1U];
+    }
+
+    return n_out;
+  }
+
+  // Preallocates the buffers used by the stereo process() so it does not allocate in the realtime thread.
+  void reserve(const size_t& max_input_frames);
+
+  [[nodiscard]] auto get_output_left() const -> const std::vector<float>& { return output_left; }
+
+  [[nodiscard]] auto get_output_right() const -> const std::vector<float>& { return output_right; }
+
  private:
   double resample_ratio = 1.0;
 
@@ -70,4 +119,6 @@ class Resampler {
   SRC_DATA src_data{};
 
   std::vector<float> output;
+
+  std::vector<float> interleaved_in, output_left, output_right;
 };
@@ -0,0 +1,130 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/*
+  Fixed capacity FIFO. It is safe to use from one producer thread and one consumer thread at the same time without
+  locks. Only resize() and clear() allocate or reset the indexes and they must not run concurrently with push/pop.
+*/
+
+template <typename T>
+class RingBuffer {
+ public:
+  RingBuffer() = default;
+
+  explicit RingBuffer(const size_t& capacity) { resize(capacity); }
+
+  void resize(const size_t& capacity) {
+    // One slot is always left empty so a full buffer can be told apart from an empty one.
+
+    buffer.resize(capacity + 1U);
+
+    clear();
+  }
+
+  void clear() {
+    read_index.store(0U);
+    write_index.store(0U);
+  }
+
+  [[nodiscard]] auto capacity() const -> size_t { return buffer.empty() ? 0U : buffer.size() - 1U; }
+
+  [[nodiscard]] auto read_available() const -> size_t {
+    const auto w = write_index.load(std::memory_order_acquire);
+    const auto r = read_index.load(std::memory_order_acquire);
+
+    return (w >= r) ? w - r : buffer.size() - r + w;
+  }
+
+  [[nodiscard]] auto write_available() const -> size_t { return capacity() - read_available(); }
+
+  auto push(const std::span<const T>& data) -> size_t {
+    const auto n = std::min(data.size(), write_available());
+
+    auto w = write_index.load(std::memory_order_relaxed);
+
+    const auto first = std::min(n, buffer.size() - w);
+
+    std::copy_n(data.begin(), first, buffer.begin() + w);
+    std::copy_n(data.begin() + first, n - first, buffer.begin());
+
+    w = (w + n) % buffer.size();
+
+    write_index.store(w, std::memory_order_release);
+
+    return n;
+  }
+
+  // Writes n copies of value. Used to prime the buffer with silence.
+  auto push_fill(const size_t& count, const T& value) -> size_t {
+    const auto n = std::min(count, write_available());
+
+    auto w = write_index.load(std::memory_order_relaxed);
+
+    for (size_t i = 0U; i < n; i++) {
+      buffer[w] = value;
+
+      w = (w + 1U) % buffer.size();
+    }
+
+    write_index.store(w, std::memory_order_release);
+
+    return n;
+  }
+
+  // Drops the count oldest elements without copying them.
+  auto discard(const size_t& count) -> size_t {
+    const auto n = std::min(count, read_available());
+
+    const auto r = read_index.load(std::memory_order_relaxed);
+
+    read_index.store((r + n) % buffer.size(), std::memory_order_release);
+
+    return n;
+  }
+
+  auto pop(std::span<T> data) -> size_t {
+    const auto n = std::min(data.size(), read_available());
+
+    auto r = read_index.load(std::memory_order_relaxed);
+
+    const auto first = std::min(n, buffer.size() - r);
+
+    std::copy_n(buffer.begin() + r, first, data.begin());
+    std::copy_n(buffer.begin(), n - first, data.begin() + first);
+
+    r = (r + n) % buffer.size();
+
+    read_index.store(r, std::memory_order_release);
+
+    return n;
+  }
+
+ private:
+  std::vector<T> buffer;
+
+  std::atomic<size_t> read_index = 0U, write_index = 0U;
+};
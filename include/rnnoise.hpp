@@ -26,6 +26,7 @@
 #include <deque>
 #include "plugin_base.hpp"
 #include "resampler.hpp"
+#include "silence_gate.hpp"
 
 class RNNoise : public PluginBase {
  public:
@@ -61,6 +62,7 @@ class RNNoise : public PluginBase {
   bool rnnoise_ready = false;
   bool resampler_ready = false;
   bool enable_vad = false;
+  bool enable_gate = false;
 
   uint blocksize = 480U;
   uint rnnoise_rate = 48000U;
@@ -74,12 +76,14 @@ class RNNoise : public PluginBase {
 
   std::deque<float> deque_out_L, deque_out_R;
 
-  std::vector<float> data_L, data_R, data_tmp;
+  std::vector<float> data_L, data_R, data_tmp_L, data_tmp_R;
   std::vector<float> resampled_data_L, resampled_data_R;
 
   std::unique_ptr<Resampler> resampler_inL, resampler_outL;
   std::unique_ptr<Resampler> resampler_inR, resampler_outR;
 
+  SilenceGate gate;
+
 #ifdef ENABLE_RNNOISE
 
   RNNModel* model = nullptr;
@@ -93,94 +97,49 @@ class RNNoise : public PluginBase {
 
   void free_rnnoise();
 
+  void process_frame(std::vector<float>& data,
+                     std::vector<float>& data_tmp,
+                     DenoiseState* state,
+                     float& vad_prob,
+                     int& vad_grace);
+
   template <typename T1, typename T2>
   void remove_noise(const T1& left_in, const T1& right_in, T2& out_L, T2& out_R) {
-    for (const auto& v : left_in) {
-      data_L.push_back(v);
-
-      if (data_L.size() == blocksize) {
-        if (state_left != nullptr) {
-          std::ranges::for_each(data_L, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
-
-          data_tmp = data_L;
-
-          vad_prob_left = rnnoise_process_frame(state_left, data_L.data(), data_L.data());
-
-          if (enable_vad) {
-            if (vad_prob_left >= vad_thres) {
-              vad_grace_left = release;
-            }
+    const auto size = std::min(left_in.size(), right_in.size());
 
-            if (vad_grace_left >= 0) {
-              --vad_grace_left;
+    for (size_t n = 0U; n < size; n++) {
+      data_L.push_back(left_in[n]);
+      data_R.push_back(right_in[n]);
 
-              for (size_t i = 0U; i < data_L.size(); i++) {
-                data_L[i] = data_L[i] * wet_ratio + data_tmp[i] * (1.0F - wet_ratio);
+      if (data_L.size() != blocksize) {
+        continue;
+      }
 
-                data_L[i] *= inv_short_max;
-              }
-            } else {
-              std::ranges::for_each(data_L, [&](auto& v) { v = 0.0F; });
-            }
-          } else {
-            for (size_t i = 0U; i < data_L.size(); i++) {
-              data_L[i] = data_L[i] * wet_ratio + data_tmp[i] * (1.0F - wet_ratio);
+      // While the gate is closed the frame is left untouched and gate.apply() mutes it.
 
-              data_L[i] *= inv_short_max;
-            }
-          }
-        }
+      if (!enable_gate || gate.update(data_L, data_R)) {
+        channel_worker.run([&]() { process_frame(data_L, data_tmp_L, state_left, vad_prob_left, vad_grace_left); },
+                           [&]() { process_frame(data_R, data_tmp_R, state_right, vad_prob_right, vad_grace_right); });
 
-        for (const auto& v : data_L) {
-          out_L.push_back(v);
+        if (enable_gate && enable_vad && (vad_prob_left >= vad_thres || vad_prob_right >= vad_thres)) {
+          gate.open();
         }
-
-        data_L.resize(0U);
       }
-    }
-
-    for (const auto& v : right_in) {
-      data_R.push_back(v);
-
-      if (data_R.size() == blocksize) {
-        if (state_right != nullptr) {
-          std::ranges::for_each(data_R, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
 
-          data_tmp = data_R;
-
-          vad_prob_right = rnnoise_process_frame(state_right, data_R.data(), data_R.data());
-
-          if (enable_vad) {
-            if (vad_prob_right >= vad_thres) {
-              vad_grace_right = release;
-            }
-
-            if (vad_grace_right >= 0) {
-              --vad_grace_right;
-
-              for (size_t i = 0U; i < data_R.size(); i++) {
-                data_R[i] = data_R[i] * wet_ratio + data_tmp[i] * (1.0F - wet_ratio);
-
-                data_R[i] *= inv_short_max;
-              }
-            } else {
-              std::ranges::for_each(data_R, [&](auto& v) { v = 0.0F; });
-            }
-          } else {
-            for (size_t i = 0U; i < data_R.size(); i++) {
-              data_R[i] = data_R[i] * wet_ratio + data_tmp[i] * (1.0F - wet_ratio);
-
-              data_R[i] *= inv_short_max;
-            }
-          }
-        }
+      if (enable_gate) {
+        gate.apply(data_L, data_R);
+      }
 
-        for (const auto& v : data_R) {
-          out_R.push_back(v);
-        }
+      for (const auto& v : data_L) {
+        out_L.push_back(v);
+      }
 
-        data_R.resize(0U);
+      for (const auto& v : data_R) {
+        out_R.push_back(v);
       }
+
+      data_L.resize(0U);
+      data_R.resize(0U);
     }
   }
 
@@ -0,0 +1,66 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/*
+  Realtime safety audit. Builds configured with -Denable-rt-audit=true replace malloc, free, pthread_mutex_lock and
+  the most common blocking system calls. When one of them is called by a thread inside a Scope, which on_process()
+  opens for the plugin it runs, the call site is recorded. The setup() done on a rate or quantum change is reported
+  separately, as "<plugin> setup". A helper thread prints a symbolized backtrace the first time each site is seen and
+  stop() prints how many violations each plugin had.
+
+  In normal builds Scope is empty and the functions do nothing.
+*/
+
+namespace rt_audit {
+
+#ifdef ENABLE_RT_AUDIT
+
+class Scope {
+ public:
+  explicit Scope(const char* plugin_name);
+  Scope(const Scope&) = delete;
+  auto operator=(const Scope&) -> Scope& = delete;
+  Scope(const Scope&&) = delete;
+  auto operator=(const Scope&&) -> Scope& = delete;
+  ~Scope();
+
+ private:
+  const char* previous_plugin = nullptr;
+};
+
+void start();
+
+void stop();
+
+#else
+
+class Scope {
+ public:
+  explicit Scope([[maybe_unused]] const char* plugin_name) {}
+};
+
+inline void start() {}
+
+inline void stop() {}
+
+#endif
+
+}  // namespace rt_audit
@@ -0,0 +1,149 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "util.hpp"
+
+/*
+  Logging from the realtime threads. util::debug builds strings and goes through GLib, so it can not be called from
+  process(). Here the caller only copies the format string pointer and its arguments into a preallocated lock-free
+  ring. A background thread started by start() formats the messages with fmt and hands them to util::debug,
+  util::info or util::warning.
+
+  The format has to be a string literal. String arguments are truncated to text_size - 1 characters. When the ring
+  is full the message is dropped and counted.
+*/
+
+namespace rt_log {
+
+constexpr size_t max_args = 4U;
+
+constexpr size_t text_size = 64U;
+
+enum class Level : uint8_t { debug, info, warning };
+
+struct Arg {
+  enum class Type : uint8_t { integer, unsigned_integer, real, real_float, text } type = Type::integer;
+
+  int64_t integer = 0;
+
+  uint64_t unsigned_integer = 0U;
+
+  double real = 0.0;
+
+  std::array<char, text_size> text{};
+};
+
+struct Entry {
+  Level level = Level::debug;
+
+  const char* format = nullptr;
+
+  util::source_location location;
+
+  size_t n_args = 0U;
+
+  std::array<Arg, max_args> args;
+};
+
+// Captures the location of the caller the same way util::debug does.
+struct Format {
+  Format(const char* text, util::source_location location = util::source_location::current())
+      : text(text), location(location) {}
+
+  const char* text;
+
+  util::source_location location;
+};
+
+void start();
+
+void stop();
+
+void push(const Entry& entry);
+
+template <typename T>
+void set_arg(Arg& arg, const T& value) {
+  if constexpr (std::is_same_v<T, float>) {
+    arg.type = Arg::Type::real_float;
+    arg.real = static_cast<double>(value);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    arg.type = Arg::Type::real;
+    arg.real = static_cast<double>(value);
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    arg.type = Arg::Type::integer;
+    arg.integer = static_cast<int64_t>(value);
+  } else if constexpr (std::is_integral_v<T>) {
+    arg.type = Arg::Type::unsigned_integer;
+    arg.unsigned_integer = static_cast<uint64_t>(value);
+  } else {
+    const std::string_view view(value);
+
+    const auto n = std::min(view.size(), text_size - 1U);
+
+    arg.type = Arg::Type::text;
+
+    view.copy(arg.text.data(), n);
+
+    arg.text[n] = '\0';
+  }
+}
+
+template <typename... Args>
+void log(const Level& level, const Format& format, const Args&... args) {
+  static_assert(sizeof...(Args) <= max_args, "rt_log supports at most max_args arguments");
+
+  Entry entry;
+
+  entry.level = level;
+  entry.format = format.text;
+  entry.location = format.location;
+  entry.n_args = sizeof...(Args);
+
+  [[maybe_unused]] size_t n = 0U;
+
+  (set_arg(entry.args[n++], args), ...);
+
+  push(entry);
+}
+
+template <typename... Args>
+void debug(const Format& format, const Args&... args) {
+  log(Level::debug, format, args...);
+}
+
+template <typename... Args>
+void info(const Format& format, const Args&... args) {
+  log(Level::info, format, args...);
+}
+
+template <typename... Args>
+void warning(const Format& format, const Args&... args) {
+  log(Level::warning, format, args...);
+}
+
+}  // namespace rt_log
@@ -0,0 +1,140 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <cstddef>
+
+/*
+  Cheap energy detector used by the neural denoisers to decide if the expensive inference step can be skipped.
+
+  While the input stays below the threshold for longer than the hold time the gate closes. When closed the caller
+  is told to run the inference only once every keep_warm_interval frames so the network state does not go stale.
+  Transitions are smoothed with a linear gain ramp that has to be applied to the output with apply().
+*/
+
+class SilenceGate {
+ public:
+  void set_rate(const uint& value);
+
+  void set_threshold(const float& db);
+
+  void set_hold_time(const float& seconds);
+
+  void set_fade_time(const float& seconds);
+
+  void set_keep_warm_interval(const uint& n_frames);
+
+  void reset();
+
+  // Forces the gate open. Used when an external voice detector says there is speech in a keep warm frame.
+  void open();
+
+  [[nodiscard]] auto is_open() const -> bool;
+
+  // Returns true when the caller has to run the inference on this frame.
+  template <typename T>
+  auto update(const T& left, const T& right) -> bool {
+    const auto n = left.size();
+
+    if (n == 0U) {
+      return gain > 0.0F;
+    }
+
+    float energy = 0.0F;
+
+    for (size_t i = 0U; i < n; i++) {
+      energy += left[i] * left[i] + right[i] * right[i];
+    }
+
+    energy /= static_cast<float>(2U * n);
+
+    if (energy >= threshold) {
+      hold_remaining = hold_samples;
+
+      target = 1.0F;
+    } else if (hold_remaining > n) {
+      hold_remaining -= n;
+    } else {
+      hold_remaining = 0U;
+
+      target = 0.0F;
+    }
+
+    if (target == 1.0F || gain > 0.0F) {
+      skipped_frames = 0U;
+
+      return true;
+    }
+
+    if (++skipped_frames >= keep_warm_interval) {
+      skipped_frames = 0U;
+
+      return true;
+    }
+
+    return false;
+  }
+
+  template <typename T>
+  void apply(T& left, T& right) {
+    if (gain == 1.0F && target == 1.0F) {
+      return;
+    }
+
+    const auto n = left.size();
+
+    for (size_t i = 0U; i < n; i++) {
+      if (gain < target) {
+        gain = (gain + step < target) ? gain + step : target;
+      } else if (gain > target) {
+        gain = (gain - step > target) ? gain - step : target;
+      }
+
+      left[i] *= gain;
+      right[i] *= gain;
+    }
+  }
+
+ private:
+  uint rate = 48000U;
+
+  uint hold_samples = 0U;
+
+  uint keep_warm_interval = 10U;
+
+  uint skipped_frames = 0U;
+
+  size_t hold_remaining = 0U;
+
+  float threshold = 0.000001F;  // linear power
+
+  float hold_time = 0.5F;  // seconds
+
+  float fade_time = 0.01F;  // seconds
+
+  float gain = 1.0F;
+
+  float target = 1.0F;
+
+  float step = 1.0F;
+
+  void update_constants();
+};
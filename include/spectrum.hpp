@@ -20,8 +20,13 @@
 #pragma once
 
 #include <fftw3.h>
+#include <algorithm>
 #include <numbers>
+#include "analysis_thread.hpp"
+#include "analyzer_tap.hpp"
+#include "multi_resolution_spectrum.hpp"
 #include "plugin_base.hpp"
+#include "ring_buffer.hpp"
 
 class Spectrum : public PluginBase {
  public:
@@ -46,17 +51,60 @@ class Spectrum : public PluginBase {
 
   sigc::signal<void(uint, uint, std::vector<double>)> power;  // rate, nbands, magnitudes
 
+  // Used by the multi-resolution mode: frequencies, magnitudes in dB, time spent computing the frame in ms
+  sigc::signal<void(std::vector<double>, std::vector<double>, float)> log_power;
+
+  // Samples copied by the realtime thread. Fed by this node or by the plugin it is attached to.
+  AnalyzerTap tap{tap_capacity};
+
  private:
   bool fftw_ready = false;
 
+  uint analysis_job_id = 0U;
+
+  static constexpr size_t tap_capacity = 32768U;
+
+  std::atomic<bool> frame_due = false;
+
+  // everything below is only touched by the analysis thread
+
+  std::mutex analysis_mutex;
+
   fftwf_plan plan = nullptr;
 
   fftwf_complex* complex_output = nullptr;
 
+  uint n_bands = 8192U;  // fft size
+
+  uint hop_size = 0U;  // zero means the transform only runs when a frame is due
+
+  uint history_pos = 0U;
+
+  uint samples_since_fft = 0U;
+
+  uint n_accumulated = 0U;
+
+  std::vector<float> chunk_L, chunk_R;
+
   std::vector<float> real_input;
+
+  std::vector<float> window;
+
+  std::vector<float> history;  // circular buffer with the last n_bands mono samples
+
+  std::vector<float> accumulated;
+
   std::vector<double> output;
 
-  uint n_bands = 8192U;
+  std::vector<double> output_db;
+
+  std::unique_ptr<MultiResolutionSpectrum> multi_resolution;
+
+  void init_fft(const uint& fft_size, const int& overlap);
+
+  void init_multi_resolution();
+
+  void analyze();
 
-  std::deque<float> deque_in_mono;
+  void run_fft();
 };
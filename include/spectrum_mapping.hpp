@@ -0,0 +1,57 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <cstddef>
+#include <vector>
+
+/*
+  Maps the linear frequency bins of the spectrum analyzer to the logarithmic frequency axis used by the UI.
+
+  The weights are computed once for a given rate, number of bins and display axis. Each display point covers the
+  band between the geometric means of its neighbours (widened by the optional fractional octave smoothing). When the
+  band contains analyzer bins their power is averaged. When it is narrower than a bin, which happens at low
+  frequencies, the power is linearly interpolated between the two closest bins.
+*/
+
+class SpectrumMapping {
+ public:
+  // Converts the index of the "octave-smoothing" enum to a fraction of octave.
+  static auto octave_fraction(const int& index) -> double;
+
+  void init(const uint& rate, const uint& n_bins, const std::vector<double>& x_axis, const double& smoothing);
+
+  [[nodiscard]] auto is_valid(const uint& rate, const uint& n_bins) const -> bool;
+
+  // Writes the mapped values in dB, clamped to util::minimum_db_level.
+  void map(const std::vector<double>& bins, std::vector<double>& output_db) const;
+
+ private:
+  uint rate = 0U;
+
+  uint n_bins = 0U;
+
+  std::vector<uint> first_bin;  // first analyzer bin of each display point
+
+  std::vector<uint> offsets;  // where the weights of each display point start. It has one extra element at the end.
+
+  std::vector<double> weights;
+};
@@ -57,4 +57,9 @@ class Speex : public PluginBase {
 
   void free_speex();
 
+  void process_channel(const std::span<float>& in,
+                       std::span<float>& out,
+                       std::vector<spx_int16_t>& data,
+                       SpeexPreprocessState* state);
+
 };
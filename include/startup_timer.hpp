@@ -0,0 +1,79 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+  Measures the startup of Easy Effects. A Phase records when a step of the startup began and ended, counted from the
+  start of the process, and copies it to the tracer when tracing is enabled. Every plugin calls mark_first_audio()
+  from on_process(), so we also know when the first buffer went through the effects chains. That is the time the
+  user waits for processed audio after logging in.
+*/
+
+namespace startup_timer {
+
+struct Record {
+  std::string name;
+
+  double start = 0.0;  // seconds since the start of the process
+
+  double end = 0.0;
+};
+
+extern std::atomic<bool> audio_seen;
+
+void on_first_audio();
+
+// Safe in the realtime threads. Only the first call during the life of the process does something.
+inline void mark_first_audio() {
+  if (!audio_seen.load(std::memory_order_relaxed)) {
+    on_first_audio();
+  }
+}
+
+// Seconds from the start of the process to the first processed buffer. Negative while there was none.
+auto get_first_audio_seconds() -> double;
+
+auto get_phases() -> std::vector<Record>;
+
+// Logs the phases finished so far
+void report();
+
+class Phase {
+ public:
+  explicit Phase(const char* name);
+  Phase(const Phase&) = delete;
+  auto operator=(const Phase&) -> Phase& = delete;
+  Phase(const Phase&&) = delete;
+  auto operator=(const Phase&&) -> Phase& = delete;
+  ~Phase();
+
+ private:
+  const char* name;  // must be a string literal
+
+  uint64_t start_ns;
+};
+
+}  // namespace startup_timer
@@ -34,8 +34,6 @@ inline constexpr auto calf = "Calf Studio Gear";
 
 inline constexpr auto deepfilternet = "DeepFilterNet";
 
-inline constexpr auto ebur128 = "libebur128";
-
 inline constexpr auto ee = "Easy Effects";
 
 inline constexpr auto lsp = "Linux Studio Plugins";
@@ -0,0 +1,101 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/*
+  Span tracer for the audio callbacks, the main loop and the PipeWire events. Each thread writes its events to its
+  own fixed size ring, so recording a span is two clock reads and a copy, without locks. When tracing is disabled a
+  span costs a single relaxed atomic load. dump() writes the rings in the Chrome trace format, which can be opened in
+  https://ui.perfetto.dev or chrome://tracing.
+
+  enable() allocates a fixed pool of rings. A thread claims one with an atomic increment the first time it records an
+  event, so nothing on that path allocates or locks. Only the newest events are kept.
+*/
+
+namespace tracer {
+
+extern std::atomic<bool> enabled;
+
+inline auto is_enabled() -> bool {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+inline auto now_ns() -> uint64_t {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void enable();
+
+void disable();
+
+void set_output_path(const std::string& path);
+
+auto get_output_path() -> std::string;
+
+// name and category must be string literals. detail is copied and may be truncated.
+void record(const char* name,
+            const char* category,
+            const char* detail,
+            const uint64_t& start_ns,
+            const uint64_t& end_ns);
+
+// Zero duration event
+inline void instant(const char* name, const char* category, const char* detail = nullptr) {
+  if (is_enabled()) {
+    const auto t = now_ns();
+
+    record(name, category, detail, t, t);
+  }
+}
+
+auto dump(const std::string& path) -> bool;
+
+class Span {
+ public:
+  Span(const char* name, const char* category, const char* detail = nullptr)
+      : name(name), category(category), detail(detail), start_ns(is_enabled() ? now_ns() : 0U) {}
+  Span(const Span&) = delete;
+  auto operator=(const Span&) -> Span& = delete;
+  Span(const Span&&) = delete;
+  auto operator=(const Span&&) -> Span& = delete;
+  ~Span() {
+    if (start_ns != 0U) {
+      record(name, category, detail, start_ns, now_ns());
+    }
+  }
+
+ private:
+  const char* name;
+
+  const char* category;
+
+  const char* detail;
+
+  uint64_t start_ns;
+};
+
+}  // namespace tracer
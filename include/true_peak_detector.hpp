@@ -0,0 +1,59 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <span>
+
+/*
+  True peak detector as described in ITU-R BS.1770. The signal is oversampled 4 times by a polyphase FIR and the
+  largest absolute value of the oversampled signal is returned.
+
+  The coefficients are stored tap major with the 4 phases next to each other. This way every tap is a single 4 wide
+  multiply and add that the compiler can vectorize. Phase 0 is the original sample, so the result is never below
+  the sample peak.
+*/
+
+class TruePeakDetector {
+ public:
+  TruePeakDetector();
+
+  void reset();
+
+  // Returns the true peak of this buffer. The filter state is kept between calls.
+  auto process(const std::span<const float>& input) -> float;
+
+ private:
+  static constexpr uint n_phases = 4U;
+
+  static constexpr uint n_taps = 12U;  // per phase
+
+  static constexpr uint chunk_size = 256U;
+
+  std::array<std::array<float, n_phases>, n_taps> coefficients{};
+
+  // the last n_taps - 1 samples of the previous call followed by the current chunk
+
+  std::array<float, n_taps - 1U + chunk_size> history{};
+
+  // Filters the first n samples after the history and moves the last ones to its start.
+  void filter_chunk(const size_t& n, std::array<float, n_phases>& peak);
+};
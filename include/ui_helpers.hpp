@@ -70,7 +70,9 @@ void update_level(GtkLevelBar* w_left,
                   GtkLevelBar* w_right,
                   GtkLabel* w_right_label,
                   const float& left,
-                  const float& right);
+                  const float& right,
+                  const float& left_rms,
+                  const float& right_rms);
 
 void append_to_string_list(GtkStringList* string_list, const std::string& name);
 
@@ -96,6 +96,8 @@ auto gsettings_get_string(GSettings* settings, const char* key) -> std::string;
 
 auto gsettings_get_range(GSettings* settings, const char* key) -> std::pair<std::string, std::string>;
 
+auto gsettings_has_key(GSettings* settings, const char* key) -> bool;
+
 auto add_new_blocklist_entry(GSettings* settings, const std::string& name) -> bool;
 
 void remove_blocklist_entry(GSettings* settings, const std::string& name);
@@ -0,0 +1,124 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "analysis_thread.hpp"
+#include "util.hpp"
+
+AnalysisThread::~AnalysisThread() {
+  std::scoped_lock<std::mutex> control_lock(control_mutex);
+
+  stop();
+}
+
+auto AnalysisThread::get() -> AnalysisThread& {
+  static AnalysisThread instance;
+
+  return instance;
+}
+
+auto AnalysisThread::add_job(std::function<void()> job) -> uint {
+  std::scoped_lock<std::mutex> control_lock(control_mutex);
+
+  uint id = 0U;
+
+  {
+    std::scoped_lock<std::mutex> lock(jobs_mutex);
+
+    id = next_id++;
+
+    jobs[id] = std::move(job);
+  }
+
+  if (!running) {
+    start();
+  }
+
+  return id;
+}
+
+void AnalysisThread::remove_job(const uint& id) {
+  std::scoped_lock<std::mutex> control_lock(control_mutex);
+
+  auto stop_thread = false;
+
+  {
+    std::scoped_lock<std::mutex> lock(jobs_mutex);
+
+    jobs.erase(id);
+
+    stop_thread = jobs.empty();
+  }
+
+  if (stop_thread) {
+    stop();
+  }
+}
+
+void AnalysisThread::wake() {
+  if (running) {
+    semaphore.release();
+  }
+}
+
+void AnalysisThread::start() {
+  if (thread.joinable()) {
+    thread.join();
+  }
+
+  running = true;
+
+  thread = std::thread([this]() { loop(); });
+
+  util::debug("analysis thread started");
+}
+
+void AnalysisThread::stop() {
+  if (!running.exchange(false)) {
+    return;
+  }
+
+  semaphore.release();
+
+  if (thread.joinable()) {
+    thread.join();
+  }
+
+  util::debug("analysis thread stopped");
+}
+
+void AnalysisThread::loop() {
+  while (true) {
+    semaphore.acquire();
+
+    // merging the wake ups that were queued while the jobs were running
+
+    while (semaphore.try_acquire()) {
+    }
+
+    if (!running) {
+      break;
+    }
+
+    std::scoped_lock<std::mutex> lock(jobs_mutex);
+
+    for (auto& [id, job] : jobs) {
+      job();
+    }
+  }
+}
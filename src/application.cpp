@@ -18,10 +18,17 @@
  */
 
 #include "application.hpp"
+#include <ctime>
+#include <iomanip>
 #include "application_ui.hpp"
 #include "config.h"
+#include "loudness_log.hpp"
+#include "lv2_wrapper.hpp"
+#include "offline_renderer.hpp"
 #include "preferences_window.hpp"
+#include "startup_timer.hpp"
 #include "tags_app.hpp"
+#include "tracer.hpp"
 
 namespace app {
 
@@ -53,27 +60,53 @@ void update_bypass_state(Application* self) {
 }
 
 void on_startup(GApplication* gapp) {
-  G_APPLICATION_CLASS(application_parent_class)->startup(gapp);
+  {
+    const startup_timer::Phase phase("gtk");
+
+    G_APPLICATION_CLASS(application_parent_class)->startup(gapp);
+  }
 
   auto* self = EE_APP(gapp);
 
+  // The LV2 bundles are scanned on a worker thread while we connect to PipeWire.
+
+  lv2::preload_world();
+
   self->data = new Data();
 
   self->sie_settings = g_settings_new(tags::schema::id_input);
   self->soe_settings = g_settings_new(tags::schema::id_output);
 
-  self->pm = new PipeManager();
-  self->soe = new StreamOutputEffects(self->pm);
-  self->sie = new StreamInputEffects(self->pm);
+  {
+    const startup_timer::Phase phase("pipewire connection");
+
+    self->pm = new PipeManager();
+  }
+
+  {
+    const startup_timer::Phase phase("output effects");
+
+    self->soe = new StreamOutputEffects(self->pm);
+  }
+
+  {
+    const startup_timer::Phase phase("input effects");
+
+    self->sie = new StreamInputEffects(self->pm);
+  }
 
   if (self->settings == nullptr) {
     self->settings = g_settings_new(tags::app::id);
   }
 
   if (self->presets_manager == nullptr) {
+    const startup_timer::Phase phase("presets manager");
+
     self->presets_manager = new PresetsManager();
   }
 
+  self->metrics = new MetricsServer(self->soe, self->sie);
+
   PipeManager::exclude_monitor_stream = g_settings_get_boolean(self->settings, "exclude-monitor-streams") != 0;
 
   self->data->connections.push_back(self->pm->new_default_sink_name.connect([=](const std::string name) {
@@ -211,7 +244,11 @@ void on_startup(GApplication* gapp) {
                        }),
                        self));
 
-  update_bypass_state(self);
+  // The constructors of the pipelines already linked them. Relinking is only needed when the global bypass is on.
+
+  if (g_settings_get_boolean(self->settings, "bypass") != 0) {
+    update_bypass_state(self);
+  }
 
   if ((g_application_get_flags(gapp) & G_APPLICATION_IS_SERVICE) != 0) {
     g_application_hold(gapp);
@@ -235,6 +272,124 @@ void on_startup(GApplication* gapp) {
       util::debug("Cannot check the current PipeWire version against the minimum supported.");
       break;
   }
+
+  startup_timer::report();
+}
+
+auto export_loudness_log(const std::string& argument) -> int {
+  // The argument has the form "log,start,end". The times are in UTC. For example
+  // output_0,2023-05-01T00:00:00,2023-05-02T00:00:00
+
+  std::vector<std::string> fields;
+
+  std::istringstream stream(argument);
+
+  for (std::string field; std::getline(stream, field, ',');) {
+    fields.push_back(field);
+  }
+
+  if (fields.size() != 3U) {
+    std::cerr << _("Expected log,start,end") << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  std::array<int64_t, 2> times{};
+
+  for (size_t n = 0U; n < times.size(); n++) {
+    std::tm utc{};
+
+    std::istringstream time_stream(fields[n + 1U]);
+
+    time_stream >> std::get_time(&utc, "%Y-%m-%dT%H:%M:%S");
+
+    if (time_stream.fail()) {
+      std::cerr << _("Invalid time") + ": "s + fields[n + 1U] << std::endl;
+
+      return EXIT_FAILURE;
+    }
+
+    times[n] = static_cast<int64_t>(timegm(&utc)) * 1000;
+  }
+
+  const auto directory = LoudnessLog::base_directory() / fields[0];
+
+  if (!std::filesystem::is_directory(directory)) {
+    std::cerr << _("Log not found") + ": "s + directory.string() << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  LoudnessLog::write_csv(LoudnessLog::read(directory, times[0], times[1]), std::cout);
+
+  return EXIT_SUCCESS;
+}
+
+auto render_files(Application* self, GVariantDict* options) -> int {
+  const char* preset_path = nullptr;
+  const char** files = nullptr;
+
+  g_variant_dict_lookup(options, "render", "^&ay", &preset_path);
+  g_variant_dict_lookup(options, G_OPTION_REMAINING, "^a&ay", &files);
+
+  std::vector<std::string> paths;
+
+  for (size_t n = 0U; files != nullptr && files[n] != nullptr; n++) {
+    paths.emplace_back(files[n]);
+  }
+
+  g_free(static_cast<gpointer>(files));
+
+  if (preset_path == nullptr || paths.size() != 2U) {
+    std::cerr << _("Expected an input and an output. Example: easyeffects --render preset.json in.wav out.wav")
+              << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  // The preset type is the pipeline section the file has.
+
+  std::optional<PresetType> preset_type;
+
+  try {
+    nlohmann::json json;
+
+    std::ifstream is(preset_path);
+
+    is >> json;
+
+    if (json.contains("output")) {
+      preset_type = PresetType::output;
+    } else if (json.contains("input")) {
+      preset_type = PresetType::input;
+    }
+  } catch (const nlohmann::json::exception& e) {
+    util::warning(e.what());
+  }
+
+  if (!preset_type.has_value() || !self->presets_manager->load_preset_from_path(*preset_type, preset_path)) {
+    std::cerr << _("Could not load the preset") + ": "s + preset_path << std::endl;
+
+    return EXIT_FAILURE;
+  }
+
+  OfflineRenderer::Options render_options;
+
+  if (int value = 0; g_variant_dict_lookup(options, "render-quantum", "i", &value) && value > 0) {
+    render_options.quantum = static_cast<uint>(value);
+  }
+
+  if (int value = 0; g_variant_dict_lookup(options, "render-rate", "i", &value) && value > 0) {
+    render_options.rate = static_cast<uint>(value);
+  }
+
+  if (int value = 0; g_variant_dict_lookup(options, "render-threads", "i", &value) && value > 0) {
+    render_options.n_threads = static_cast<uint>(value);
+  }
+
+  OfflineRenderer renderer(*preset_type, render_options);
+
+  return renderer.render(paths[0], paths[1]) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 void application_class_init(ApplicationClass* klass) {
@@ -275,6 +430,18 @@ void application_class_init(ApplicationClass* klass) {
       return EXIT_SUCCESS;
     }
 
+    if (g_variant_dict_contains(options, "export-loudness-log") != 0) {
+      const char* argument = nullptr;
+
+      g_variant_dict_lookup(options, "export-loudness-log", "&s", &argument);
+
+      return export_loudness_log((argument != nullptr) ? argument : "");
+    }
+
+    if (g_variant_dict_contains(options, "render") != 0) {
+      return render_files(self, options);
+    }
+
     if (g_variant_dict_contains(options, "bypass") != 0) {
       if (int bypass_arg = 2; g_variant_dict_lookup(options, "bypass", "i", &bypass_arg)) {
         if (bypass_arg == 3) {
@@ -345,6 +512,38 @@ void application_class_init(ApplicationClass* klass) {
       return EXIT_SUCCESS;
     }
 
+    if (g_variant_dict_contains(options, "dsp-load") != 0) {
+      const auto report = "Output Effects\n" + self->soe->get_dsp_load_report() + "Input Effects\n" +
+                          self->sie->get_dsp_load_report();
+
+      g_application_command_line_print(cmdline, "%s", report.c_str());
+
+      return EXIT_SUCCESS;
+    }
+
+    if (g_variant_dict_contains(options, "trace") != 0) {
+      const char* argument = nullptr;
+
+      g_variant_dict_lookup(options, "trace", "^&ay", &argument);
+
+      // Relative paths are resolved against the directory of the process that received the option
+
+      auto* file = g_application_command_line_create_file_for_arg(cmdline, argument);
+      auto* path = g_file_get_path(file);
+
+      const std::string trace_path = (path != nullptr) ? path : argument;
+
+      g_free(path);
+      g_object_unref(file);
+
+      if (tracer::is_enabled()) {
+        return tracer::dump(trace_path) ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+
+      tracer::set_output_path(trace_path);
+      tracer::enable();
+    }
+
     if (g_variant_dict_contains(options, "hide-window") != 0) {
       hide_all_windows(gapp);
 
@@ -412,12 +611,14 @@ void application_class_init(ApplicationClass* klass) {
     PipeManager::exiting = true;
 
     delete self->data;
+    delete self->metrics;
     delete self->presets_manager;
     delete self->sie;
     delete self->soe;
     delete self->pm;
 
     self->data = nullptr;
+    self->metrics = nullptr;
     self->presets_manager = nullptr;
     self->sie = nullptr;
     self->soe = nullptr;
@@ -575,6 +776,40 @@ auto application_new() -> GApplication* {
   g_application_add_main_option(G_APPLICATION(app), "load-preset", 'l', G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING,
                                 _("Load a preset. Example: easyeffects -l music"), nullptr);
 
+  g_application_add_main_option(G_APPLICATION(app), "dsp-load", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_NONE,
+                                _("Print the DSP load of every effect in the running instance"), nullptr);
+
+  g_application_add_main_option(
+      G_APPLICATION(app), "trace", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME,
+      _("Record a Chrome trace of the audio callbacks and of the PipeWire events. If the running instance is already "
+        "tracing its current trace is written to FILE. Otherwise it is written when Easy Effects quits or receives "
+        "SIGUSR1"),
+      _("FILE"));
+
+  g_application_add_main_option(
+      G_APPLICATION(app), "export-loudness-log", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_STRING,
+      _("Print a Level Meter log as CSV. Example: easyeffects --export-loudness-log "
+        "output_0,2023-05-01T00:00:00,2023-05-02T00:00:00"),
+      nullptr);
+
+  g_application_add_main_option(
+      G_APPLICATION(app), "render", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_FILENAME,
+      _("Process audio files through a preset without PipeWire. The input and the output can be directories. "
+        "Example: easyeffects --render preset.json in.wav out.wav"),
+      _("PRESET"));
+
+  g_application_add_main_option(G_APPLICATION(app), "render-quantum", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+                                _("Block size used by --render. The default is 1024 frames"), nullptr);
+
+  g_application_add_main_option(G_APPLICATION(app), "render-rate", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+                                _("Sampling rate used by --render. The default is the rate of each file"), nullptr);
+
+  g_application_add_main_option(G_APPLICATION(app), "render-threads", 0, G_OPTION_FLAG_NONE, G_OPTION_ARG_INT,
+                                _("Number of files rendered at the same time. The default is one per core"), nullptr);
+
+  g_application_add_main_option(G_APPLICATION(app), G_OPTION_REMAINING, 0, G_OPTION_FLAG_NONE,
+                                G_OPTION_ARG_FILENAME_ARRAY, _("Input and output used by --render"), _("[FILE…]"));
+
   return G_APPLICATION(app);
 }
 
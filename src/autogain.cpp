@@ -23,7 +23,7 @@ AutoGain::AutoGain(const std::string& tag,
                    const std::string& schema,
                    const std::string& schema_path,
                    PipeManager* pipe_manager)
-    : PluginBase(tag, tags::plugin_name::autogain, tags::plugin_package::ebur128, schema, schema_path, pipe_manager),
+    : PluginBase(tag, tags::plugin_name::autogain, tags::plugin_package::ee, schema, schema_path, pipe_manager),
       target(g_settings_get_double(settings, "target")),
       silence_threshold(g_settings_get_double(settings, "silence-threshold")) {
   reference = parse_reference_key(util::gsettings_get_string(settings, "reference"));
@@ -48,7 +48,7 @@ AutoGain::AutoGain(const std::string& tag,
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto* self = static_cast<AutoGain*>(user_data);
 
-                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
+                                            std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                                             self->set_maximum_history(g_settings_get_int(settings, key));
                                           }),
@@ -61,15 +61,15 @@ AutoGain::AutoGain(const std::string& tag,
         self->mythreads.emplace_back([self]() {  // Using emplace_back here makes sense
           self->data_mutex.lock();
 
-          self->ebur128_ready = false;
+          self->meter_ready = false;
 
           self->data_mutex.unlock();
 
-          auto status = self->init_ebur128();
+          auto status = self->init_meter();
 
           self->data_mutex.lock();
 
-          self->ebur128_ready = status;
+          self->meter_ready = status;
 
           self->data_mutex.unlock();
         });
@@ -98,36 +98,21 @@ AutoGain::~AutoGain() {
 
   mythreads.clear();
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-  }
-
   util::debug(log_tag + name + " destroyed");
 }
 
-auto AutoGain::init_ebur128() -> bool {
+auto AutoGain::init_meter() -> bool {
   if (n_samples == 0 || rate == 0) {
     return false;
   }
 
   internal_output_gain = 1.0;
 
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-
-    ebur_state = nullptr;
-  }
-
-  ebur_state = ebur128_init(2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK);
-
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
+  meter.init(rate);
 
   set_maximum_history(g_settings_get_int(settings, "maximum-history"));
 
-  return ebur_state != nullptr;
+  return true;
 }
 
 auto AutoGain::parse_reference_key(const std::string& key) -> Reference {
@@ -159,29 +144,21 @@ auto AutoGain::parse_reference_key(const std::string& key) -> Reference {
 }
 
 void AutoGain::set_maximum_history(const int& seconds) {
-  if (ebur_state == nullptr) {
-    return;
-  }
-
-  // The value given to ebur128_set_max_history must be in milliseconds
+  // This resizes the histogram rings. So it is not done in the audio thread.
 
-  ebur128_set_max_history(ebur_state, static_cast<ulong>(seconds) * 1000UL);
+  meter.set_max_history(static_cast<uint>(seconds));
 }
 
 void AutoGain::setup() {
-  if (2U * static_cast<size_t>(n_samples) != data.size()) {
-    data.resize(static_cast<size_t>(n_samples) * 2U);
-  }
-
   if (rate != old_rate) {
     data_mutex.lock();
 
-    ebur128_ready = false;
+    meter_ready = false;
 
     data_mutex.unlock();
 
     mythreads.emplace_back([this]() {  // Using emplace_back here makes sense
-      if (ebur128_ready) {
+      if (meter_ready) {
         return;
       }
 
@@ -189,11 +166,11 @@ void AutoGain::setup() {
 
       old_rate = rate;
 
-      status = init_ebur128();
+      status = init_meter();
 
       data_mutex.lock();
 
-      ebur128_ready = status;
+      meter_ready = status;
 
       data_mutex.unlock();
     });
@@ -204,90 +181,45 @@ void AutoGain::process(std::span<float>& left_in,
                        std::span<float>& right_in,
                        std::span<float>& left_out,
                        std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  if (bypass || !ebur128_ready) {
+  if (bypass || !meter_ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
     std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
-
-  for (size_t n = 0U; n < n_samples; n++) {
-    data[2U * n] = left_in[n];
-    data[2U * n + 1U] = right_in[n];
-  }
-
-  ebur128_add_frames_float(ebur_state, data.data(), n_samples);
-
-  auto failed = false;
+  apply_input_gain(left_in, right_in, input_gain);
 
-  if (EBUR128_SUCCESS != ebur128_loudness_momentary(ebur_state, &momentary)) {
-    failed = true;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_shortterm(ebur_state, &shortterm)) {
-    failed = true;
-  }
+  // The loudness values only change when a 100 ms block is finished. So the gain is only recomputed then.
 
-  if (EBUR128_SUCCESS != ebur128_loudness_global(ebur_state, &global)) {
-    failed = true;
-  }
-
-  if (std::isinf(momentary) || std::isnan(momentary)) {
-    /*
-      Assuming zero so that the output gain is negative. This should avoid undesirably high amplification in case
-      a bad resutla comes from libebur128
-    */
-
-    momentary = 0.0;
-  }
+  if (meter.add_frames(left_in, right_in) > 0U) {
+    momentary = meter.momentary();
+    shortterm = meter.shortterm();
+    global = meter.integrated();
 
-  if (shortterm > 10.0 || std::isinf(shortterm) || std::isnan(shortterm)) {
-    /*
-      Sometimes when a stream is started right after Easy Effects has been initialized a very large shorterm value is
-      calculated. Probably because of some weird high intensity transient. So it is better to ignore unresonable large
-       values. When they happen we just set the shorterm value to the momentary loudness.
-    */
+    if (std::isinf(momentary) || std::isnan(momentary)) {
+      // Assuming zero so that the output gain is negative. This avoids a high amplification while there is silence.
 
-    shortterm = momentary;
-  }
+      momentary = 0.0;
+    }
 
-  if (global > 10.0 || std::isinf(global) || std::isnan(global)) {
     /*
-      Sometimes when a stream is started right after Easy Effects has been initialized a very large integrated value is
-      calculated. Probably because of some weird high intensity transient. So it is better to ignore unresonable large
-       values. When they happen we just set the global value to the momentary loudness.
+      Intersample overs and the boost of the K-weighting shelf can make the readings of float input go above 0 LUFS.
+      Unreasonably large values are ignored, otherwise they would become a large gain cut. The momentary loudness is
+      used in their place.
     */
 
-    global = momentary;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_relative_threshold(ebur_state, &relative)) {
-    failed = true;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_range(ebur_state, &range)) {
-    failed = true;
-  }
-
-  if (momentary > silence_threshold && !failed) {
-    double peak_L = 0.0;
-    double peak_R = 0.0;
-
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 0U, &peak_L)) {
-      failed = true;
+    if (shortterm > 10.0 || std::isinf(shortterm) || std::isnan(shortterm)) {
+      shortterm = momentary;
     }
 
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 1U, &peak_R)) {
-      failed = true;
+    if (global > 10.0 || std::isinf(global) || std::isnan(global)) {
+      global = momentary;
     }
 
-    if (!failed) {
+    if (momentary > silence_threshold) {
       switch (reference) {
         case Reference::momentary: {
           loudness = momentary;
@@ -343,7 +275,11 @@ void AutoGain::process(std::span<float>& left_in,
       // 10^(diff/20). The way below should be faster than using pow
       const double gain = std::exp((diff / 20.0) * std::log(10.0));
 
-      const double peak = (peak_L > peak_R) ? peak_L : peak_R;
+      float peak = 0.0F;
+
+      for (size_t n = 0U; n < n_samples; n++) {
+        peak = std::max({peak, std::fabs(left_in[n]), std::fabs(right_in[n])});
+      }
 
       const auto db_peak = util::linear_to_db(peak);
 
@@ -358,18 +294,17 @@ void AutoGain::process(std::span<float>& left_in,
   std::copy(left_in.begin(), left_in.end(), left_out.begin());
   std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
-  if (internal_output_gain != 1.0F) {
-    apply_gain(left_out, right_out, static_cast<float>(internal_output_gain));
-  }
+  // the automatic gain and the user output gain are applied in the same pass
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, static_cast<float>(internal_output_gain) * output_gain);
 
   if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
     if (send_notifications) {
+      // the gating thresholds walk the histograms, so they are only computed when somebody is looking at them
+
+      relative = meter.relative_threshold();
+      range = meter.loudness_range();
+
       results.emit(loudness, internal_output_gain, momentary, shortterm, global, relative, range);
 
       notify();
@@ -380,3 +315,13 @@ void AutoGain::process(std::span<float>& left_in,
 auto AutoGain::get_latency_seconds() -> float {
   return 0.0F;
 }
+
+void AutoGain::wait_setup() {
+  // the meter is initialized in the threads started by setup()
+
+  for (auto& t : mythreads) {
+    t.join();
+  }
+
+  mythreads.clear();
+}
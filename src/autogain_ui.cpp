@@ -89,35 +89,37 @@ void setup(AutogainBox* self, std::shared_ptr<AutoGain> autogain, const std::str
 
   autogain->set_post_messages(true);
 
-  self->data->connections.push_back(autogain->input_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                       self->input_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
-
-  self->data->connections.push_back(autogain->output_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                       self->output_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
+  self->data->connections.push_back(autogain->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                           self->input_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
+
+  self->data->connections.push_back(autogain->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                           self->output_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
 
   self->data->connections.push_back(autogain->results.connect([=](const double loudness, const double gain,
                                                                   const double momentary, const double shortterm,
@@ -82,35 +82,37 @@ void setup(BassEnhancerBox* self, std::shared_ptr<BassEnhancer> bass_enhancer, c
 
   bass_enhancer->set_post_messages(true);
 
-  self->data->connections.push_back(bass_enhancer->input_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                       self->input_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
-
-  self->data->connections.push_back(bass_enhancer->output_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                       self->output_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
+  self->data->connections.push_back(bass_enhancer->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                           self->input_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
+
+  self->data->connections.push_back(bass_enhancer->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                           self->output_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
 
   self->data->connections.push_back(bass_enhancer->harmonics.connect([=](const double value) {
     g_object_ref(self);
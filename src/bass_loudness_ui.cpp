@@ -73,35 +73,37 @@ void setup(BassLoudnessBox* self, std::shared_ptr<BassLoudness> bass_loudness, c
 
   bass_loudness->set_post_messages(true);
 
-  self->data->connections.push_back(bass_loudness->input_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                       self->input_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
-
-  self->data->connections.push_back(bass_loudness->output_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                       self->output_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
+  self->data->connections.push_back(bass_loudness->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                           self->input_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
+
+  self->data->connections.push_back(bass_loudness->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                           self->output_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
 
   gtk_label_set_text(self->plugin_credit, ui::get_plugin_credit_translated(self->data->bass_loudness->package).c_str());
 
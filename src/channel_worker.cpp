@@ -0,0 +1,134 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "channel_worker.hpp"
+#include "util.hpp"
+
+ChannelWorker::~ChannelWorker() {
+  stop();
+}
+
+void ChannelWorker::start() {
+  if (thread.joinable()) {
+    return;
+  }
+
+  reset_stats();
+
+  stopping = false;
+
+  task_state = TaskState::idle;
+
+  helper_priority = HelperPriority::unknown;
+
+  thread = std::thread([this]() { loop(); });
+
+  running = true;
+}
+
+void ChannelWorker::stop() {
+  if (!thread.joinable()) {
+    return;
+  }
+
+  running = false;
+
+  stopping = true;
+
+  start_semaphore.release();
+
+  thread.join();
+}
+
+auto ChannelWorker::is_running() const -> bool {
+  return running;
+}
+
+auto ChannelWorker::get_stats() const -> Stats {
+  return {.n_runs = n_runs.load(),
+          .n_inline_runs = n_inline_runs.load(),
+          .total_ns = total_ns.load(),
+          .wait_ns = wait_ns.load()};
+}
+
+void ChannelWorker::reset_stats() {
+  n_runs = 0U;
+  n_inline_runs = 0U;
+  total_ns = 0U;
+  wait_ns = 0U;
+}
+
+void ChannelWorker::request_caller_priority() {
+  /*
+    Called by the thread that runs the plugin, usually the PipeWire data thread. The helper does the same kind of
+    work, so it should run with the same priority. Otherwise the caller could spin while the helper is not scheduled.
+  */
+
+  if (pthread_getschedparam(pthread_self(), &caller_policy, &caller_param) != 0) {
+    helper_priority.store(HelperPriority::failed, std::memory_order_release);
+
+    return;
+  }
+
+  helper_priority.store(HelperPriority::requested, std::memory_order_release);
+
+  start_semaphore.release();
+}
+
+void ChannelWorker::apply_caller_priority() {
+  if (caller_policy == SCHED_OTHER) {
+    helper_priority.store(HelperPriority::ready, std::memory_order_release);
+
+    return;
+  }
+
+  if (pthread_setschedparam(pthread_self(), caller_policy, &caller_param) != 0) {
+    util::warning("could not give the channel worker a realtime priority. The channels will be processed serially.");
+
+    helper_priority.store(HelperPriority::failed, std::memory_order_release);
+
+    return;
+  }
+
+  helper_priority.store(HelperPriority::ready, std::memory_order_release);
+}
+
+void ChannelWorker::loop() {
+  while (true) {
+    start_semaphore.acquire();
+
+    if (stopping) {
+      break;
+    }
+
+    if (helper_priority.load(std::memory_order_acquire) == HelperPriority::requested) {
+      apply_caller_priority();
+    }
+
+    auto expected = TaskState::pending;
+
+    if (!task_state.compare_exchange_strong(expected, TaskState::claimed, std::memory_order_acquire)) {
+      continue;
+    }
+
+    task_function(task_context);
+
+    task_state.store(TaskState::finished, std::memory_order_release);
+  }
+}
@@ -48,8 +48,25 @@ struct Data {
   std::string x_unit, y_unit;
 
   std::vector<double> y_axis, x_axis, x_axis_log, objects_x;
+
+  /*
+    The waterfall keeps one RGBA row per frames_per_row frames in a circular buffer. Its memory does not grow with
+    time. The rows are uploaded in tiles and only the tile that received a new row is uploaded again.
+  */
+
+  uint waterfall_rows = 0U, waterfall_row = 0U;
+
+  uint waterfall_frames_per_row = 1U, waterfall_n_frames = 0U;
+
+  std::vector<double> waterfall_peaks;  // highest level of each point among the frames merged into the next row
+
+  std::vector<guint8> waterfall_pixels;
+
+  std::vector<GdkTexture*> waterfall_tiles;  // nullptr when the tile has to be uploaded
 };
 
+constexpr uint waterfall_tile_rows = 16U;
+
 struct _Chart {
   GtkBox parent_instance;
 
@@ -173,6 +190,30 @@ void set_margin(Chart* self, const float& v) {
   self->data->margin = v;
 }
 
+void clear_waterfall_tiles(Chart* self) {
+  for (auto& tile : self->data->waterfall_tiles) {
+    g_clear_object(&tile);
+  }
+}
+
+void set_waterfall_rows(Chart* self, const uint& n_rows, const uint& frames_per_row) {
+  if (self->data == nullptr) {
+    return;
+  }
+
+  self->data->waterfall_rows = n_rows;
+  self->data->waterfall_row = 0U;
+
+  self->data->waterfall_frames_per_row = std::max(frames_per_row, 1U);
+  self->data->waterfall_n_frames = 0U;
+
+  self->data->waterfall_pixels.clear();
+
+  clear_waterfall_tiles(self);
+
+  self->data->waterfall_tiles.clear();
+}
+
 auto get_is_visible(Chart* self) -> bool {
   if (!GTK_IS_WIDGET(self)) {
     return false;
@@ -230,11 +271,66 @@ void set_x_data(Chart* self, const std::vector<double>& x) {
   });
 }
 
+void write_waterfall_row(Chart* self, const std::vector<double>& y) {
+  const auto n_points = y.size();
+  const auto n_rows = self->data->waterfall_rows;
+
+  if (self->data->waterfall_pixels.size() != 4U * n_points * n_rows) {
+    self->data->waterfall_pixels.assign(4U * n_points * n_rows, 0U);
+
+    self->data->waterfall_row = 0U;
+    self->data->waterfall_n_frames = 0U;
+
+    clear_waterfall_tiles(self);
+
+    self->data->waterfall_tiles.assign((n_rows + waterfall_tile_rows - 1U) / waterfall_tile_rows, nullptr);
+  }
+
+  // When there are more frames than rows a row shows the peaks of the frames merged into it.
+
+  auto& peaks = self->data->waterfall_peaks;
+
+  if (self->data->waterfall_n_frames == 0U) {
+    peaks = y;
+  } else {
+    for (size_t n = 0U; n < n_points; n++) {
+      peaks[n] = std::max(peaks[n], y[n]);
+    }
+  }
+
+  if (++self->data->waterfall_n_frames < self->data->waterfall_frames_per_row) {
+    return;
+  }
+
+  self->data->waterfall_n_frames = 0U;
+
+  // The intensity uses a fixed dB range so the colors do not change with the dynamic y scale.
+
+  auto* row = self->data->waterfall_pixels.data() + 4U * n_points * self->data->waterfall_row;
+
+  for (size_t n = 0U; n < n_points; n++) {
+    const auto intensity = std::clamp((peaks[n] - util::minimum_db_level) / -util::minimum_db_level, 0.0, 1.0);
+
+    row[4U * n] = static_cast<guint8>(255.0F * self->data->color.red);
+    row[4U * n + 1U] = static_cast<guint8>(255.0F * self->data->color.green);
+    row[4U * n + 2U] = static_cast<guint8>(255.0F * self->data->color.blue);
+    row[4U * n + 3U] = static_cast<guint8>(255.0 * intensity * self->data->color.alpha);
+  }
+
+  g_clear_object(&self->data->waterfall_tiles[self->data->waterfall_row / waterfall_tile_rows]);
+
+  self->data->waterfall_row = (self->data->waterfall_row + 1U) % n_rows;
+}
+
 void set_y_data(Chart* self, const std::vector<double>& y) {
   if (!GTK_IS_WIDGET(self) || y.empty()) {
     return;
   }
 
+  if (self->data->chart_type == ChartType::waterfall && self->data->waterfall_rows > 0U) {
+    write_waterfall_row(self, y);
+  }
+
   self->data->y_axis = y;
 
   auto min_y = std::ranges::min(y);
@@ -536,6 +632,70 @@ void snapshot(GtkWidget* widget, GtkSnapshot* snapshot) {
 
         break;
       }
+      case ChartType::waterfall: {
+        const auto n_rows = self->data->waterfall_rows;
+
+        if (n_rows == 0U || self->data->waterfall_pixels.size() != 4U * n_points * n_rows) {
+          break;
+        }
+
+        // Only the tiles that received a new row are uploaded again.
+
+        for (uint t = 0U; t < self->data->waterfall_tiles.size(); t++) {
+          if (self->data->waterfall_tiles[t] != nullptr) {
+            continue;
+          }
+
+          const auto first_row = t * waterfall_tile_rows;
+          const auto tile_rows = std::min(waterfall_tile_rows, n_rows - first_row);
+          const auto stride = 4U * n_points;
+
+          auto* bytes = g_bytes_new(self->data->waterfall_pixels.data() + stride * first_row, stride * tile_rows);
+
+          self->data->waterfall_tiles[t] = gdk_memory_texture_new(
+              static_cast<int>(n_points), static_cast<int>(tile_rows), GDK_MEMORY_R8G8B8A8, bytes, stride);
+
+          g_bytes_unref(bytes);
+        }
+
+        const auto x0 = static_cast<float>(self->data->margin * width);
+        const auto w = static_cast<float>(width - 2.0 * self->data->margin * width);
+        const auto h = static_cast<float>(usable_height);
+        const auto row_height = h / static_cast<float>(n_rows);
+        const auto oldest = static_cast<float>(self->data->waterfall_row);
+
+        gtk_snapshot_save(snapshot);
+
+        // flipping the y axis so the newest row is at the top and the oldest one at the bottom
+
+        auto origin = GRAPHENE_POINT_INIT(0.0F, static_cast<float>(self->data->margin * height) + h);
+
+        gtk_snapshot_translate(snapshot, &origin);
+        gtk_snapshot_scale(snapshot, 1.0F, -1.0F);
+
+        auto area = GRAPHENE_RECT_INIT(x0, 0.0F, w, h);
+
+        gtk_snapshot_push_clip(snapshot, &area);
+
+        // Scrolling is done by drawing the tiles twice. The clip drops what falls outside of the chart.
+
+        for (const auto offset : {-oldest, static_cast<float>(n_rows) - oldest}) {
+          for (uint t = 0U; t < self->data->waterfall_tiles.size(); t++) {
+            const auto first_row = static_cast<float>(t * waterfall_tile_rows);
+            const auto tile_rows = static_cast<float>(std::min(waterfall_tile_rows, n_rows - t * waterfall_tile_rows));
+
+            auto bounds = GRAPHENE_RECT_INIT(x0, (offset + first_row) * row_height, w, tile_rows * row_height);
+
+            gtk_snapshot_append_texture(snapshot, self->data->waterfall_tiles[t], &bounds);
+          }
+        }
+
+        gtk_snapshot_pop(snapshot);
+
+        gtk_snapshot_restore(snapshot);
+
+        break;
+      }
       case ChartType::line: {
         auto* ctx = gtk_snapshot_append_cairo(snapshot, &widget_rectangle);
 
@@ -624,6 +784,8 @@ void unroot(GtkWidget* widget) {
 void finalize(GObject* object) {
   auto* self = EE_CHART(object);
 
+  clear_waterfall_tiles(self);
+
   delete self->data;
 
   self->data = nullptr;
@@ -141,16 +141,12 @@ void Compressor::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out, probe_left, probe_right);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, output_gain);
 
   /*
    This plugin gives the latency in number of samples
@@ -163,7 +159,7 @@ void Compressor::process(std::span<float>& left_in,
 
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
 
     util::idle_add([=, this]() {
       if (!post_messages || latency.empty()) {
@@ -177,8 +173,6 @@ void Compressor::process(std::span<float>& left_in,
   }
 
   if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
     if (send_notifications) {
       reduction_port_value =
           0.5F * (lv2_wrapper->get_control_port_value("rlm_l") + lv2_wrapper->get_control_port_value("rlm_r"));
@@ -163,35 +163,37 @@ void setup(CompressorBox* self,
     }
   }
 
-  self->data->connections.push_back(compressor->input_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                       self->input_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
-
-  self->data->connections.push_back(compressor->output_level.connect([=](const float left, const float right) {
-    g_object_ref(self);
-
-    util::idle_add(
-        [=]() {
-          if (get_ignore_filter_idle_add(serial)) {
-            return;
-          }
-
-          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                       self->output_level_right_label, left, right);
-        },
-        [=]() { g_object_unref(self); });
-  }));
+  self->data->connections.push_back(compressor->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                           self->input_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
+
+  self->data->connections.push_back(compressor->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        g_object_ref(self);
+
+        util::idle_add(
+            [=]() {
+              if (get_ignore_filter_idle_add(serial)) {
+                return;
+              }
+
+              update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                           self->output_level_right_label, left, right, left_rms, right_rms);
+            },
+            [=]() { g_object_unref(self); });
+    }));
 
   self->data->connections.push_back(compressor->reduction.connect([=](const float value) {
     g_object_ref(self);
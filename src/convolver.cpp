@@ -40,7 +40,7 @@ Convolver::Convolver(const std::string& tag,
 
                                             self->ir_width = g_settings_get_int(self->settings, key);
 
-                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
+                                            std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                                             if (self->kernel_is_initialized) {
                                               self->kernel_L = self->original_kernel_L;
@@ -71,6 +71,15 @@ Convolver::Convolver(const std::string& tag,
                                           this));
 
   setup_input_output_gain();
+
+  // Decoding the impulse response takes a while. setup() only has to resample it if we start now.
+
+  prefetched_kernel_path = util::gsettings_get_string(settings, "kernel-path");
+
+  if (!prefetched_kernel_path.empty()) {
+    kernel_prefetch = std::async(std::launch::async,
+                                 [this, path = prefetched_kernel_path]() { return load_kernel_file(path); });
+  }
 }
 
 Convolver::~Convolver() {
@@ -84,7 +93,7 @@ Convolver::~Convolver() {
 
   mythreads.clear();
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   ready = false;
 
@@ -145,7 +154,7 @@ void Convolver::setup() {
       setup_zita();
     }
 
-    std::scoped_lock<std::mutex> lock(data_mutex);
+    std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
     ready = kernel_is_initialized && zita_ready;
   });
@@ -155,7 +164,7 @@ void Convolver::process(std::span<float>& left_in,
                         std::span<float>& right_in,
                         std::span<float>& left_out,
                         std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass || !ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -164,9 +173,7 @@ void Convolver::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   if (n_samples_is_power_of_2) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -232,14 +239,12 @@ void Convolver::process(std::span<float>& left_in,
     }
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
 
     util::idle_add([=, this] { latency.emit(); });
 
@@ -248,26 +253,12 @@ void Convolver::process(std::span<float>& left_in,
     notify_latency = false;
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
-    if (send_notifications) {
-      notify();
-    }
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
-void Convolver::read_kernel_file() {
-  kernel_is_initialized = false;
-
-  const auto path = util::gsettings_get_string(settings, "kernel-path");
-
-  if (path.empty()) {
-    util::warning(log_tag + name + ": irs file path is null. Entering passthrough mode...");
-
-    return;
-  }
-
+auto Convolver::load_kernel_file(const std::string& path) const -> std::optional<KernelFile> {
   // SndfileHandle might have issues with std::string, so we provide cstring
 
   SndfileHandle file = SndfileHandle(path.c_str());
@@ -276,7 +267,7 @@ void Convolver::read_kernel_file() {
     util::warning(log_tag + name + ": irs file does not exists or it is empty: " + path);
     util::warning(log_tag + name + ": Entering passthrough mode...");
 
-    return;
+    return std::nullopt;
   }
 
   util::debug(log_tag + name + ": irs file: " + path);
@@ -290,33 +281,67 @@ void Convolver::read_kernel_file() {
     util::warning(log_tag + name + " Only stereo impulse responses are supported.");
     util::warning(log_tag + name + " The impulse file was not loaded!");
 
-    return;
+    return std::nullopt;
   }
 
   std::vector<float> buffer(file.frames() * file.channels());
-  std::vector<float> buffer_L(file.frames());
-  std::vector<float> buffer_R(file.frames());
+
+  KernelFile kernel{.rate = file.samplerate(),
+                    .left = std::vector<float>(file.frames()),
+                    .right = std::vector<float>(file.frames())};
 
   file.readf(buffer.data(), file.frames());
 
-  for (size_t n = 0U; n < buffer_L.size(); n++) {
-    buffer_L[n] = buffer[2U * n];
-    buffer_R[n] = buffer[2U * n + 1U];
+  for (size_t n = 0U; n < kernel.left.size(); n++) {
+    kernel.left[n] = buffer[2U * n];
+    kernel.right[n] = buffer[2U * n + 1U];
+  }
+
+  return kernel;
+}
+
+void Convolver::read_kernel_file() {
+  kernel_is_initialized = false;
+
+  const auto path = util::gsettings_get_string(settings, "kernel-path");
+
+  if (path.empty()) {
+    util::warning(log_tag + name + ": irs file path is null. Entering passthrough mode...");
+
+    return;
+  }
+
+  std::optional<KernelFile> kernel;
+
+  if (kernel_prefetch.valid()) {
+    kernel = kernel_prefetch.get();
+
+    // the path may have changed while the file was being decoded
+
+    if (path != prefetched_kernel_path) {
+      kernel = load_kernel_file(path);
+    }
+  } else {
+    kernel = load_kernel_file(path);
+  }
+
+  if (!kernel.has_value()) {
+    return;
   }
 
-  if (file.samplerate() != static_cast<int>(rate)) {
+  if (kernel->rate != static_cast<int>(rate)) {
     util::debug(log_tag + name + " resampling the kernel to " + util::to_string(rate));
 
-    auto resampler = std::make_unique<Resampler>(file.samplerate(), rate);
+    auto resampler = std::make_unique<Resampler>(kernel->rate, rate);
 
-    original_kernel_L = resampler->process(buffer_L, true);
+    original_kernel_L = resampler->process(kernel->left, true);
 
-    resampler = std::make_unique<Resampler>(file.samplerate(), rate);
+    resampler = std::make_unique<Resampler>(kernel->rate, rate);
 
-    original_kernel_R = resampler->process(buffer_R, true);
+    original_kernel_R = resampler->process(kernel->right, true);
   } else {
-    original_kernel_L = buffer_L;
-    original_kernel_R = buffer_R;
+    original_kernel_L = std::move(kernel->left);
+    original_kernel_R = std::move(kernel->right);
   }
 
   kernel_is_initialized = true;
@@ -40,6 +40,8 @@ void ConvolverPreset::save(nlohmann::json& json) {
   json[section][instance_name]["ir-width"] = g_settings_get_int(settings, "ir-width");
 
   json[section][instance_name]["autogain"] = g_settings_get_boolean(settings, "autogain") != 0;
+
+  json[section][instance_name]["async-mode"] = g_settings_get_boolean(settings, "async-mode") != 0;
 }
 
 void ConvolverPreset::load(const nlohmann::json& json) {
@@ -54,4 +56,6 @@ void ConvolverPreset::load(const nlohmann::json& json) {
   update_key<int>(json.at(section).at(instance_name), settings, "ir-width", "ir-width");
 
   update_key<bool>(json.at(section).at(instance_name), settings, "autogain", "autogain");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "async-mode", "async-mode");
 }
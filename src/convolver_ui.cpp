@@ -470,27 +470,29 @@ void setup(ConvolverBox* self,
 
   ui::convolver_menu_impulses::setup(self->impulses_menu, schema_path, application);
 
-  self->data->connections.push_back(convolver->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
+  self->data->connections.push_back(convolver->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
+  self->data->connections.push_back(convolver->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
 
-  self->data->connections.push_back(convolver->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   self->data->gconnections.push_back(g_signal_connect(
       self->settings, "changed::kernel-path", G_CALLBACK(+[](GSettings* settings, char* key, ConvolverBox* self) {
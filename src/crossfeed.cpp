@@ -32,7 +32,7 @@ Crossfeed::Crossfeed(const std::string& tag,
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto* self = static_cast<Crossfeed*>(user_data);
 
-                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
+                                            std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                                             self->bs2b.set_level_fcut(g_settings_get_int(settings, key));
                                           }),
@@ -42,7 +42,7 @@ Crossfeed::Crossfeed(const std::string& tag,
       g_signal_connect(settings, "changed::feed", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                          auto* self = static_cast<Crossfeed*>(user_data);
 
-                         std::scoped_lock<std::mutex> lock(self->data_mutex);
+                         std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                          self->bs2b.set_level_feed(10 * static_cast<int>(g_settings_get_double(settings, key)));
                        }),
@@ -60,7 +60,7 @@ Crossfeed::~Crossfeed() {
 }
 
 void Crossfeed::setup() {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   data.resize(2U * static_cast<size_t>(n_samples));
 
@@ -73,7 +73,7 @@ void Crossfeed::process(std::span<float>& left_in,
                         std::span<float>& right_in,
                         std::span<float>& left_out,
                         std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -82,9 +82,7 @@ void Crossfeed::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   for (size_t n = 0U; n < left_in.size(); n++) {
     data[n * 2U] = left_in[n];
@@ -98,16 +96,10 @@ void Crossfeed::process(std::span<float>& left_in,
     right_out[n] = data[n * 2U + 1U];
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
+  apply_output_gain(left_out, right_out, output_gain);
 
-    if (send_notifications) {
-      notify();
-    }
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
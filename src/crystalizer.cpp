@@ -141,7 +141,7 @@ void Crystalizer::process(std::span<float>& left_in,
                           std::span<float>& right_in,
                           std::span<float>& left_out,
                           std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass || !filters_are_ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -150,9 +150,7 @@ void Crystalizer::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   if (n_samples_is_power_of_2 && blocksize == n_samples) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -218,14 +216,12 @@ void Crystalizer::process(std::span<float>& left_in,
     }
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
 
     util::idle_add([=, this]() {
       if (!post_messages || latency.empty()) {
@@ -240,12 +236,8 @@ void Crystalizer::process(std::span<float>& left_in,
     notify_latency = false;
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
-    if (send_notifications) {
-      notify();
-    }
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
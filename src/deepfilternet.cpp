@@ -54,6 +54,26 @@ DeepFilterNet::DeepFilterNet(const std::string& tag,
 
   ladspa_wrapper->bind_key_double<"Post Filter Beta", "post-filter-beta">(settings);
 
+  enable_gate = g_settings_get_boolean(settings, "enable-gate") != 0;
+
+  gate.set_threshold(static_cast<float>(g_settings_get_double(settings, "gate-threshold")));
+
+  gconnections.push_back(g_signal_connect(settings, "changed::enable-gate",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, DeepFilterNet* self) {
+                                            std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
+
+                                            self->enable_gate = g_settings_get_boolean(settings, key) != 0;
+
+                                            self->gate.reset();
+                                          }),
+                                          this));
+
+  gconnections.push_back(g_signal_connect(
+      settings, "changed::gate-threshold", G_CALLBACK(+[](GSettings* settings, char* key, DeepFilterNet* self) {
+        self->gate.set_threshold(static_cast<float>(g_settings_get_double(settings, key)));
+      }),
+      this));
+
   setup_input_output_gain();
 }
 
@@ -66,49 +86,67 @@ DeepFilterNet::~DeepFilterNet() {
 }
 
 void DeepFilterNet::setup() {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (!ladspa_wrapper->found_plugin()) {
     return;
   }
 
-  resample = rate != 48000;
-  resampler_ready = !resample;
+  resample = rate != df_rate;
+  buffers_ready = false;
+
+  latency_n_frames = 0U;
+  notify_latency = true;
+
+  gate.set_rate(df_rate);
+
+  // Roughly 100 ms between keep warm runs. The gate sees one hop at a time.
+  gate.set_keep_warm_interval(10U);
+
+  gate.reset();
 
   util::idle_add([&, this] {
-    ladspa_wrapper->n_samples = n_samples;
-    std::scoped_lock<std::mutex> lock(data_mutex);
+    std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-    if (ladspa_wrapper->get_rate() != 48000) {
-      ladspa_wrapper->create_instance(48000);
+    if (ladspa_wrapper->get_rate() != df_rate) {
+      ladspa_wrapper->create_instance(df_rate);
       ladspa_wrapper->activate();
     }
 
-    if (resample && !resampler_ready) {
-      resampler_inL = std::make_unique<Resampler>(rate, 48000);
-      resampler_inR = std::make_unique<Resampler>(rate, 48000);
-      resampler_outL = std::make_unique<Resampler>(48000, rate);
-      resampler_outR = std::make_unique<Resampler>(48000, rate);
+    if (!buffers_ready) {
+      /*
+        The model always receives whole hops at 48 kHz taken from the input fifo. At other rates a single stereo
+        resampler is used in each direction so both channels have the same delay.
+      */
+
+      auto max_input = static_cast<size_t>(n_samples);
 
-      std::vector<float> dummy(n_samples);
+      if (resample) {
+        resampler_in = std::make_unique<Resampler>(rate, df_rate, 2);
+        resampler_out = std::make_unique<Resampler>(df_rate, rate, 2);
 
-      const auto resampled_inL = resampler_inL->process(dummy, false);
-      const auto resampled_inR = resampler_inR->process(dummy, false);
+        resampler_in->reserve(n_samples);
+        resampler_out->reserve(hop_size);
 
-      resampled_outL.resize(resampled_inL.size());
-      resampled_outR.resize(resampled_inR.size());
+        max_input =
+            static_cast<size_t>(std::ceil(1.5 * static_cast<double>(df_rate) * n_samples / static_cast<double>(rate)));
+      } else {
+        resampler_in.reset();
+        resampler_out.reset();
+      }
 
-      resampler_outL->process(resampled_inL, false);
-      resampler_outR->process(resampled_inR, false);
+      fifo_in_L.resize(max_input + 2U * hop_size);
+      fifo_in_R.resize(max_input + 2U * hop_size);
 
-      carryover_l.clear();
-      carryover_r.clear();
-      carryover_l.reserve(4);  // chosen by fair dice roll.
-      carryover_r.reserve(4);  // guaranteed to be random.
-      carryover_l.push_back(0.0F);
-      carryover_r.push_back(0.0F);
+      fifo_out_L.resize(4U * (n_samples + hop_size));
+      fifo_out_R.resize(4U * (n_samples + hop_size));
 
-      resampler_ready = true;
+      frame_in_L.resize(hop_size);
+      frame_in_R.resize(hop_size);
+      frame_out_L.resize(hop_size);
+      frame_out_R.resize(hop_size);
+
+      buffers_ready = true;
     }
   });
 }
@@ -117,81 +155,107 @@ void DeepFilterNet::process(std::span<float>& left_in,
                             std::span<float>& right_in,
                             std::span<float>& left_out,
                             std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  if (!ladspa_wrapper->found_plugin() || !ladspa_wrapper->has_instance() || bypass) {
+  if (!ladspa_wrapper->found_plugin() || !ladspa_wrapper->has_instance() || bypass || !buffers_ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
     std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
-  if (resample) {
-    const auto& resampled_inL = resampler_inL->process(left_in, false);
-    const auto& resampled_inR = resampler_inR->process(right_in, false);
+  /*
+    While the gate is closed the model only runs once in a while to keep its internal state warm. Everything else
+    keeps running so the stream timing does not change when the gate opens again.
+  */
 
-    resampled_outL.resize(resampled_inL.size());
-    resampled_outR.resize(resampled_inR.size());
+  if (resample) {
+    resampler_in->process(left_in, right_in, false);
 
-    ladspa_wrapper->n_samples = resampled_inL.size();
-    ladspa_wrapper->connect_data_ports(resampled_inL, resampled_inR, resampled_outL, resampled_outR);
+    fifo_in_L.push(resampler_in->get_output_left());
+    fifo_in_R.push(resampler_in->get_output_right());
   } else {
-    ladspa_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
+    fifo_in_L.push(left_in);
+    fifo_in_R.push(right_in);
   }
 
-  ladspa_wrapper->run();
+  while (fifo_in_L.read_available() >= hop_size && fifo_in_R.read_available() >= hop_size) {
+    fifo_in_L.pop(frame_in_L);
+    fifo_in_R.pop(frame_in_R);
 
-  if (resample) {
-    const auto& outL = resampler_outL->process(resampled_outL, false);
-    const auto& outR = resampler_outR->process(resampled_outR, false);
+    if (!enable_gate || gate.update(frame_in_L, frame_in_R)) {
+      ladspa_wrapper->n_samples = hop_size;
 
-    auto carryover_end_l = std::min(carryover_l.size(), left_out.size());
-    auto carryover_end_r = std::min(carryover_r.size(), right_out.size());
+      ladspa_wrapper->connect_data_ports(frame_in_L, frame_in_R, frame_out_L, frame_out_R);
 
-    auto left_offset =
-        carryover_end_l + outL.size() > left_out.size() ? carryover_end_l : left_out.size() - outL.size();
-    auto right_offset =
-        carryover_end_r + outR.size() > right_out.size() ? carryover_end_r : right_out.size() - outR.size();
+      ladspa_wrapper->run();
+    } else {
+      std::ranges::fill(frame_out_L, 0.0F);
+      std::ranges::fill(frame_out_R, 0.0F);
+    }
 
-    auto left_count = std::min(outL.size(), left_out.size() - left_offset);
-    auto right_count = std::min(outR.size(), right_out.size() - right_offset);
+    if (resample) {
+      resampler_out->process(frame_out_L, frame_out_R, false);
 
-    std::copy(carryover_l.begin(), carryover_l.begin() + carryover_end_l, left_out.begin());
-    std::copy(carryover_r.begin(), carryover_r.begin() + carryover_end_r, right_out.begin());
+      fifo_out_L.push(resampler_out->get_output_left());
+      fifo_out_R.push(resampler_out->get_output_right());
+    } else {
+      fifo_out_L.push(frame_out_L);
+      fifo_out_R.push(frame_out_R);
+    }
+  }
 
-    carryover_l.erase(carryover_l.begin(), carryover_l.begin() + carryover_end_l);
-    carryover_r.erase(carryover_r.begin(), carryover_r.begin() + carryover_end_r);
+  /*
+    The hop buffering and the resamplers hold some samples back. When the output fifo does not have enough of them
+    we prime it with silence. This padding is exactly the latency added by this stage.
+  */
 
-    std::fill(left_out.begin() + carryover_end_l, left_out.begin() + left_offset, 0);
-    std::fill(right_out.begin() + carryover_end_r, right_out.begin() + right_offset, 0);
+  if (const auto available = std::min(fifo_out_L.read_available(), fifo_out_R.read_available());
+      available < left_out.size()) {
+    const auto missing = left_out.size() - available;
 
-    std::copy(outL.begin(), outL.begin() + left_count, left_out.begin() + left_offset);
-    std::copy(outR.begin(), outR.begin() + right_count, right_out.begin() + right_offset);
+    fifo_out_L.push_fill(missing, 0.0F);
+    fifo_out_R.push_fill(missing, 0.0F);
 
-    carryover_l.insert(carryover_l.end(), outL.begin() + left_count, outL.end());
-    carryover_r.insert(carryover_r.end(), outR.begin() + right_count, outR.end());
+    latency_n_frames += missing;
 
-    std::fill(left_out.begin() + left_offset + left_count, left_out.end(), 0);
-    std::fill(right_out.begin() + right_offset + right_count, right_out.end(), 0);
+    notify_latency = true;
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
+  fifo_out_L.pop(left_out);
+  fifo_out_R.pop(right_out);
+
+  if (enable_gate) {
+    gate.apply(left_out, right_out);
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
+  apply_output_gain(left_out, right_out, output_gain);
 
-    if (send_notifications) {
-      notify();
-    }
+  if (notify_latency) {
+    latency_value = model_latency + static_cast<float>(latency_n_frames) / static_cast<float>(rate);
+
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
+
+    util::idle_add([=, this]() {
+      if (!post_messages || latency.empty()) {
+        return;
+      }
+
+      latency.emit();
+    });
+
+    update_filter_params();
+
+    notify_latency = false;
+  }
+
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
 auto DeepFilterNet::get_latency_seconds() -> float {
-  return 0.02F + 1.0F / rate;
+  return latency_value;
 }
@@ -35,6 +35,9 @@ void DeepFilterNetPreset::save(nlohmann::json& json) {
   json[section][instance_name]["max-df-processing-threshold"] = g_settings_get_double(settings, "max-df-processing-threshold");
   json[section][instance_name]["min-processing-buffer"] = g_settings_get_int(settings, "min-processing-buffer");
   json[section][instance_name]["post-filter-beta"] = g_settings_get_double(settings, "post-filter-beta");
+  json[section][instance_name]["enable-gate"] = g_settings_get_boolean(settings, "enable-gate") != 0;
+  json[section][instance_name]["gate-threshold"] = g_settings_get_double(settings, "gate-threshold");
+  json[section][instance_name]["async-mode"] = g_settings_get_boolean(settings, "async-mode") != 0;
 }
 
 void DeepFilterNetPreset::load(const nlohmann::json& json) {
@@ -44,4 +47,7 @@ void DeepFilterNetPreset::load(const nlohmann::json& json) {
   update_key<double>(json.at(section).at(instance_name), settings, "max-df-processing-threshold", "max-df-processing-threshold");
   update_key<int>(json.at(section).at(instance_name), settings, "min-processing-buffer", "min-processing-buffer");
   update_key<double>(json.at(section).at(instance_name), settings, "post-filter-beta", "post-filter-beta");
+  update_key<bool>(json.at(section).at(instance_name), settings, "enable-gate", "enable-gate");
+  update_key<double>(json.at(section).at(instance_name), settings, "gate-threshold", "gate-threshold");
+  update_key<bool>(json.at(section).at(instance_name), settings, "async-mode", "async-mode");
 }
@@ -90,20 +90,14 @@ void Deesser::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, output_gain);
 
   if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
     if (send_notifications) {
       // values needed as double for levelbars widget ui, so we convert them here
 
@@ -0,0 +1,168 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp_load_monitor.hpp"
+#include <algorithm>
+#include <cmath>
+
+std::atomic<uint> DspLoadMonitor::next_id = 1U;
+
+DspLoadMonitor::DspLoadMonitor() : id(next_id.fetch_add(1U)) {}
+
+void DspLoadMonitor::record(const uint64_t& busy_ns, const uint64_t& period_ns) {
+  if (period_ns == 0U) {
+    return;
+  }
+
+  if (reset_requested.exchange(false, std::memory_order_acquire)) {
+    clear();
+  }
+
+  const auto load = static_cast<float>(busy_ns) / static_cast<float>(period_ns);
+
+  const auto bin = std::min(static_cast<uint>(load * 100.0F), n_bins - 1U);
+
+  histogram[bin].fetch_add(1U, std::memory_order_relaxed);
+
+  n_cycles.fetch_add(1U, std::memory_order_relaxed);
+
+  if (busy_ns > period_ns) {
+    n_overruns.fetch_add(1U, std::memory_order_relaxed);
+  }
+
+  total_busy_ns.fetch_add(busy_ns, std::memory_order_relaxed);
+  total_period_ns.fetch_add(period_ns, std::memory_order_relaxed);
+
+  if (load > worst.load(std::memory_order_relaxed)) {
+    worst.store(load, std::memory_order_relaxed);
+  }
+}
+
+void DspLoadMonitor::accumulate(const uint64_t& cycle,
+                                const uint64_t& busy_ns,
+                                const uint64_t& period_ns,
+                                DspLoadMonitor& node) {
+  /*
+    PipeWire runs the nodes of a graph one after the other on its data thread. So the first node of a new cycle is
+    the one that closes the previous cycle.
+  */
+
+  if (cycle != cycle_position) {
+    if (cycle_period_ns != 0U) {
+      record(cycle_busy_ns, cycle_period_ns);
+
+      if (cycle_busy_ns > cycle_period_ns) {
+        overrun_culprit.store(cycle_largest_id, std::memory_order_relaxed);
+        overrun_serial.fetch_add(1U, std::memory_order_release);
+      }
+    }
+
+    cycle_position = cycle;
+    cycle_busy_ns = 0U;
+    cycle_period_ns = period_ns;
+    cycle_largest_ns = 0U;
+    cycle_largest_id = 0U;
+  }
+
+  cycle_busy_ns += busy_ns;
+
+  if (busy_ns > cycle_largest_ns) {
+    cycle_largest_ns = busy_ns;
+    cycle_largest_id = node.id;
+  }
+
+  // Every node runs once per cycle, so each one sees an overrun before the next one can happen.
+
+  const auto serial = overrun_serial.load(std::memory_order_acquire);
+
+  if (serial != node.seen_overrun_serial) {
+    node.seen_overrun_serial = serial;
+
+    if (overrun_culprit.load(std::memory_order_relaxed) == node.id) {
+      node.n_blamed.fetch_add(1U, std::memory_order_relaxed);
+    }
+  }
+}
+
+void DspLoadMonitor::reset() {
+  reset_requested.store(true, std::memory_order_release);
+}
+
+void DspLoadMonitor::clear() {
+  for (auto& bin : histogram) {
+    bin.store(0U, std::memory_order_relaxed);
+  }
+
+  n_cycles.store(0U, std::memory_order_relaxed);
+  n_overruns.store(0U, std::memory_order_relaxed);
+  n_blamed.store(0U, std::memory_order_relaxed);
+
+  total_busy_ns.store(0U, std::memory_order_relaxed);
+  total_period_ns.store(0U, std::memory_order_relaxed);
+
+  worst.store(0.0F, std::memory_order_relaxed);
+}
+
+auto DspLoadMonitor::get_stats() const -> Stats {
+  Stats stats;
+
+  stats.n_cycles = n_cycles.load(std::memory_order_relaxed);
+  stats.n_overruns = n_overruns.load(std::memory_order_relaxed);
+  stats.n_blamed = n_blamed.load(std::memory_order_relaxed);
+  stats.worst = worst.load(std::memory_order_relaxed);
+  stats.busy_ns = total_busy_ns.load(std::memory_order_relaxed);
+
+  const auto period = total_period_ns.load(std::memory_order_relaxed);
+
+  if (period != 0U) {
+    stats.load = static_cast<float>(static_cast<double>(stats.busy_ns) / static_cast<double>(period));
+  }
+
+  // The counts may be a little behind n_cycles while the realtime thread is recording. Their own sum is used.
+
+  std::array<uint32_t, n_bins> counts{};
+
+  uint64_t total = 0U;
+
+  for (uint n = 0U; n < n_bins; n++) {
+    counts[n] = histogram[n].load(std::memory_order_relaxed);
+
+    total += counts[n];
+  }
+
+  if (total != 0U) {
+    const auto target = static_cast<uint64_t>(std::ceil(0.99 * static_cast<double>(total)));
+
+    uint64_t sum = 0U;
+
+    for (uint n = 0U; n < n_bins; n++) {
+      sum += counts[n];
+
+      if (sum >= target) {
+        // upper edge of the bin, but never above the worst value seen
+
+        stats.p99 = (n == n_bins - 1U) ? stats.worst : std::min(static_cast<float>(n + 1U) * 0.01F, stats.worst);
+
+        break;
+      }
+    }
+  }
+
+  return stats;
+}
@@ -18,8 +18,14 @@
  */
 
 #include <glib-unix.h>
+#include <csignal>
+#include <algorithm>
+#include <string_view>
 #include "application.hpp"
 #include "config.h"
+#include "rt_audit.hpp"
+#include "rt_log.hpp"
+#include "tracer.hpp"
 
 auto sigterm(void* data) -> int {
   auto* app = G_APPLICATION(data);
@@ -31,6 +37,18 @@ auto sigterm(void* data) -> int {
   return G_SOURCE_REMOVE;
 }
 
+auto sigusr1([[maybe_unused]] void* data) -> int {
+  // The first signal starts the tracer. The next ones write what was recorded so far.
+
+  if (tracer::is_enabled()) {
+    tracer::dump(tracer::get_output_path());
+  } else {
+    tracer::enable();
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
 auto main(int argc, char* argv[]) -> int {
   util::debug("easyeffects version: " + std::string(VERSION));
 
@@ -49,12 +67,37 @@ auto main(int argc, char* argv[]) -> int {
       return errno;
     }
 
+    /*
+      Offline rendering loads the preset into GSettings. An in-memory backend keeps it away from the settings of the
+      running instance.
+    */
+
+    const auto is_render = [](const char* arg) { return std::string_view(arg).starts_with("--render"); };
+
+    if (std::any_of(argv + 1, argv + argc, is_render)) {
+      g_setenv("GSETTINGS_BACKEND", "memory", 1);
+    }
+
     auto* app = app::application_new();
 
     g_unix_signal_add(2, G_SOURCE_FUNC(sigterm), app);
 
+    g_unix_signal_add(SIGUSR1, G_SOURCE_FUNC(sigusr1), nullptr);
+
+    rt_audit::start();
+
+    rt_log::start();
+
     auto status = g_application_run(app, argc, argv);
 
+    rt_log::stop();
+
+    rt_audit::stop();
+
+    if (tracer::is_enabled()) {
+      tracer::dump(tracer::get_output_path());
+    }
+
     g_object_unref(app);
 
     util::debug("Exitting the main function with status: " + util::to_string(status, ""));
@@ -36,7 +36,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto* self = static_cast<EchoCanceller*>(user_data);
 
-                                            std::scoped_lock<std::mutex> lock(self->data_mutex);
+                                            std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                                             self->filter_length_ms = g_settings_get_int(settings, key);
 
@@ -47,7 +47,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
   gconnections.push_back(g_signal_connect(
       settings, "changed::residual-echo-suppression",
       G_CALLBACK(+[](GSettings* settings, char* key, EchoCanceller* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->residual_echo_suppression = g_settings_get_int(settings, key);
 
@@ -63,7 +63,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 
   gconnections.push_back(g_signal_connect(
       settings, "changed::near-end-suppression", G_CALLBACK(+[](GSettings* settings, char* key, EchoCanceller* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->near_end_suppression = g_settings_get_int(settings, key);
 
@@ -107,7 +107,7 @@ EchoCanceller::~EchoCanceller() {
 }
 
 void EchoCanceller::setup() {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   ready = false;
 
@@ -124,7 +124,7 @@ void EchoCanceller::process(std::span<float>& left_in,
                             std::span<float>& right_out,
                             std::span<float>& probe_left,
                             std::span<float>& probe_right) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass || !ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -133,14 +133,9 @@ void EchoCanceller::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   for (size_t j = 0U; j < left_in.size(); j++) {
-    data_L[j] = static_cast<spx_int16_t>(left_in[j] * (SHRT_MAX + 1));
-    data_R[j] = static_cast<spx_int16_t>(right_in[j] * (SHRT_MAX + 1));
-
     /*
       This is a very naive and not corect attempt to mitigate the shortcomes discussed at
       https://github.com/wwmm/easyeffects/issues/1566.
@@ -149,26 +144,15 @@ void EchoCanceller::process(std::span<float>& left_in,
     probe_mono[j] = static_cast<spx_int16_t>(0.5F * (probe_left[j] + probe_right[j]) * (SHRT_MAX + 1));
   }
 
-  speex_echo_cancellation(echo_state_L, data_L.data(), probe_mono.data(), filtered_L.data());
-  speex_echo_cancellation(echo_state_R, data_R.data(), probe_mono.data(), filtered_R.data());
-
-  speex_preprocess_run(state_left, filtered_L.data());
-  speex_preprocess_run(state_right, filtered_R.data());
-
-  for (size_t j = 0U; j < filtered_L.size(); j++) {
-    left_out[j] = static_cast<float>(filtered_L[j]) * inv_short_max;
+  channel_worker.run([&]() { process_channel(left_in, left_out, data_L, filtered_L, echo_state_L, state_left); },
+                     [&]() { process_channel(right_in, right_out, data_R, filtered_R, echo_state_R, state_right); });
 
-    right_out[j] = static_cast<float>(filtered_R[j]) * inv_short_max;
-  }
-
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     const float latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
 
     util::idle_add([=, this]() {
       if (!post_messages || latency.empty()) {
@@ -183,12 +167,27 @@ void EchoCanceller::process(std::span<float>& left_in,
     notify_latency = false;
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
+  if (post_messages && send_notifications) {
+    notify();
+  }
+}
+
+void EchoCanceller::process_channel(const std::span<float>& in,
+                                    std::span<float>& out,
+                                    std::vector<spx_int16_t>& data,
+                                    std::vector<spx_int16_t>& filtered,
+                                    SpeexEchoState* echo_state,
+                                    SpeexPreprocessState* state) {
+  for (size_t j = 0U; j < in.size(); j++) {
+    data[j] = static_cast<spx_int16_t>(in[j] * (SHRT_MAX + 1));
+  }
+
+  speex_echo_cancellation(echo_state, data.data(), probe_mono.data(), filtered.data());
+
+  speex_preprocess_run(state, filtered.data());
 
-    if (send_notifications) {
-      notify();
-    }
+  for (size_t j = 0U; j < filtered.size(); j++) {
+    out[j] = static_cast<float>(filtered[j]) * inv_short_max;
   }
 }
 
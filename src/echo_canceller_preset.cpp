@@ -40,6 +40,8 @@ void EchoCancellerPreset::save(nlohmann::json& json) {
   json[section][instance_name]["residual-echo-suppression"] = g_settings_get_int(settings, "residual-echo-suppression");
 
   json[section][instance_name]["near-end-suppression"] = g_settings_get_int(settings, "near-end-suppression");
+
+  json[section][instance_name]["parallel-channels"] = g_settings_get_boolean(settings, "parallel-channels") != 0;
 }
 
 void EchoCancellerPreset::load(const nlohmann::json& json) {
@@ -55,4 +57,6 @@ void EchoCancellerPreset::load(const nlohmann::json& json) {
                   "residual-echo-suppression");
 
   update_key<int>(json.at(section).at(instance_name), settings, "near-end-suppression", "near-end-suppression");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "parallel-channels", "parallel-channels");
 }
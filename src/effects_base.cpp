@@ -18,6 +18,7 @@
  */
 
 #include "effects_base.hpp"
+#include <fmt/core.h>
 #include "level_meter.hpp"
 
 EffectsBase::EffectsBase(std::string tag, const std::string& schema, PipeManager* pipe_manager)
@@ -36,6 +37,17 @@ EffectsBase::EffectsBase(std::string tag, const std::string& schema, PipeManager
 
   spectrum = std::make_shared<Spectrum>(log_tag, tags::schema::spectrum::id, tags::app::path + "/spectrum/"s, pm);
 
+  output_level->chain_dsp_load = &dsp_load;
+  spectrum->chain_dsp_load = &dsp_load;
+
+  if (!output_level->connected_to_pw) {
+    output_level->request_connection_to_pw();
+  }
+
+  if (!spectrum->connected_to_pw) {
+    spectrum->request_connection_to_pw();
+  }
+
   if (!output_level->connected_to_pw) {
     output_level->connect_to_pw();
   }
@@ -53,6 +65,16 @@ EffectsBase::EffectsBase(std::string tag, const std::string& schema, PipeManager
                                             self->create_filters_if_necessary();
 
                                             self->broadcast_pipeline_latency();
+
+                                            // a plugin removed from the pipeline does not process anything
+
+                                            const auto list =
+                                                util::gchar_array_to_vector(g_settings_get_strv(settings, key));
+
+                                            if (!self->analyzer_tap_plugin.empty() &&
+                                                std::ranges::find(list, self->analyzer_tap_plugin) == list.end()) {
+                                              self->set_analyzer_tap("", AnalyzerTap::Position::output);
+                                            }
                                           }),
                                           this));
 
@@ -93,6 +115,13 @@ EffectsBase::EffectsBase(std::string tag, const std::string& schema, PipeManager
 }
 
 EffectsBase::~EffectsBase() {
+  output_level->chain_dsp_load = nullptr;
+  spectrum->chain_dsp_load = nullptr;
+
+  for (auto& plugin : plugins | std::views::values) {
+    plugin->chain_dsp_load = nullptr;
+  }
+
   for (auto& c : connections) {
     c.disconnect();
   }
@@ -120,6 +149,122 @@ void EffectsBase::reset_settings() {
   }
 }
 
+void EffectsBase::set_analyzer_tap(const std::string& plugin_name, const AnalyzerTap::Position& position) {
+  if (!analyzer_tap_plugin.empty() && plugins.contains(analyzer_tap_plugin)) {
+    plugins[analyzer_tap_plugin]->detach_analyzer_tap(&spectrum->tap);
+    plugins[analyzer_tap_plugin]->detach_analyzer_tap(&output_level->tap);
+  }
+
+  analyzer_tap_plugin.clear();
+
+  if (plugin_name.empty() || !plugins.contains(plugin_name)) {
+    spectrum->tap.external = false;
+    output_level->tap.external = false;
+
+    util::debug(log_tag + "analyzers moved to the end of the pipeline");
+
+    return;
+  }
+
+  for (auto* tap : {&spectrum->tap, &output_level->tap}) {
+    tap->position = position;
+    tap->external = true;
+
+    plugins[plugin_name]->attach_analyzer_tap(tap);
+  }
+
+  analyzer_tap_plugin = plugin_name;
+
+  util::debug(log_tag + "analyzers moved to the " +
+              ((position == AnalyzerTap::Position::input) ? "input"s : "output"s) + " of " + plugin_name);
+}
+
+auto EffectsBase::get_analyzer_tap_plugin() const -> std::string {
+  return analyzer_tap_plugin;
+}
+
+auto EffectsBase::create_plugin(const std::string& name,
+                                const std::string& log_tag,
+                                const std::string& schema_base_path,
+                                PipeManager* pm) -> std::shared_ptr<PluginBase> {
+  auto instance_id = util::to_string(tags::plugin_name::get_id(name));
+
+  auto path = schema_base_path + tags::plugin_name::get_base_name(name) + "/" + instance_id + "/";
+
+  path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
+
+  std::shared_ptr<PluginBase> filter;
+
+  if (name.starts_with(tags::plugin_name::autogain)) {
+    filter = std::make_shared<AutoGain>(log_tag, tags::schema::autogain::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::bass_enhancer)) {
+    filter = std::make_shared<BassEnhancer>(log_tag, tags::schema::bass_enhancer::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::bass_loudness)) {
+    filter = std::make_shared<BassLoudness>(log_tag, tags::schema::bass_loudness::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::compressor)) {
+    filter = std::make_shared<Compressor>(log_tag, tags::schema::compressor::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::convolver)) {
+    filter = std::make_shared<Convolver>(log_tag, tags::schema::convolver::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::crossfeed)) {
+    filter = std::make_shared<Crossfeed>(log_tag, tags::schema::crossfeed::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::crystalizer)) {
+    filter = std::make_shared<Crystalizer>(log_tag, tags::schema::crystalizer::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::deepfilternet)) {
+    filter = std::make_shared<DeepFilterNet>(log_tag, tags::schema::deepfilternet::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::deesser)) {
+    filter = std::make_shared<Deesser>(log_tag, tags::schema::deesser::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::delay)) {
+    filter = std::make_shared<Delay>(log_tag, tags::schema::delay::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::echo_canceller)) {
+    filter = std::make_shared<EchoCanceller>(log_tag, tags::schema::echo_canceller::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::exciter)) {
+    filter = std::make_shared<Exciter>(log_tag, tags::schema::exciter::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::expander)) {
+    filter = std::make_shared<Expander>(log_tag, tags::schema::expander::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::equalizer)) {
+    filter =
+        std::make_shared<Equalizer>(log_tag, tags::schema::equalizer::id, path, tags::schema::equalizer::channel_id,
+                                    schema_base_path + "equalizer/" + instance_id + "/leftchannel/",
+                                    schema_base_path + "equalizer/" + instance_id + "/rightchannel/", pm);
+  } else if (name.starts_with(tags::plugin_name::filter)) {
+    filter = std::make_shared<Filter>(log_tag, tags::schema::filter::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::gate)) {
+    filter = std::make_shared<Gate>(log_tag, tags::schema::gate::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::level_meter)) {
+    filter = std::make_shared<LevelMeter>(log_tag, tags::schema::level_meter::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::limiter)) {
+    filter = std::make_shared<Limiter>(log_tag, tags::schema::limiter::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::loudness)) {
+    filter = std::make_shared<Loudness>(log_tag, tags::schema::loudness::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::maximizer)) {
+    filter = std::make_shared<Maximizer>(log_tag, tags::schema::maximizer::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::multiband_compressor)) {
+    filter = std::make_shared<MultibandCompressor>(log_tag, tags::schema::multiband_compressor::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::multiband_gate)) {
+    filter = std::make_shared<MultibandGate>(log_tag, tags::schema::multiband_gate::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::pitch)) {
+    filter = std::make_shared<Pitch>(log_tag, tags::schema::pitch::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::reverb)) {
+    filter = std::make_shared<Reverb>(log_tag, tags::schema::reverb::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::rnnoise)) {
+    filter = std::make_shared<RNNoise>(log_tag, tags::schema::rnnoise::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::speex)) {
+    filter = std::make_shared<Speex>(log_tag, tags::schema::speex::id, path, pm);
+  } else if (name.starts_with(tags::plugin_name::stereo_tools)) {
+    filter = std::make_shared<StereoTools>(log_tag, tags::schema::stereo_tools::id, path, pm);
+  }
+
+  return filter;
+}
+
+void EffectsBase::request_filters_connection(const std::vector<std::string>& list) {
+  for (const auto& name : list) {
+    if (plugins.contains(name) && !plugins[name]->connected_to_pw) {
+      plugins[name]->request_connection_to_pw();
+    }
+  }
+}
+
 void EffectsBase::create_filters_if_necessary() {
   const auto list = util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"));
 
@@ -132,75 +277,12 @@ void EffectsBase::create_filters_if_necessary() {
       continue;
     }
 
-    auto instance_id = util::to_string(tags::plugin_name::get_id(name));
-
-    auto path = schema_base_path + tags::plugin_name::get_base_name(name) + "/" + instance_id + "/";
-
-    path.erase(std::remove(path.begin(), path.end(), '_'), path.end());
-
-    std::shared_ptr<PluginBase> filter;
-
-    if (name.starts_with(tags::plugin_name::autogain)) {
-      filter = std::make_shared<AutoGain>(log_tag, tags::schema::autogain::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::bass_enhancer)) {
-      filter = std::make_shared<BassEnhancer>(log_tag, tags::schema::bass_enhancer::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::bass_loudness)) {
-      filter = std::make_shared<BassLoudness>(log_tag, tags::schema::bass_loudness::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::compressor)) {
-      filter = std::make_shared<Compressor>(log_tag, tags::schema::compressor::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::convolver)) {
-      filter = std::make_shared<Convolver>(log_tag, tags::schema::convolver::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::crossfeed)) {
-      filter = std::make_shared<Crossfeed>(log_tag, tags::schema::crossfeed::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::crystalizer)) {
-      filter = std::make_shared<Crystalizer>(log_tag, tags::schema::crystalizer::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::deepfilternet)) {
-      filter = std::make_shared<DeepFilterNet>(log_tag, tags::schema::deepfilternet::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::deesser)) {
-      filter = std::make_shared<Deesser>(log_tag, tags::schema::deesser::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::delay)) {
-      filter = std::make_shared<Delay>(log_tag, tags::schema::delay::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::echo_canceller)) {
-      filter = std::make_shared<EchoCanceller>(log_tag, tags::schema::echo_canceller::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::exciter)) {
-      filter = std::make_shared<Exciter>(log_tag, tags::schema::exciter::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::expander)) {
-      filter = std::make_shared<Expander>(log_tag, tags::schema::expander::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::equalizer)) {
-      filter =
-          std::make_shared<Equalizer>(log_tag, tags::schema::equalizer::id, path, tags::schema::equalizer::channel_id,
-                                      schema_base_path + "equalizer/" + instance_id + "/leftchannel/",
-                                      schema_base_path + "equalizer/" + instance_id + "/rightchannel/", pm);
-    } else if (name.starts_with(tags::plugin_name::filter)) {
-      filter = std::make_shared<Filter>(log_tag, tags::schema::filter::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::gate)) {
-      filter = std::make_shared<Gate>(log_tag, tags::schema::gate::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::level_meter)) {
-      filter = std::make_shared<LevelMeter>(log_tag, tags::schema::level_meter::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::limiter)) {
-      filter = std::make_shared<Limiter>(log_tag, tags::schema::limiter::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::loudness)) {
-      filter = std::make_shared<Loudness>(log_tag, tags::schema::loudness::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::maximizer)) {
-      filter = std::make_shared<Maximizer>(log_tag, tags::schema::maximizer::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::multiband_compressor)) {
-      filter = std::make_shared<MultibandCompressor>(log_tag, tags::schema::multiband_compressor::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::multiband_gate)) {
-      filter = std::make_shared<MultibandGate>(log_tag, tags::schema::multiband_gate::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::pitch)) {
-      filter = std::make_shared<Pitch>(log_tag, tags::schema::pitch::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::reverb)) {
-      filter = std::make_shared<Reverb>(log_tag, tags::schema::reverb::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::rnnoise)) {
-      filter = std::make_shared<RNNoise>(log_tag, tags::schema::rnnoise::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::speex)) {
-      filter = std::make_shared<Speex>(log_tag, tags::schema::speex::id, path, pm);
-    } else if (name.starts_with(tags::plugin_name::stereo_tools)) {
-      filter = std::make_shared<StereoTools>(log_tag, tags::schema::stereo_tools::id, path, pm);
-    }
+    auto filter = create_plugin(name, log_tag, schema_base_path, pm);
 
     connections.push_back(filter->latency.connect([=, this]() { broadcast_pipeline_latency(); }));
 
+    filter->chain_dsp_load = &dsp_load;
+
     plugins.insert(std::make_pair(name, filter));
   }
 }
@@ -252,13 +334,74 @@ auto EffectsBase::get_pipeline_latency() -> float {
 
   for (const auto& name : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"))) {
     if (plugins.contains(name)) {
-      total += plugins[name]->get_latency_seconds();
+      total += plugins[name]->get_latency_seconds() + plugins[name]->get_async_latency_seconds();
     }
   }
 
   return total * 1000.0F;
 }
 
+auto EffectsBase::get_pipeline_plugins() -> std::vector<std::pair<std::string, std::shared_ptr<PluginBase>>> {
+  std::vector<std::pair<std::string, std::shared_ptr<PluginBase>>> list;
+
+  for (const auto& name : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"))) {
+    if (plugins.contains(name)) {
+      list.emplace_back(name, plugins[name]);
+    }
+  }
+
+  return list;
+}
+
+auto EffectsBase::get_dsp_load_report() -> std::string {
+  const auto format_stats = [](const DspLoadMonitor::Stats& stats) {
+    return fmt::format("{0:.1f} % (p99 {1:.1f} %, worst {2:.1f} %, {3} overruns in {4} cycles)", 100.0F * stats.load,
+                       100.0F * stats.p99, 100.0F * stats.worst, stats.n_overruns, stats.n_cycles);
+  };
+
+  const auto translated = tags::plugin_name::get_translated();
+
+  std::string report = "Pipeline: " + format_stats(dsp_load.get_stats()) + "\n";
+
+  std::vector<std::pair<std::string, PluginBase*>> nodes;
+
+  for (const auto& name : util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"))) {
+    if (plugins.contains(name)) {
+      const auto base_name = tags::plugin_name::get_base_name(name);
+
+      nodes.emplace_back(translated.contains(base_name) ? translated.at(base_name) : name, plugins[name].get());
+    }
+  }
+
+  nodes.emplace_back("Spectrum", spectrum.get());
+  nodes.emplace_back("Output Level", output_level.get());
+
+  for (const auto& [label, plugin] : nodes) {
+    const auto stats = plugin->dsp_load.get_stats();
+
+    report += "  " + label + ": " + format_stats(stats);
+
+    if (stats.n_blamed != 0U) {
+      report += fmt::format(", largest part of {0} pipeline overruns", stats.n_blamed);
+    }
+
+    report += "\n";
+  }
+
+  return report;
+}
+
+void EffectsBase::reset_dsp_load() {
+  dsp_load.reset();
+
+  spectrum->dsp_load.reset();
+  output_level->dsp_load.reset();
+
+  for (auto& plugin : plugins | std::views::values) {
+    plugin->dsp_load.reset();
+  }
+}
+
 void EffectsBase::broadcast_pipeline_latency() {
   const auto latency_value = get_pipeline_latency();
 
@@ -41,11 +41,21 @@ struct Data {
 
   float global_output_level_left, global_output_level_right, pipeline_latency_ms;
 
-  std::vector<double> spectrum_mag, spectrum_x_axis, spectrum_freqs;
+  std::vector<double> spectrum_mag, spectrum_x_axis;
+
+  SpectrumMapping spectrum_mapping;
+
+  bool updating_analyzer_taps = false;
+
+  std::vector<std::pair<std::string, AnalyzerTap::Position>> analyzer_taps;  // the dropdown items
+
+  AnalyzerTap::Position analyzer_tap_position = AnalyzerTap::Position::output;
 
   std::vector<sigc::connection> connections;
 
-  std::vector<gulong> gconnections_spectrum;
+  std::vector<gulong> gconnections_spectrum, gconnections_pipeline;
+
+  guint dsp_load_timeout_id = 0U;
 };
 
 struct _EffectsBox {
@@ -57,10 +67,16 @@ struct _EffectsBox {
 
   GtkLabel *device_state, *latency_status, *label_global_output_level_left, *label_global_output_level_right;
 
+  GtkButton* dsp_load_status;
+
   GtkToggleButton* toggle_listen_mic;
 
   GtkMenuButton* menubutton_blocklist;
 
+  GtkDropDown* dropdown_analyzer_tap;
+
+  GtkStringList* analyzer_tap_model;
+
   GtkImage* saturation_icon;
 
   GtkIconTheme* icon_theme;
@@ -73,7 +89,7 @@ struct _EffectsBox {
 
   ui::blocklist_menu::BlocklistMenu* blocklist_menu;
 
-  GSettings *settings_spectrum, *app_settings;
+  GSettings *settings_spectrum, *app_settings, *settings_pipeline;
 
   Data* data;
 };
@@ -82,30 +98,132 @@ struct _EffectsBox {
 G_DEFINE_TYPE(EffectsBox, effects_box, GTK_TYPE_BOX)
 
 void init_spectrum_frequency_axis(EffectsBox* self) {
-  self->data->spectrum_freqs.resize(self->data->spectrum_n_bands);
+  if (self->data->spectrum_n_bands == 0U) {
+    return;
+  }
+
+  const auto min_freq = static_cast<float>(g_settings_get_int(self->settings_spectrum, "minimum-frequency"));
+  const auto max_freq = static_cast<float>(g_settings_get_int(self->settings_spectrum, "maximum-frequency"));
 
-  for (uint n = 0U; n < self->data->spectrum_n_bands; n++) {
-    self->data->spectrum_freqs[n] = 0.5F * static_cast<float>(self->data->spectrum_rate) * static_cast<float>(n) /
-                                    static_cast<float>(self->data->spectrum_n_bands);
+  if (min_freq > (max_freq - 100.0F)) {
+    return;
   }
 
-  if (!self->data->spectrum_freqs.empty()) {
-    const auto min_freq = static_cast<float>(g_settings_get_int(self->settings_spectrum, "minimum-frequency"));
-    const auto max_freq = static_cast<float>(g_settings_get_int(self->settings_spectrum, "maximum-frequency"));
+  auto log_x_axis = util::logspace(min_freq, max_freq, g_settings_get_int(self->settings_spectrum, "n-points"));
 
-    if (min_freq > (max_freq - 100.0F)) {
-      return;
-    }
+  self->data->spectrum_x_axis.resize(log_x_axis.size());
+  self->data->spectrum_mag.resize(log_x_axis.size());
+
+  std::copy(log_x_axis.begin(), log_x_axis.end(), self->data->spectrum_x_axis.begin());
+
+  const auto smoothing =
+      SpectrumMapping::octave_fraction(g_settings_get_enum(self->settings_spectrum, "octave-smoothing"));
+
+  self->data->spectrum_mapping.init(self->data->spectrum_rate, self->data->spectrum_n_bands,
+                                    self->data->spectrum_x_axis, smoothing);
+
+  ui::chart::set_x_data(self->spectrum_chart, self->data->spectrum_x_axis);
+}
+
+void update_waterfall_rows(EffectsBox* self) {
+  const auto interval_ms = std::max(g_settings_get_int(self->app_settings, "meters-update-interval"), 1);
+
+  const auto duration_ms = 1000 * g_settings_get_int(self->settings_spectrum, "waterfall-duration");
+
+  const auto n_frames = std::max(duration_ms / interval_ms, 1);
+
+  // Rows beyond the height of the chart would not be visible. Above that several frames are merged into each row.
+
+  const auto max_rows = std::max(g_settings_get_int(self->settings_spectrum, "height"), 1);
+
+  const auto frames_per_row = (n_frames + max_rows - 1) / max_rows;
+
+  const auto n_rows = (n_frames + frames_per_row - 1) / frames_per_row;
+
+  ui::chart::set_waterfall_rows(self->spectrum_chart, static_cast<uint>(n_rows), static_cast<uint>(frames_per_row));
+}
+
+void update_analyzer_taps(EffectsBox* self) {
+  // One item for the end of the pipeline and then the input and output of every plugin
+
+  const auto translated = tags::plugin_name::get_translated();
+
+  const auto list = util::gchar_array_to_vector(g_settings_get_strv(self->settings_pipeline, "plugins"));
 
-    auto log_x_axis = util::logspace(min_freq, max_freq, g_settings_get_int(self->settings_spectrum, "n-points"));
+  std::vector<std::string> labels = {_("Pipeline Output")};
 
-    self->data->spectrum_x_axis.resize(log_x_axis.size());
-    self->data->spectrum_mag.resize(log_x_axis.size());
+  self->data->analyzer_taps = {{"", AnalyzerTap::Position::output}};
 
-    std::copy(log_x_axis.begin(), log_x_axis.end(), self->data->spectrum_x_axis.begin());
+  for (const auto& name : list) {
+    const auto base_name = tags::plugin_name::get_base_name(name);
 
-    ui::chart::set_x_data(self->spectrum_chart, self->data->spectrum_x_axis);
+    const auto plugin_label = translated.contains(base_name) ? translated.at(base_name) : base_name;
+
+    labels.push_back(plugin_label + " - " + _("Input"));
+    labels.push_back(plugin_label + " - " + _("Output"));
+
+    self->data->analyzer_taps.emplace_back(name, AnalyzerTap::Position::input);
+    self->data->analyzer_taps.emplace_back(name, AnalyzerTap::Position::output);
   }
+
+  std::vector<const char*> items;
+
+  for (const auto& label : labels) {
+    items.push_back(label.c_str());
+  }
+
+  items.push_back(nullptr);
+
+  self->data->updating_analyzer_taps = true;
+
+  gtk_string_list_splice(self->analyzer_tap_model, 0U,
+                         g_list_model_get_n_items(G_LIST_MODEL(self->analyzer_tap_model)), items.data());
+
+  // keeping the current tap selected when it still exists
+
+  const auto current = std::make_pair(self->data->effects_base->get_analyzer_tap_plugin(),
+                                      self->data->analyzer_tap_position);
+
+  const auto it = std::ranges::find(self->data->analyzer_taps, current);
+
+  const auto selected = (it != self->data->analyzer_taps.end() && !current.first.empty())
+                            ? static_cast<guint>(it - self->data->analyzer_taps.begin())
+                            : 0U;
+
+  gtk_drop_down_set_selected(self->dropdown_analyzer_tap, selected);
+
+  self->data->updating_analyzer_taps = false;
+}
+
+void setup_analyzer_taps(EffectsBox* self) {
+  self->settings_pipeline = g_settings_new(
+      (self->data->pipeline_type == PipelineType::input) ? tags::schema::id_input : tags::schema::id_output);
+
+  update_analyzer_taps(self);
+
+  self->data->gconnections_pipeline.push_back(g_signal_connect(
+      self->settings_pipeline, "changed::plugins",
+      G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) { update_analyzer_taps(self); }), self));
+
+  g_signal_connect(self->dropdown_analyzer_tap, "notify::selected",
+                   G_CALLBACK(+[](GtkDropDown* dropdown, GParamSpec* pspec, EffectsBox* self) {
+                     if (self->data->updating_analyzer_taps) {
+                       return;
+                     }
+
+                     const auto selected = gtk_drop_down_get_selected(dropdown);
+
+                     if (selected >= self->data->analyzer_taps.size()) {
+                       return;
+                     }
+
+                     const auto& [name, position] = self->data->analyzer_taps[selected];
+
+                     self->data->analyzer_tap_position = position;
+
+                     self->data->effects_base->set_analyzer_tap(name, position);
+                   }),
+                   self);
 }
 
 void setup_spectrum(EffectsBox* self) {
@@ -152,8 +270,12 @@ void setup_spectrum(EffectsBox* self) {
     ui::chart::set_chart_type(self->spectrum_chart, chart::ChartType::line);
   } else if (chart_type == "Dots") {
     ui::chart::set_chart_type(self->spectrum_chart, chart::ChartType::dots);
+  } else if (chart_type == "Waterfall") {
+    ui::chart::set_chart_type(self->spectrum_chart, chart::ChartType::waterfall);
   }
 
+  update_waterfall_rows(self);
+
   g_settings_bind(self->settings_spectrum, "show", self->spectrum_chart, "visible", G_SETTINGS_BIND_GET);
 
   self->data->gconnections_spectrum.push_back(g_signal_connect(
@@ -207,6 +329,8 @@ void setup_spectrum(EffectsBox* self) {
       self->settings_spectrum, "changed::height", G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
         gtk_widget_set_size_request(GTK_WIDGET(self->spectrum_chart), -1,
                                     g_settings_get_int(self->settings_spectrum, key));
+
+        update_waterfall_rows(self);
       }),
       self));
 
@@ -220,10 +344,18 @@ void setup_spectrum(EffectsBox* self) {
           ui::chart::set_chart_type(self->spectrum_chart, chart::ChartType::line);
         } else if (chart_type == "Dots") {
           ui::chart::set_chart_type(self->spectrum_chart, chart::ChartType::dots);
+        } else if (chart_type == "Waterfall") {
+          ui::chart::set_chart_type(self->spectrum_chart, chart::ChartType::waterfall);
         }
+
+        update_waterfall_rows(self);
       }),
       self));
 
+  self->data->gconnections_spectrum.push_back(g_signal_connect(
+      self->settings_spectrum, "changed::waterfall-duration",
+      G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) { update_waterfall_rows(self); }), self));
+
   self->data->gconnections_spectrum.push_back(g_signal_connect(
       self->settings_spectrum, "changed::n-points", G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
         g_object_ref(self);
@@ -232,6 +364,25 @@ void setup_spectrum(EffectsBox* self) {
       }),
       self));
 
+  self->data->gconnections_spectrum.push_back(g_signal_connect(
+      self->settings_spectrum, "changed::mode", G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
+        gtk_widget_set_tooltip_text(GTK_WIDGET(self->spectrum_chart), nullptr);
+
+        g_object_ref(self);
+
+        util::idle_add([=]() { init_spectrum_frequency_axis(self); }, [=]() { g_object_unref(self); });
+      }),
+      self));
+
+  self->data->gconnections_spectrum.push_back(g_signal_connect(
+      self->settings_spectrum, "changed::octave-smoothing",
+      G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
+        g_object_ref(self);
+
+        util::idle_add([=]() { init_spectrum_frequency_axis(self); }, [=]() { g_object_unref(self); });
+      }),
+      self));
+
   self->data->gconnections_spectrum.push_back(
       g_signal_connect(self->settings_spectrum, "changed::minimum-frequency",
                        G_CALLBACK(+[](GSettings* settings, char* key, EffectsBox* self) {
@@ -261,6 +412,10 @@ void stack_visible_child_changed(EffectsBox* self, GParamSpec* pspec, GtkWidget*
   }
 }
 
+void on_dsp_load_clicked(EffectsBox* self, GtkButton* btn) {
+  self->data->effects_base->reset_dsp_load();
+}
+
 void on_listen_mic_toggled(EffectsBox* self, GtkToggleButton* button) {
   self->data->application->sie->set_listen_to_mic(gtk_toggle_button_get_active(button) != 0);
 }
@@ -330,10 +485,13 @@ void setup(EffectsBox* self, app::Application* application, PipelineType pipelin
   ui::plugins_box::setup(self->pluginsBox, application, pipeline_type);
   ui::blocklist_menu::setup(self->blocklist_menu, application, pipeline_type);
 
+  setup_analyzer_taps(self);
+
   // output level
 
   self->data->connections.push_back(
-      self->data->effects_base->output_level->output_level.connect([=](const float left, const float right) {
+      self->data->effects_base->output_level->output_level.connect([=](const float left, const float right,
+                                                                       const float left_rms, const float right_rms) {
         self->data->global_output_level_left = left;
         self->data->global_output_level_right = right;
 
@@ -380,37 +538,42 @@ void setup(EffectsBox* self, app::Application* application, PipelineType pipelin
           return;
         }
 
-        if (self->data->spectrum_rate != rate || self->data->spectrum_n_bands != n_bands) {
+        if (!self->data->spectrum_mapping.is_valid(rate, n_bands)) {
           self->data->spectrum_rate = rate;
           self->data->spectrum_n_bands = n_bands;
 
           init_spectrum_frequency_axis(self);
         }
 
-        auto* acc = gsl_interp_accel_alloc();
-        auto* spline = gsl_spline_alloc(gsl_interp_steffen, n_bands);
+        self->data->spectrum_mapping.map(magnitudes, self->data->spectrum_mag);
+
+        ui::chart::set_y_data(self->spectrum_chart, self->data->spectrum_mag);
+      }));
+
+  self->data->connections.push_back(self->data->effects_base->spectrum->log_power.connect(
+      [=](std::vector<double> frequencies, std::vector<double> magnitudes, float cost) {
+        if (self == nullptr) {
+          return;
+        }
 
-        gsl_spline_init(spline, self->data->spectrum_freqs.data(), magnitudes.data(), n_bands);
+        if (!ui::chart::get_is_visible(self->spectrum_chart)) {
+          return;
+        }
 
-        for (size_t n = 0; n < self->data->spectrum_x_axis.size(); n++) {
-          self->data->spectrum_mag[n] =
-              static_cast<float>(gsl_spline_eval(spline, self->data->spectrum_x_axis[n], acc));
+        if (!schedule_signal_idle) {
+          return;
         }
 
-        gsl_spline_free(spline);
-        gsl_interp_accel_free(acc);
+        if (frequencies != self->data->spectrum_x_axis) {
+          self->data->spectrum_x_axis = frequencies;
 
-        std::ranges::for_each(self->data->spectrum_mag, [](auto& v) {
-          v = 10.0F * std::log10(v);
+          ui::chart::set_x_data(self->spectrum_chart, self->data->spectrum_x_axis);
+        }
 
-          if (!std::isinf(v)) {
-            v = (v > util::minimum_db_level) ? v : util::minimum_db_level;
-          } else {
-            v = util::minimum_db_level;
-          }
-        });
+        ui::chart::set_y_data(self->spectrum_chart, magnitudes);
 
-        ui::chart::set_y_data(self->spectrum_chart, self->data->spectrum_mag);
+        gtk_widget_set_tooltip_text(GTK_WIDGET(self->spectrum_chart),
+                                    fmt::format(ui::get_user_locale(), "{0:.2Lf} ms", cost).c_str());
       }));
 
   // As we are showing the window we want the filters to send notifications about level meters, etc
@@ -419,6 +582,23 @@ void setup(EffectsBox* self, app::Application* application, PipelineType pipelin
 
   self->data->effects_base->output_level->set_post_messages(true);
 
+  // DSP load. The button shows the load of the whole chain and its tooltip the values of each plugin.
+
+  self->data->dsp_load_timeout_id = g_timeout_add_seconds(
+      1U, GSourceFunc(+[](EffectsBox* self) {
+        const auto stats = self->data->effects_base->dsp_load.get_stats();
+
+        gtk_button_set_label(
+            self->dsp_load_status,
+            fmt::format(ui::get_user_locale(), "{0} {1:.0Lf} %", _("DSP"), 100.0F * stats.load).c_str());
+
+        gtk_widget_set_tooltip_text(GTK_WIDGET(self->dsp_load_status),
+                                    (self->data->effects_base->get_dsp_load_report() + _("Click to reset")).c_str());
+
+        return G_SOURCE_CONTINUE;
+      }),
+      self);
+
   // pipeline latency
 
   gtk_label_set_text(
@@ -468,8 +648,18 @@ void dispose(GObject* object) {
 
   self->data->effects_base->spectrum->bypass = true;
 
+  self->data->effects_base->spectrum->set_post_messages(false);
+
   self->data->effects_base->output_level->set_post_messages(false);
 
+  self->data->effects_base->set_analyzer_tap("", AnalyzerTap::Position::output);
+
+  if (self->data->dsp_load_timeout_id != 0U) {
+    g_source_remove(self->data->dsp_load_timeout_id);
+
+    self->data->dsp_load_timeout_id = 0U;
+  }
+
   for (auto& c : self->data->connections) {
     c.disconnect();
   }
@@ -478,11 +668,17 @@ void dispose(GObject* object) {
     g_signal_handler_disconnect(self->settings_spectrum, handler_id);
   }
 
+  for (auto& handler_id : self->data->gconnections_pipeline) {
+    g_signal_handler_disconnect(self->settings_pipeline, handler_id);
+  }
+
   self->data->connections.clear();
   self->data->gconnections_spectrum.clear();
+  self->data->gconnections_pipeline.clear();
 
   g_object_unref(self->app_settings);
   g_object_unref(self->settings_spectrum);
+  g_object_unref(self->settings_pipeline);
 
   util::debug("disposed");
 
@@ -514,14 +710,18 @@ void effects_box_class_init(EffectsBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, stack);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, device_state);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, latency_status);
+  gtk_widget_class_bind_template_child(widget_class, EffectsBox, dsp_load_status);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, label_global_output_level_left);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, label_global_output_level_right);
+  gtk_widget_class_bind_template_child(widget_class, EffectsBox, dropdown_analyzer_tap);
+  gtk_widget_class_bind_template_child(widget_class, EffectsBox, analyzer_tap_model);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, toggle_listen_mic);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, menubutton_blocklist);
   gtk_widget_class_bind_template_child(widget_class, EffectsBox, saturation_icon);
 
   gtk_widget_class_bind_template_callback(widget_class, stack_visible_child_changed);
   gtk_widget_class_bind_template_callback(widget_class, on_listen_mic_toggled);
+  gtk_widget_class_bind_template_callback(widget_class, on_dsp_load_clicked);
 }
 
 void effects_box_init(EffectsBox* self) {
@@ -555,6 +755,18 @@ void effects_box_init(EffectsBox* self) {
                      self->data->effects_base->spectrum->bypass = true;
                    }),
                    self);
+
+  // The spectrum is only computed while the chart is on screen. Hiding the chart or the window unmaps it.
+
+  g_signal_connect(GTK_WIDGET(self->spectrum_chart), "map", G_CALLBACK(+[](GtkWidget* widget, EffectsBox* self) {
+                     self->data->effects_base->spectrum->set_post_messages(true);
+                   }),
+                   self);
+
+  g_signal_connect(GTK_WIDGET(self->spectrum_chart), "unmap", G_CALLBACK(+[](GtkWidget* widget, EffectsBox* self) {
+                     self->data->effects_base->spectrum->set_post_messages(false);
+                   }),
+                   self);
 }
 
 auto create() -> EffectsBox* {
@@ -81,27 +81,29 @@ void setup(ExciterBox* self, std::shared_ptr<Exciter> exciter, const std::string
 
   exciter->set_post_messages(true);
 
-  self->data->connections.push_back(exciter->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
-
-  self->data->connections.push_back(exciter->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+  self->data->connections.push_back(exciter->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
+
+  self->data->connections.push_back(exciter->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   self->data->connections.push_back(exciter->harmonics.connect([=](const double value) {
     util::idle_add([=]() {
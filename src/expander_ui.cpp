@@ -134,27 +134,29 @@ void setup(ExpanderBox* self, std::shared_ptr<Expander> expander, const std::str
     }
   }
 
-  self->data->connections.push_back(expander->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
-
-  self->data->connections.push_back(expander->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+  self->data->connections.push_back(expander->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
+
+  self->data->connections.push_back(expander->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   self->data->connections.push_back(expander->reduction.connect([=](const float value) {
     util::idle_add([=]() {
@@ -85,27 +85,29 @@ void setup(FilterBox* self, std::shared_ptr<Filter> filter, const std::string& s
 
   filter->set_post_messages(true);
 
-  self->data->connections.push_back(filter->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
-
-  self->data->connections.push_back(filter->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+  self->data->connections.push_back(filter->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
+
+  self->data->connections.push_back(filter->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   gtk_label_set_text(self->plugin_credit, ui::get_plugin_credit_translated(self->data->filter->package).c_str());
 
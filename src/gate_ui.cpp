@@ -136,27 +136,29 @@ void setup(GateBox* self, std::shared_ptr<Gate> gate, const std::string& schema_
     }
   }
 
-  self->data->connections.push_back(gate->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
-
-  self->data->connections.push_back(gate->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+  self->data->connections.push_back(gate->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
+
+  self->data->connections.push_back(gate->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   self->data->connections.push_back(gate->attack_zone_start.connect([=](const float value) {
     util::idle_add([=]() {
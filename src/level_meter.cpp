@@ -25,10 +25,41 @@ LevelMeter::LevelMeter(const std::string& tag,
                        PipeManager* pipe_manager)
     : PluginBase(tag,
                  tags::plugin_name::level_meter,
-                 tags::plugin_package::ebur128,
+                 tags::plugin_package::ee,
                  schema,
                  schema_path,
-                 pipe_manager) {}
+                 pipe_manager) {
+  tap_L.resize(tap_capacity);
+  tap_R.resize(tap_capacity);
+
+  chunk_L.resize(1024U);
+  chunk_R.resize(1024U);
+
+  // every instance has its own log folder. For example "output_0" for the first one in the output pipeline.
+
+  const auto is_output = schema_path.starts_with(tags::schema::level_meter::output_path);
+
+  const std::string prefix = is_output ? tags::schema::level_meter::output_path : tags::schema::level_meter::input_path;
+
+  auto instance =
+      (is_output ? "output_"s : "input_"s) + schema_path.substr(std::min(prefix.size(), schema_path.size()));
+
+  instance.erase(std::remove(instance.begin(), instance.end(), '/'), instance.end());
+
+  log_directory = LoudnessLog::base_directory() / instance;
+
+  analysis_job_id = AnalysisThread::get().add_job([this]() { analyze(); });
+
+  set_log_enabled(g_settings_get_boolean(settings, "log-enabled") != 0);
+
+  gconnections.push_back(g_signal_connect(settings, "changed::log-enabled",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                            auto* self = static_cast<LevelMeter*>(user_data);
+
+                                            self->set_log_enabled(g_settings_get_boolean(settings, key) != 0);
+                                          }),
+                                          this));
+}
 
 LevelMeter::~LevelMeter() {
   if (connected_to_pw) {
@@ -41,49 +72,61 @@ LevelMeter::~LevelMeter() {
 
   mythreads.clear();
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  AnalysisThread::get().remove_job(analysis_job_id);
 
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-  }
+  set_log_enabled(false);
 
   util::debug(log_tag + name + " destroyed");
 }
 
-auto LevelMeter::init_ebur128() -> bool {
+auto LevelMeter::init_meter() -> bool {
   if (n_samples == 0 || rate == 0) {
     return false;
   }
 
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
+  std::scoped_lock<std::mutex> lock(analysis_mutex);
 
-    ebur_state = nullptr;
-  }
+  meter.init(rate);
+
+  // the whole history is kept. The histograms have a fixed size so memory does not grow with it.
 
-  ebur_state = ebur128_init(
-      2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_TRUE_PEAK | EBUR128_MODE_HISTOGRAM);
+  meter.set_max_history(0U);
 
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
+  true_peak_detector_L.reset();
+  true_peak_detector_R.reset();
 
-  return ebur_state != nullptr;
+  true_peak_L = 0.0;
+  true_peak_R = 0.0;
+
+  return true;
 }
 
-void LevelMeter::setup() {
-  if (2U * static_cast<size_t>(n_samples) != data.size()) {
-    data.resize(static_cast<size_t>(n_samples) * 2U);
+void LevelMeter::set_log_enabled(const bool& state) {
+  std::scoped_lock<std::mutex> lock(analysis_mutex);
+
+  log_enabled = state;
+
+  if (state && loudness_log == nullptr) {
+    loudness_log = std::make_unique<LoudnessLog>(log_directory);
+
+    log_true_peak = 0.0F;
+
+    util::debug(log_tag + name + " logging to " + log_directory.string());
+  } else if (!state) {
+    loudness_log.reset();
   }
+}
 
+void LevelMeter::setup() {
   if (rate != old_rate) {
     data_mutex.lock();
 
-    ebur128_ready = false;
+    meter_ready = false;
 
     data_mutex.unlock();
 
     mythreads.emplace_back([this]() {  // Using emplace_back here makes sense
-      if (ebur128_ready) {
+      if (meter_ready) {
         return;
       }
 
@@ -91,11 +134,11 @@ void LevelMeter::setup() {
 
       old_rate = rate;
 
-      status = init_ebur128();
+      status = init_meter();
 
       data_mutex.lock();
 
-      ebur128_ready = status;
+      meter_ready = status;
 
       data_mutex.unlock();
     });
@@ -106,78 +149,144 @@ void LevelMeter::process(std::span<float>& left_in,
                          std::span<float>& right_in,
                          std::span<float>& left_out,
                          std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   std::copy(left_in.begin(), left_in.end(), left_out.begin());
   std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
-  if (bypass || !ebur128_ready) {
+  if (bypass || !meter_ready) {
     return;
   }
 
-  for (size_t n = 0U; n < n_samples; n++) {
-    data[2U * n] = left_in[n];
-    data[2U * n + 1U] = right_in[n];
-  }
+  // nothing is analyzed while no window is showing the results and the log is disabled
 
-  ebur128_add_frames_float(ebur_state, data.data(), n_samples);
+  if (post_messages || log_enabled) {
+    tap_L.push(left_in);
+    tap_R.push(right_in);
 
-  if (EBUR128_SUCCESS != ebur128_loudness_momentary(ebur_state, &momentary)) {
-    momentary = 0.0;
-  }
+    if (post_messages && send_notifications) {
+      frame_due = true;
+    }
 
-  if (EBUR128_SUCCESS != ebur128_loudness_shortterm(ebur_state, &shortterm)) {
-    shortterm = 0.0;
+    AnalysisThread::get().wake();
   }
 
-  if (EBUR128_SUCCESS != ebur128_loudness_global(ebur_state, &global)) {
-    global = 0.0;
-  }
+  if (post_messages) {
+    get_peaks(left_in, right_in, left_out, right_out);
 
-  if (EBUR128_SUCCESS != ebur128_relative_threshold(ebur_state, &relative)) {
-    relative = 0.0;
+    if (send_notifications) {
+      notify();
+    }
   }
+}
 
-  if (EBUR128_SUCCESS != ebur128_loudness_range(ebur_state, &range)) {
-    range = 0.0;
-  }
+void LevelMeter::analyze() {
+  std::scoped_lock<std::mutex> lock(analysis_mutex);
 
-  if (EBUR128_SUCCESS != ebur128_true_peak(ebur_state, 0U, &true_peak_L)) {
-    true_peak_L = 0.0;
+  while (true) {
+    const auto n_read = std::min({tap_L.read_available(), tap_R.read_available(), chunk_L.size()});
+
+    if (n_read == 0U) {
+      break;
+    }
+
+    tap_L.pop(std::span(chunk_L.data(), n_read));
+    tap_R.pop(std::span(chunk_R.data(), n_read));
+
+    const auto span_L = std::span<const float>(chunk_L.data(), n_read);
+    const auto span_R = std::span<const float>(chunk_R.data(), n_read);
+
+    const auto n_blocks = meter.add_frames(span_L, span_R);
+
+    const auto peak_L = true_peak_detector_L.process(span_L);
+    const auto peak_R = true_peak_detector_R.process(span_R);
+
+    // like in libebur128 the true peak is the maximum since the last reset
+
+    true_peak_L = std::max(true_peak_L, static_cast<double>(peak_L));
+    true_peak_R = std::max(true_peak_R, static_cast<double>(peak_R));
+
+    if (loudness_log != nullptr) {
+      log_true_peak = std::max({log_true_peak, peak_L, peak_R});
+
+      // one record per 100 ms block
+
+      if (n_blocks > 0U) {
+        const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+
+        loudness_log->push({.time_ms = now,
+                            .momentary = meter.momentary(),
+                            .shortterm = meter.shortterm(),
+                            .integrated = meter.integrated(),
+                            .range = meter.loudness_range(),
+                            .true_peak = util::linear_to_db(static_cast<double>(log_true_peak))});
+
+        log_true_peak = 0.0F;
+      }
+    }
   }
 
-  if (EBUR128_SUCCESS != ebur128_true_peak(ebur_state, 1U, &true_peak_R)) {
-    true_peak_R = 0.0;
+  // the loudness queries go through the histograms, so they are only done when the UI needs them
+
+  if (!frame_due.exchange(false)) {
+    return;
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
+  momentary = meter.momentary();
+  shortterm = meter.shortterm();
+  global = meter.integrated();
+  relative = meter.relative_threshold();
+  range = meter.loudness_range();
 
-    if (send_notifications) {
-      results.emit(momentary, shortterm, global, relative, range, true_peak_L, true_peak_R);
+  results.emit(momentary, shortterm, global, relative, range, true_peak_L, true_peak_R);
+}
 
-      notify();
-    }
+auto LevelMeter::get_loudness() -> std::optional<Loudness> {
+  if (!post_messages && !log_enabled) {
+    return std::nullopt;
   }
+
+  // Only the analysis thread competes for this mutex. The realtime thread just fills the taps.
+
+  std::scoped_lock<std::mutex> lock(analysis_mutex);
+
+  return Loudness{.momentary = meter.momentary(),
+                  .shortterm = meter.shortterm(),
+                  .integrated = meter.integrated(),
+                  .range = meter.loudness_range(),
+                  .true_peak_L = util::linear_to_db(true_peak_L),
+                  .true_peak_R = util::linear_to_db(true_peak_R)};
 }
 
 auto LevelMeter::get_latency_seconds() -> float {
   return 0.0F;
 }
 
+void LevelMeter::wait_setup() {
+  // the meter is initialized in the threads started by setup()
+
+  for (auto& t : mythreads) {
+    t.join();
+  }
+
+  mythreads.clear();
+}
+
 void LevelMeter::reset_history() {
   mythreads.emplace_back([this]() {  // Using emplace_back here makes sense
     data_mutex.lock();
 
-    ebur128_ready = false;
+    meter_ready = false;
 
     data_mutex.unlock();
 
-    auto status = init_ebur128();
+    auto status = init_meter();
 
     data_mutex.lock();
 
-    ebur128_ready = status;
+    meter_ready = status;
 
     data_mutex.unlock();
   });
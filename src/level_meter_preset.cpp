@@ -30,8 +30,12 @@ LevelMeterPreset::LevelMeterPreset(PresetType preset_type, const int& index)
 
 void LevelMeterPreset::save(nlohmann::json& json) {
   json[section][instance_name]["bypass"] = g_settings_get_boolean(settings, "bypass") != 0;
+
+  json[section][instance_name]["log-enabled"] = g_settings_get_boolean(settings, "log-enabled") != 0;
 }
 
 void LevelMeterPreset::load(const nlohmann::json& json) {
   update_key<bool>(json.at(section).at(instance_name), settings, "bypass", "bypass");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "log-enabled", "log-enabled");
 }
@@ -47,6 +47,8 @@ struct _LevelMeterBox {
 
   GtkButton* reset_history;
 
+  GtkSwitch* log_enabled;
+
   GSettings* settings;
 
   Data* data;
@@ -78,16 +80,19 @@ void setup(LevelMeterBox* self, std::shared_ptr<LevelMeter> level_meter, const s
 
   level_meter->set_post_messages(true);
 
-  self->data->connections.push_back(level_meter->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
+  gsettings_bind_widgets<"log-enabled">(self->settings, self->log_enabled);
+
+  self->data->connections.push_back(level_meter->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
 
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   self->data->connections.push_back(level_meter->results.connect(
       [=](const double momentary, const double shortterm, const double integrated, const double relative,
@@ -181,6 +186,7 @@ void level_meter_box_class_init(LevelMeterBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, LevelMeterBox, plugin_credit);
 
   gtk_widget_class_bind_template_child(widget_class, LevelMeterBox, reset_history);
+  gtk_widget_class_bind_template_child(widget_class, LevelMeterBox, log_enabled);
 
   gtk_widget_class_bind_template_child(widget_class, LevelMeterBox, m_level);
   gtk_widget_class_bind_template_child(widget_class, LevelMeterBox, s_level);
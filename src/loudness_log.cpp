@@ -0,0 +1,338 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "loudness_log.hpp"
+#include <fcntl.h>
+#include <glib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <utility>
+#include "util.hpp"
+
+namespace {
+
+constexpr int64_t day_ms = 86400000;
+
+constexpr auto n_records = static_cast<uint32_t>(day_ms / LoudnessLog::record_interval_ms);
+
+constexpr std::array<char, 8> magic = {'E', 'E', 'L', 'O', 'U', 'D', '0', '2'};
+
+struct Header {
+  std::array<char, 8> magic;
+
+  uint32_t record_interval_ms;
+
+  uint32_t n_records;
+};
+
+static_assert(sizeof(Header) == 16U);
+
+auto valid_header(const Header& header) -> bool {
+  return header.magic == magic && header.record_interval_ms == LoudnessLog::record_interval_ms &&
+         header.n_records == n_records;
+}
+
+auto encode_loudness(const double& value) -> uint16_t {
+  if (std::isnan(value)) {
+    return 0U;
+  }
+
+  // -inf is stored as the smallest value so it can be told apart from a missing record
+
+  return static_cast<uint16_t>(std::clamp(std::lrint((value + 600.0) * 100.0), 1L, 65535L));
+}
+
+auto decode_loudness(const uint16_t& value) -> double {
+  return (value <= 1U) ? -HUGE_VAL : static_cast<double>(value) / 100.0 - 600.0;
+}
+
+auto encode_true_peak(const double& value) -> int16_t {
+  if (!std::isfinite(value)) {
+    return (value > 0.0) ? 32767 : -32767;
+  }
+
+  return static_cast<int16_t>(std::clamp(std::lrint(value * 10.0), -32766L, 32767L));
+}
+
+auto decode_true_peak(const int16_t& value) -> double {
+  return (value <= -32767) ? -HUGE_VAL : static_cast<double>(value) / 10.0;
+}
+
+}  // namespace
+
+LoudnessLog::LoudnessLog(std::filesystem::path directory) : directory(std::move(directory)) {
+  queue.resize(600U);
+
+  writer = std::thread([this]() { loop(); });
+}
+
+LoudnessLog::~LoudnessLog() {
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    stop = true;
+  }
+
+  cv.notify_one();
+
+  writer.join();
+
+  if (fd != -1) {
+    close(fd);
+  }
+}
+
+auto LoudnessLog::base_directory() -> std::filesystem::path {
+  return std::filesystem::path(g_get_user_data_dir()) / "easyeffects" / "loudness_log";
+}
+
+void LoudnessLog::push(const Entry& entry) {
+  queue.push(std::span<const Entry>(&entry, 1U));
+}
+
+void LoudnessLog::loop() {
+  std::vector<Entry> entries(queue.capacity());
+
+  while (true) {
+    bool done = false;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      cv.wait_for(lock, std::chrono::seconds(1), [this]() { return stop; });
+
+      done = stop;
+    }
+
+    const auto n = queue.pop(entries);
+
+    for (size_t i = 0U; i < n; i++) {
+      write(entries[i]);
+    }
+
+    if (done) {
+      break;
+    }
+  }
+}
+
+void LoudnessLog::write(const Entry& entry) {
+  if (entry.time_ms < 0) {
+    return;
+  }
+
+  const auto day = entry.time_ms / day_ms;
+
+  if (day != file_day && !open_day(day)) {
+    return;
+  }
+
+  const auto record = encode(entry);
+
+  const auto offset = static_cast<off_t>(sizeof(Header)) +
+                      static_cast<off_t>(sizeof(Record)) * ((entry.time_ms % day_ms) / record_interval_ms);
+
+  if (pwrite(fd, &record, sizeof(Record), offset) != sizeof(Record)) {
+    util::warning("could not write to the loudness log: " + std::string(std::strerror(errno)));
+  }
+}
+
+auto LoudnessLog::open_day(const int64_t& day) -> bool {
+  if (fd != -1) {
+    close(fd);
+
+    fd = -1;
+  }
+
+  file_day = day;
+
+  std::error_code error;
+
+  std::filesystem::create_directories(directory, error);
+
+  const auto path = directory / file_name(day);
+
+  fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+  if (fd == -1) {
+    util::warning("could not open the loudness log " + path.string());
+
+    return false;
+  }
+
+  struct stat info {};
+
+  fstat(fd, &info);
+
+  if (info.st_size == 0) {
+    // A new file. Its full size is reserved right away so every record has a fixed place.
+
+    const Header header{.magic = magic, .record_interval_ms = record_interval_ms, .n_records = n_records};
+
+    if (pwrite(fd, &header, sizeof(Header), 0) != sizeof(Header) ||
+        ftruncate(fd, static_cast<off_t>(sizeof(Header) + sizeof(Record) * n_records)) != 0) {
+      util::warning("could not initialize the loudness log " + path.string());
+
+      close(fd);
+
+      fd = -1;
+
+      return false;
+    }
+
+    util::debug("created the loudness log " + path.string());
+
+    return true;
+  }
+
+  Header header{};
+
+  if (pread(fd, &header, sizeof(Header), 0) != sizeof(Header) || !valid_header(header)) {
+    util::warning(path.string() + " is not a loudness log. Nothing will be written to it");
+
+    close(fd);
+
+    fd = -1;
+
+    return false;
+  }
+
+  return true;
+}
+
+auto LoudnessLog::read(const std::filesystem::path& directory, const int64_t& start_ms, const int64_t& end_ms)
+    -> std::vector<Entry> {
+  std::vector<Entry> entries;
+
+  if (start_ms < 0 || end_ms < start_ms) {
+    return entries;
+  }
+
+  for (auto day = start_ms / day_ms; day <= end_ms / day_ms; day++) {
+    const auto path = directory / file_name(day);
+
+    const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1) {
+      continue;
+    }
+
+    struct stat info {};
+
+    fstat(fd, &info);
+
+    const auto file_size = sizeof(Header) + sizeof(Record) * n_records;
+
+    if (static_cast<size_t>(info.st_size) != file_size) {
+      util::warning(path.string() + " has an unexpected size. It will be ignored");
+
+      close(fd);
+
+      continue;
+    }
+
+    auto* map = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (map == MAP_FAILED) {
+      continue;
+    }
+
+    const auto* header = static_cast<const Header*>(map);
+
+    if (valid_header(*header)) {
+      const auto* records = reinterpret_cast<const Record*>(static_cast<const char*>(map) + sizeof(Header));
+
+      const auto day_start = day * day_ms;
+
+      const auto first = std::max(start_ms, day_start) - day_start;
+      const auto last = std::min(end_ms, day_start + day_ms - 1) - day_start;
+
+      for (auto n = first / record_interval_ms; n <= last / record_interval_ms; n++) {
+        if (records[n].momentary != 0U) {
+          entries.push_back(decode(records[n], day_start + n * record_interval_ms));
+        }
+      }
+    } else {
+      util::warning(path.string() + " is not a loudness log. It will be ignored");
+    }
+
+    munmap(map, file_size);
+  }
+
+  return entries;
+}
+
+void LoudnessLog::write_csv(const std::vector<Entry>& entries, std::ostream& stream) {
+  stream << "time,momentary,shortterm,integrated,range,true_peak\n";
+
+  for (const auto& e : entries) {
+    const auto seconds = static_cast<time_t>(e.time_ms / 1000);
+
+    std::tm utc{};
+
+    gmtime_r(&seconds, &utc);
+
+    std::array<char, 32> date{};
+
+    std::strftime(date.data(), date.size(), "%Y-%m-%dT%H:%M:%S", &utc);
+
+    stream << date.data() << "." << (e.time_ms % 1000) / 100 << "Z," << e.momentary << "," << e.shortterm << ","
+           << e.integrated << "," << e.range << "," << e.true_peak << "\n";
+  }
+}
+
+auto LoudnessLog::encode(const Entry& entry) -> Record {
+  return {.momentary = encode_loudness(entry.momentary),
+          .shortterm = encode_loudness(entry.shortterm),
+          .integrated = encode_loudness(entry.integrated),
+          .range = static_cast<uint16_t>(std::clamp(std::lrint(entry.range * 10.0), 0L, 65535L)),
+          .true_peak = encode_true_peak(entry.true_peak)};
+}
+
+auto LoudnessLog::decode(const Record& record, const int64_t& time_ms) -> Entry {
+  return {.time_ms = time_ms,
+          .momentary = decode_loudness(record.momentary),
+          .shortterm = decode_loudness(record.shortterm),
+          .integrated = decode_loudness(record.integrated),
+          .range = static_cast<double>(record.range) / 10.0,
+          .true_peak = decode_true_peak(record.true_peak)};
+}
+
+auto LoudnessLog::file_name(const int64_t& day) -> std::string {
+  const auto seconds = static_cast<time_t>(day * (day_ms / 1000));
+
+  std::tm utc{};
+
+  gmtime_r(&seconds, &utc);
+
+  std::array<char, 16> name{};
+
+  std::strftime(name.data(), name.size(), "%Y-%m-%d", &utc);
+
+  return std::string(name.data()) + ".bin";
+}
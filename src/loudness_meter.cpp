@@ -0,0 +1,337 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "loudness_meter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+void LoudnessMeter::init(const uint& rate) {
+  this->rate = rate;
+
+  block_size = std::max(static_cast<uint>(std::lrint(0.1 * static_cast<double>(rate))), 1U);
+
+  /*
+    K-weighting coefficients computed for the current rate. The constants are the ones that give the filters of
+    ITU-R BS.1770 at 48 kHz. First a high shelf modeling the head and then the RLB high pass.
+  */
+
+  const auto r = static_cast<double>(rate);
+
+  auto f0 = 1681.974450955533;
+  auto q = 0.7071752369554196;
+  auto k = std::tan(std::numbers::pi * f0 / r);
+
+  const auto vh = std::pow(10.0, 3.999843853973347 / 20.0);
+  const auto vb = std::pow(vh, 0.4996667741545416);
+
+  auto a0 = 1.0 + k / q + k * k;
+
+  filters[0].b = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0};
+  filters[0].a = {2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = std::tan(std::numbers::pi * f0 / r);
+
+  a0 = 1.0 + k / q + k * k;
+
+  filters[1].b = {1.0, -2.0, 1.0};
+  filters[1].a = {2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+
+  reset();
+}
+
+void LoudnessMeter::set_max_history(const uint& seconds) {
+  integrated_histogram.resize(10U * seconds);
+  range_histogram.resize(10U * seconds);
+}
+
+void LoudnessMeter::reset() {
+  for (auto& f : filters) {
+    f.s1 = {};
+    f.s2 = {};
+  }
+
+  block_fill = 0U;
+  block_energy = 0.0;
+  n_finished_blocks = 0U;
+
+  recent_blocks = {};
+  recent_pos = 0U;
+
+  momentary_energy = 0.0;
+  shortterm_energy = 0.0;
+
+  integrated_histogram.clear();
+  range_histogram.clear();
+}
+
+auto LoudnessMeter::add_frames(const std::span<const float>& left, const std::span<const float>& right) -> uint {
+  if (block_size == 0U) {
+    return 0U;
+  }
+
+  uint n_finished = 0U;
+
+  // working on local copies lets the compiler keep the filter state in registers
+
+  auto f = filters;
+
+  auto energy = block_energy;
+
+  const auto n_frames = std::min(left.size(), right.size());
+
+  for (size_t n = 0U; n < n_frames; n++) {
+    std::array<double, 2> x = {left[n], right[n]};
+
+    for (auto& stage : f) {
+      for (size_t c = 0U; c < 2U; c++) {
+        const auto y = stage.b[0] * x[c] + stage.s1[c];
+
+        stage.s1[c] = stage.b[1] * x[c] - stage.a[0] * y + stage.s2[c];
+        stage.s2[c] = stage.b[2] * x[c] - stage.a[1] * y;
+
+        x[c] = y;
+      }
+    }
+
+    energy += x[0] * x[0] + x[1] * x[1];
+
+    if (++block_fill == block_size) {
+      block_energy = energy;
+
+      finish_block();
+
+      energy = 0.0;
+
+      n_finished++;
+    }
+  }
+
+  filters = f;
+
+  block_energy = energy;
+
+  return n_finished;
+}
+
+void LoudnessMeter::finish_block() {
+  recent_blocks[recent_pos] = block_energy / static_cast<double>(block_size);
+
+  recent_pos = (recent_pos + 1U) % n_shortterm_blocks;
+
+  block_fill = 0U;
+  block_energy = 0.0;
+
+  n_finished_blocks = std::min(n_finished_blocks + 1U, n_shortterm_blocks);
+
+  // Both windows end at the block that has just finished. The sums have a fixed length so there is no drift.
+
+  momentary_energy = 0.0;
+
+  for (uint n = 1U; n <= n_momentary_blocks; n++) {
+    momentary_energy += recent_blocks[(recent_pos + n_shortterm_blocks - n) % n_shortterm_blocks];
+  }
+
+  momentary_energy /= static_cast<double>(n_momentary_blocks);
+
+  shortterm_energy = 0.0;
+
+  for (const auto& e : recent_blocks) {
+    shortterm_energy += e;
+  }
+
+  shortterm_energy /= static_cast<double>(n_shortterm_blocks);
+
+  // 400 ms gating blocks with 75% overlap for the integrated loudness and 3 s ones for the loudness range
+
+  if (n_finished_blocks >= n_momentary_blocks && energy_to_loudness(momentary_energy) >= absolute_gate) {
+    integrated_histogram.add(momentary_energy);
+  }
+
+  if (n_finished_blocks >= n_shortterm_blocks && energy_to_loudness(shortterm_energy) >= absolute_gate) {
+    range_histogram.add(shortterm_energy);
+  }
+}
+
+auto LoudnessMeter::momentary() const -> double {
+  return energy_to_loudness(momentary_energy);
+}
+
+auto LoudnessMeter::shortterm() const -> double {
+  return energy_to_loudness(shortterm_energy);
+}
+
+auto LoudnessMeter::integrated() const -> double {
+  const auto& h = integrated_histogram;
+
+  if (h.n_blocks == 0U) {
+    return -HUGE_VAL;
+  }
+
+  uint count = 0U;
+
+  double energy = 0.0;
+
+  for (auto n = h.gate(-10.0); n < static_cast<int>(n_bins); n++) {
+    count += h.count[n];
+    energy += h.energy[n];
+  }
+
+  if (count == 0U) {
+    return -HUGE_VAL;
+  }
+
+  return energy_to_loudness(energy / static_cast<double>(count));
+}
+
+auto LoudnessMeter::relative_threshold() const -> double {
+  const auto& h = integrated_histogram;
+
+  if (h.n_blocks == 0U) {
+    return absolute_gate;
+  }
+
+  return energy_to_loudness(h.total_energy / static_cast<double>(h.n_blocks)) - 10.0;
+}
+
+auto LoudnessMeter::loudness_range() const -> double {
+  const auto& h = range_histogram;
+
+  if (h.n_blocks == 0U) {
+    return 0.0;
+  }
+
+  const auto start = h.gate(-20.0);
+
+  uint count = 0U;
+
+  for (auto n = start; n < static_cast<int>(n_bins); n++) {
+    count += h.count[n];
+  }
+
+  if (count == 0U) {
+    return 0.0;
+  }
+
+  // 10th and 95th percentiles of the gated short term loudness distribution
+
+  const auto lower_index = static_cast<uint>(std::lrint(0.1 * static_cast<double>(count - 1U)));
+  const auto upper_index = static_cast<uint>(std::lrint(0.95 * static_cast<double>(count - 1U)));
+
+  double lower = 0.0;
+  double upper = 0.0;
+
+  uint seen = 0U;
+
+  for (auto n = start; n < static_cast<int>(n_bins); n++) {
+    if (h.count[n] == 0U) {
+      continue;
+    }
+
+    const auto center = absolute_gate + (static_cast<double>(n) + 0.5) * histogram_step;
+
+    if (seen <= lower_index && lower_index < seen + h.count[n]) {
+      lower = center;
+    }
+
+    if (seen <= upper_index && upper_index < seen + h.count[n]) {
+      upper = center;
+
+      break;
+    }
+
+    seen += h.count[n];
+  }
+
+  return upper - lower;
+}
+
+auto LoudnessMeter::energy_to_loudness(const double& energy) -> double {
+  if (energy <= 0.0) {
+    return -HUGE_VAL;
+  }
+
+  return -0.691 + 10.0 * std::log10(energy);
+}
+
+auto LoudnessMeter::loudness_to_bin(const double& loudness) -> int {
+  const auto n = static_cast<int>(std::floor((loudness - absolute_gate) / histogram_step));
+
+  return std::clamp(n, 0, static_cast<int>(n_bins) - 1);
+}
+
+void LoudnessMeter::Histogram::clear() {
+  count.fill(0U);
+  energy.fill(0.0);
+
+  n_blocks = 0U;
+  total_energy = 0.0;
+
+  ring_pos = 0U;
+  ring_size = 0U;
+}
+
+void LoudnessMeter::Histogram::resize(const uint& capacity) {
+  ring_bin.resize(capacity);
+  ring_energy.resize(capacity);
+
+  clear();
+}
+
+void LoudnessMeter::Histogram::add(const double& block_energy) {
+  const auto capacity = static_cast<uint>(ring_bin.size());
+
+  if (capacity != 0U && ring_size == capacity) {
+    // dropping the oldest block
+
+    const auto old_bin = ring_bin[ring_pos];
+
+    count[old_bin]--;
+    n_blocks--;
+
+    energy[old_bin] = (count[old_bin] == 0U) ? 0.0 : energy[old_bin] - ring_energy[ring_pos];
+
+    total_energy = (n_blocks == 0U) ? 0.0 : total_energy - ring_energy[ring_pos];
+  } else if (capacity != 0U) {
+    ring_size++;
+  }
+
+  const auto bin = loudness_to_bin(energy_to_loudness(block_energy));
+
+  count[bin]++;
+  energy[bin] += block_energy;
+
+  n_blocks++;
+  total_energy += block_energy;
+
+  if (capacity != 0U) {
+    ring_bin[ring_pos] = bin;
+    ring_energy[ring_pos] = block_energy;
+
+    ring_pos = (ring_pos + 1U) % capacity;
+  }
+}
+
+auto LoudnessMeter::Histogram::gate(const double& relative_lu) const -> int {
+  const auto threshold = energy_to_loudness(total_energy / static_cast<double>(n_blocks)) + relative_lu;
+
+  return loudness_to_bin(threshold);
+}
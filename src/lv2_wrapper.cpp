@@ -18,6 +18,9 @@
  */
 
 #include "lv2_wrapper.hpp"
+#include <future>
+#include "rt_log.hpp"
+#include "startup_timer.hpp"
 
 namespace lv2 {
 
@@ -26,6 +29,52 @@ constexpr auto max_quantum = 8192;
 
 using namespace std::string_literals;
 
+namespace {
+
+/*
+  Lilv is not thread safe and it loads the data of a plugin into the world the first time it is queried. Every call
+  that may read or load plugin data of the shared world has to hold this mutex. The realtime thread never takes it.
+*/
+
+std::mutex world_mutex;
+
+/*
+  Instantiating a plugin and freeing an instance only touch the list of open libraries of the world. create_instance()
+  runs on the realtime thread, so it must not wait for world_mutex while the main thread loads bundle data.
+*/
+
+std::mutex library_mutex;
+
+std::once_flag world_flag;
+
+std::shared_future<std::shared_ptr<LilvWorld>> world_future;
+
+auto load_world() -> std::shared_ptr<LilvWorld> {
+  const startup_timer::Phase phase("lv2 discovery");
+
+  auto* world = lilv_world_new();
+
+  if (world == nullptr) {
+    return nullptr;
+  }
+
+  lilv_world_load_all(world);
+
+  return {world, lilv_world_free};
+}
+
+auto get_world() -> std::shared_ptr<LilvWorld> {
+  preload_world();
+
+  return world_future.get();
+}
+
+}  // namespace
+
+void preload_world() {
+  std::call_once(world_flag, []() { world_future = std::async(std::launch::async, load_world).share(); });
+}
+
 auto lv2_printf(LV2_Log_Handle handle, LV2_URID type, const char* format, ...) -> int {
   va_list args;
 
@@ -38,13 +87,16 @@ auto lv2_printf(LV2_Log_Handle handle, LV2_URID type, const char* format, ...) -
   return r;
 }
 
-Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri) : plugin_uri(plugin_uri), world(lilv_world_new()) {
+Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri)
+    : plugin_uri(plugin_uri), shared_world(get_world()), world(shared_world.get()) {
   if (world == nullptr) {
     util::warning("failed to initialized the world");
 
     return;
   }
 
+  std::scoped_lock<std::mutex> lock(world_mutex);
+
   auto* const uri = lilv_new_uri(world, plugin_uri.c_str());
 
   if (uri == nullptr) {
@@ -53,8 +105,6 @@ Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri) : plugin_uri(plugin_uri),
     return;
   }
 
-  lilv_world_load_all(world);
-
   const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
 
   plugin = lilv_plugins_get_by_uri(plugins, uri);
@@ -72,19 +122,22 @@ Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri) : plugin_uri(plugin_uri),
   check_required_features();
 
   create_ports();
+
+  // Resolved here so that lilv_plugin_instantiate() finds it cached and does not query the world.
+
+  lilv_plugin_get_library_uri(plugin);
 }
 
 Lv2Wrapper::~Lv2Wrapper() {
   if (instance != nullptr) {
     lilv_instance_deactivate(instance);
+
+    std::scoped_lock<std::mutex> lock(library_mutex);
+
     lilv_instance_free(instance);
 
     instance = nullptr;
   }
-
-  if (world != nullptr) {
-    lilv_world_free(world);
-  }
 }
 
 void Lv2Wrapper::check_required_features() {
@@ -192,6 +245,8 @@ auto Lv2Wrapper::create_instance(const uint& rate) -> bool {
   if (instance != nullptr) {
     deactivate();
 
+    std::scoped_lock<std::mutex> lock(library_mutex);
+
     lilv_instance_free(instance);
 
     instance = nullptr;
@@ -234,7 +289,11 @@ auto Lv2Wrapper::create_instance(const uint& rate) -> bool {
   const auto features = std::to_array<const LV2_Feature*>(
       {&lv2_log_feature, &lv2_map_feature, &lv2_unmap_feature, &feature_options, static_features.data(), nullptr});
 
-  instance = lilv_plugin_instantiate(plugin, rate, features.data());
+  {
+    std::scoped_lock<std::mutex> lock(library_mutex);
+
+    instance = lilv_plugin_instantiate(plugin, rate, features.data());
+  }
 
   if (instance == nullptr) {
     util::warning("failed to instantiate " + plugin_uri);
@@ -402,7 +461,9 @@ auto Lv2Wrapper::get_control_port_value(const std::string& symbol) -> float {
     }
   }
 
-  util::warning(plugin_uri + " port symbol not found: " + symbol);
+  // This one is also called from process()
+
+  rt_log::warning("{} port symbol not found: {}", plugin_uri, symbol);
 
   return 0.0F;
 }
@@ -436,7 +497,13 @@ void Lv2Wrapper::load_ui() {
         return;
       }
 
-      LilvUIs* uis = lilv_plugin_get_uis(plugin);
+      LilvUIs* uis = nullptr;
+
+      {
+        std::scoped_lock<std::mutex> lock(world_mutex);
+
+        uis = lilv_plugin_get_uis(plugin);
+      }
 
       if (uis == nullptr) {
         return;
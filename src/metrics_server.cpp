@@ -0,0 +1,354 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "metrics_server.hpp"
+#include <fmt/core.h>
+#include <gio/gunixsocketaddress.h>
+#include <unistd.h>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include "level_meter.hpp"
+#include "startup_timer.hpp"
+#include "tags_app.hpp"
+
+namespace {
+
+// One metric with all its samples. The help and type lines are only written once per metric, as required.
+struct Family {
+  const char* name;
+
+  const char* help;
+
+  const char* type;
+
+  std::vector<std::pair<std::string, double>> samples;
+};
+
+auto format_value(const double& value) -> std::string {
+  if (std::isnan(value)) {
+    return "NaN";
+  }
+
+  if (std::isinf(value)) {
+    return (value > 0.0) ? "+Inf" : "-Inf";
+  }
+
+  return fmt::format("{}", value);
+}
+
+auto resident_memory_bytes() -> double {
+  // The second field of statm is the resident set size in pages
+
+  std::ifstream statm("/proc/self/statm");
+
+  uint64_t size = 0U, resident = 0U;
+
+  if (!(statm >> size >> resident)) {
+    return 0.0;
+  }
+
+  return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE));
+}
+
+}  // namespace
+
+MetricsServer::MetricsServer(EffectsBase* output_effects, EffectsBase* input_effects)
+    : settings(g_settings_new(tags::app::id)), soe(output_effects), sie(input_effects) {
+  start_socket();
+  start_file_writer();
+
+  gconnections.push_back(g_signal_connect(settings, "changed::metrics-socket",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                            auto* self = static_cast<MetricsServer*>(user_data);
+
+                                            self->stop_socket();
+                                            self->start_socket();
+                                          }),
+                                          this));
+
+  for (const auto* key : {"changed::metrics-file", "changed::metrics-file-interval"}) {
+    gconnections.push_back(g_signal_connect(settings, key,
+                                            G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                              auto* self = static_cast<MetricsServer*>(user_data);
+
+                                              self->stop_file_writer();
+                                              self->start_file_writer();
+                                            }),
+                                            this));
+  }
+}
+
+MetricsServer::~MetricsServer() {
+  for (auto& handler_id : gconnections) {
+    g_signal_handler_disconnect(settings, handler_id);
+  }
+
+  gconnections.clear();
+
+  stop_file_writer();
+  stop_socket();
+
+  g_object_unref(settings);
+}
+
+void MetricsServer::start_socket() {
+  const auto path_setting = util::gsettings_get_string(settings, "metrics-socket");
+
+  if (path_setting.empty()) {
+    return;
+  }
+
+  socket_path = path_setting;
+
+  if (socket_path.is_relative()) {
+    socket_path = std::filesystem::path(g_get_user_runtime_dir()) / socket_path;
+  }
+
+  // A socket left behind by a previous instance would make the bind fail
+
+  if (std::filesystem::is_socket(socket_path)) {
+    std::filesystem::remove(socket_path);
+  }
+
+  service = g_socket_service_new();
+
+  auto* address = g_unix_socket_address_new(socket_path.c_str());
+
+  GError* error = nullptr;
+
+  g_socket_listener_add_address(G_SOCKET_LISTENER(service), address, G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT,
+                                nullptr, nullptr, &error);
+
+  g_object_unref(address);
+
+  if (error != nullptr) {
+    util::warning("could not listen on " + socket_path.string() + ": " + error->message);
+
+    g_error_free(error);
+
+    g_object_unref(service);
+
+    service = nullptr;
+
+    return;
+  }
+
+  g_signal_connect(service, "incoming",
+                   G_CALLBACK(+[](GSocketService* service, GSocketConnection* connection, GObject* source_object,
+                                  gpointer user_data) {
+                     auto* self = static_cast<MetricsServer*>(user_data);
+
+                     const auto text = self->snapshot();
+
+                     auto* output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+
+                     g_output_stream_write_all(output, text.data(), text.size(), nullptr, nullptr, nullptr);
+
+                     g_io_stream_close(G_IO_STREAM(connection), nullptr, nullptr);
+
+                     return 1;
+                   }),
+                   this);
+
+  g_socket_service_start(service);
+
+  util::debug("serving metrics on " + socket_path.string());
+}
+
+void MetricsServer::stop_socket() {
+  if (service == nullptr) {
+    return;
+  }
+
+  g_socket_service_stop(service);
+  g_socket_listener_close(G_SOCKET_LISTENER(service));
+
+  g_object_unref(service);
+
+  service = nullptr;
+
+  std::filesystem::remove(socket_path);
+}
+
+void MetricsServer::start_file_writer() {
+  if (util::gsettings_get_string(settings, "metrics-file").empty()) {
+    return;
+  }
+
+  const auto interval = static_cast<guint>(g_settings_get_int(settings, "metrics-file-interval"));
+
+  file_timeout_id = g_timeout_add_seconds(interval, GSourceFunc(+[](gpointer user_data) {
+                                            static_cast<MetricsServer*>(user_data)->write_file();
+
+                                            return G_SOURCE_CONTINUE;
+                                          }),
+                                          this);
+}
+
+void MetricsServer::stop_file_writer() {
+  if (file_timeout_id != 0U) {
+    g_source_remove(file_timeout_id);
+
+    file_timeout_id = 0U;
+  }
+}
+
+void MetricsServer::write_file() {
+  const auto path = util::gsettings_get_string(settings, "metrics-file");
+
+  const auto text = snapshot();
+
+  // Written to a temporary file and renamed, so scrapers never see half of a snapshot
+
+  GError* error = nullptr;
+
+  if (g_file_set_contents(path.c_str(), text.data(), static_cast<gssize>(text.size()), &error) == 0) {
+    util::warning("could not write the metrics to " + path + ": " + error->message);
+
+    g_error_free(error);
+  }
+}
+
+auto MetricsServer::snapshot() -> std::string {
+  Family chain_load{"easyeffects_chain_dsp_load", "Average fraction of the quantum period used by the chain", "gauge"};
+  Family chain_p99{"easyeffects_chain_dsp_load_p99", "99th percentile of the chain DSP load", "gauge"};
+  Family chain_worst{"easyeffects_chain_dsp_load_worst", "Largest chain DSP load seen", "gauge"};
+  Family chain_seconds{"easyeffects_chain_dsp_seconds_total", "Time spent processing by the chain", "counter"};
+  Family chain_cycles{"easyeffects_chain_cycles_total", "Graph cycles processed by the chain", "counter"};
+  Family chain_overruns{"easyeffects_chain_overruns_total", "Cycles in which the chain took longer than the quantum",
+                        "counter"};
+  Family chain_jumps{"easyeffects_chain_clock_jumps_total",
+                     "Cycles in which the graph clock did not continue from the previous one. Includes xruns and "
+                     "suspends",
+                     "counter"};
+  Family chain_latency{"easyeffects_chain_latency_seconds", "Latency added by the plugins of the chain", "gauge"};
+  Family chain_quantum{"easyeffects_chain_quantum_frames", "Current graph quantum", "gauge"};
+  Family chain_rate{"easyeffects_chain_rate_hertz", "Current graph sampling rate", "gauge"};
+
+  Family plugin_load{"easyeffects_plugin_dsp_load", "Average fraction of the quantum period used by the plugin",
+                     "gauge"};
+  Family plugin_p99{"easyeffects_plugin_dsp_load_p99", "99th percentile of the plugin DSP load", "gauge"};
+  Family plugin_worst{"easyeffects_plugin_dsp_load_worst", "Largest plugin DSP load seen", "gauge"};
+  Family plugin_seconds{"easyeffects_plugin_dsp_seconds_total", "Time spent processing by the plugin", "counter"};
+  Family plugin_overruns{"easyeffects_plugin_overruns_total", "Cycles in which the plugin took longer than the quantum",
+                         "counter"};
+  Family plugin_blamed{"easyeffects_plugin_blamed_overruns_total",
+                       "Chain overruns in which the plugin took the largest part of the cycle", "counter"};
+  Family plugin_async_overruns{"easyeffects_plugin_async_overruns_total",
+                               "Cycles in which the async worker of the plugin was not done in time", "counter"};
+  Family plugin_latency{"easyeffects_plugin_latency_seconds", "Latency added by the plugin", "gauge"};
+
+  Family loudness{"easyeffects_loudness_lufs", "Loudness measured by the Level Meter", "gauge"};
+  Family loudness_range{"easyeffects_loudness_range_lu", "Loudness range measured by the Level Meter", "gauge"};
+  Family true_peak{"easyeffects_true_peak_dbtp", "True peak measured by the Level Meter", "gauge"};
+
+  Family memory{"easyeffects_resident_memory_bytes", "Resident set size of the process", "gauge"};
+
+  Family startup_phases{"easyeffects_startup_phase_seconds", "Duration of each startup phase", "gauge"};
+  Family first_audio{"easyeffects_first_audio_seconds",
+                     "Time from the start of the process to the first buffer processed by the effects chains", "gauge"};
+
+  for (const auto& [chain, effects] : {std::pair{"output", soe}, std::pair{"input", sie}}) {
+    const auto chain_label = fmt::format("chain=\"{}\"", chain);
+
+    const auto stats = effects->dsp_load.get_stats();
+
+    chain_load.samples.emplace_back(chain_label, stats.load);
+    chain_p99.samples.emplace_back(chain_label, stats.p99);
+    chain_worst.samples.emplace_back(chain_label, stats.worst);
+    chain_seconds.samples.emplace_back(chain_label, static_cast<double>(stats.busy_ns) * 1e-9);
+    chain_cycles.samples.emplace_back(chain_label, stats.n_cycles);
+    chain_overruns.samples.emplace_back(chain_label, stats.n_overruns);
+    chain_latency.samples.emplace_back(chain_label, 0.001 * effects->get_pipeline_latency());
+
+    // The output level meter is always in the chain, so it sees the same clock as the chain
+
+    const auto& meter = effects->output_level;
+
+    chain_jumps.samples.emplace_back(chain_label, meter->n_clock_jumps.load(std::memory_order_relaxed));
+    chain_quantum.samples.emplace_back(chain_label, meter->graph_quantum.load(std::memory_order_relaxed));
+    chain_rate.samples.emplace_back(chain_label, meter->graph_rate.load(std::memory_order_relaxed));
+
+    for (const auto& [name, plugin] : effects->get_pipeline_plugins()) {
+      const auto label = fmt::format("{},plugin=\"{}\"", chain_label, name);
+
+      const auto plugin_stats = plugin->dsp_load.get_stats();
+
+      plugin_load.samples.emplace_back(label, plugin_stats.load);
+      plugin_p99.samples.emplace_back(label, plugin_stats.p99);
+      plugin_worst.samples.emplace_back(label, plugin_stats.worst);
+      plugin_seconds.samples.emplace_back(label, static_cast<double>(plugin_stats.busy_ns) * 1e-9);
+      plugin_overruns.samples.emplace_back(label, plugin_stats.n_overruns);
+      plugin_blamed.samples.emplace_back(label, plugin_stats.n_blamed);
+      plugin_async_overruns.samples.emplace_back(label, plugin->async_overruns.load(std::memory_order_relaxed));
+      plugin_latency.samples.emplace_back(label,
+                                          plugin->get_latency_seconds() + plugin->get_async_latency_seconds());
+
+      if (!name.starts_with(tags::plugin_name::level_meter)) {
+        continue;
+      }
+
+      if (const auto values = std::dynamic_pointer_cast<LevelMeter>(plugin)->get_loudness()) {
+        loudness.samples.emplace_back(label + ",window=\"momentary\"", values->momentary);
+        loudness.samples.emplace_back(label + ",window=\"shortterm\"", values->shortterm);
+        loudness.samples.emplace_back(label + ",window=\"integrated\"", values->integrated);
+
+        loudness_range.samples.emplace_back(label, values->range);
+
+        true_peak.samples.emplace_back(label + ",channel=\"left\"", values->true_peak_L);
+        true_peak.samples.emplace_back(label + ",channel=\"right\"", values->true_peak_R);
+      }
+    }
+  }
+
+  memory.samples.emplace_back("", resident_memory_bytes());
+
+  for (const auto& record : startup_timer::get_phases()) {
+    startup_phases.samples.emplace_back(fmt::format("phase=\"{}\"", record.name), record.end - record.start);
+  }
+
+  if (const auto seconds = startup_timer::get_first_audio_seconds(); seconds >= 0.0) {
+    first_audio.samples.emplace_back("", seconds);
+  }
+
+  std::string text;
+
+  const std::array families{
+      &chain_load,   &chain_p99,      &chain_worst,     &chain_seconds, &chain_cycles,          &chain_overruns,
+      &chain_jumps,  &chain_latency,  &chain_quantum,   &chain_rate,    &plugin_load,           &plugin_p99,
+      &plugin_worst, &plugin_seconds, &plugin_overruns, &plugin_blamed, &plugin_async_overruns, &plugin_latency,
+      &loudness,     &loudness_range, &true_peak,       &memory,        &startup_phases,        &first_audio};
+
+  for (const auto* family : families) {
+    if (family->samples.empty()) {
+      continue;
+    }
+
+    text += fmt::format("# HELP {} {}\n# TYPE {} {}\n", family->name, family->help, family->name, family->type);
+
+    for (const auto& [labels, value] : family->samples) {
+      text += labels.empty() ? fmt::format("{} {}\n", family->name, format_value(value))
+                             : fmt::format("{}{{{}}} {}\n", family->name, labels, format_value(value));
+    }
+  }
+
+  return text;
+}
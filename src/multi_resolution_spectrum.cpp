@@ -0,0 +1,221 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "multi_resolution_spectrum.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+MultiResolutionSpectrum::MultiResolutionSpectrum(const uint& rate,
+                                                 const uint& fft_size,
+                                                 const std::vector<double>& x_axis,
+                                                 const double& smoothing)
+    : rate(rate), fft_size(fft_size), x_axis(x_axis) {
+  const auto n_bins = fft_size / 2U + 1U;
+
+  // https://en.wikipedia.org/wiki/Hann_function
+
+  window.resize(fft_size);
+
+  for (uint n = 0U; n < fft_size; n++) {
+    window[n] = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
+                                        static_cast<float>(fft_size - 1U)));
+  }
+
+  // Blackman windowed half band lowpass. Every other coefficient except the central one is zero.
+
+  taps.resize(n_taps);
+
+  const auto center = static_cast<int>(n_taps - 1U) / 2;
+
+  for (uint n = 0U; n < n_taps; n++) {
+    const auto m = static_cast<int>(n) - center;
+
+    const auto w = 0.42 - 0.5 * std::cos(2.0 * std::numbers::pi * n / (n_taps - 1U)) +
+                   0.08 * std::cos(4.0 * std::numbers::pi * n / (n_taps - 1U));
+
+    if (m == 0) {
+      taps[n] = 0.5F;
+    } else if (m % 2 == 0) {
+      taps[n] = 0.0F;
+    } else {
+      taps[n] = static_cast<float>(w * std::sin(0.5 * std::numbers::pi * m) / (std::numbers::pi * m));
+    }
+  }
+
+  for (uint k = 0U; k < n_levels; k++) {
+    auto level = std::make_unique<Level>();
+
+    level->history.resize(fft_size, 0.0F);
+    level->delay.resize(n_taps, 0.0F);
+    level->real_input.resize(fft_size, 0.0F);
+    level->power.resize(n_bins, 0.0);
+
+    level->complex_output = fftwf_alloc_complex(n_bins);
+
+    level->plan = fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), level->real_input.data(), level->complex_output,
+                                        FFTW_ESTIMATE);
+
+    levels.push_back(std::move(level));
+  }
+
+  // choosing the level of each display point
+
+  const auto ratio = (x_axis.size() > 1U) ? x_axis[1] / x_axis[0] : 2.0;
+
+  const auto relative_bandwidth = std::sqrt(ratio) - 1.0 / std::sqrt(ratio);
+
+  for (uint n = 0U; n < x_axis.size(); n++) {
+    const auto f = x_axis[n];
+
+    uint chosen = 0U;
+
+    for (uint k = 0U; k < n_levels; k++) {
+      const auto level_rate = static_cast<double>(rate) / static_cast<double>(1U << k);
+
+      // above 0.45 * level_rate we would be looking at the transition band of the decimation filter
+
+      if (f > 0.45 * level_rate) {
+        break;
+      }
+
+      chosen = k;
+
+      if (level_rate / static_cast<double>(fft_size) <= f * relative_bandwidth) {
+        break;
+      }
+    }
+
+    levels[chosen]->points.push_back(n);
+  }
+
+  for (uint k = 0U; k < n_levels; k++) {
+    auto& level = *levels[k];
+
+    std::vector<double> level_axis;
+
+    level_axis.reserve(level.points.size());
+
+    for (const auto& p : level.points) {
+      level_axis.push_back(x_axis[p]);
+    }
+
+    level.mapping.init(rate >> k, n_bins, level_axis, smoothing);
+  }
+}
+
+MultiResolutionSpectrum::~MultiResolutionSpectrum() {
+  for (auto& level : levels) {
+    if (level->plan != nullptr) {
+      fftwf_destroy_plan(level->plan);
+    }
+
+    if (level->complex_output != nullptr) {
+      fftwf_free(level->complex_output);
+    }
+  }
+}
+
+void MultiResolutionSpectrum::add_samples(const std::span<const float>& mono) {
+  for (const auto& sample : mono) {
+    auto v = sample;
+
+    for (uint k = 0U; k < n_levels; k++) {
+      auto& level = *levels[k];
+
+      level.history[level.history_pos] = v;
+
+      if (++level.history_pos == fft_size) {
+        level.history_pos = 0U;
+      }
+
+      if (k + 1U == n_levels) {
+        break;
+      }
+
+      level.delay[level.delay_pos] = v;
+
+      if (++level.delay_pos == n_taps) {
+        level.delay_pos = 0U;
+      }
+
+      level.odd = !level.odd;
+
+      // only every second sample goes down to the next level
+
+      if (level.odd) {
+        break;
+      }
+
+      float y = 0.0F;
+
+      for (uint n = 0U; n < n_taps; n++) {
+        y += taps[n] * level.delay[(level.delay_pos + n) % n_taps];
+      }
+
+      v = y;
+    }
+  }
+}
+
+void MultiResolutionSpectrum::compute(std::vector<double>& output_db) {
+  output_db.resize(x_axis.size());
+
+  for (auto& level_ptr : levels) {
+    auto& level = *level_ptr;
+
+    if (level.points.empty()) {
+      continue;
+    }
+
+    const auto n_tail = fft_size - level.history_pos;
+
+    for (uint n = 0U; n < n_tail; n++) {
+      level.real_input[n] = level.history[level.history_pos + n] * window[n];
+    }
+
+    for (uint n = n_tail; n < fft_size; n++) {
+      level.real_input[n] = level.history[n - n_tail] * window[n];
+    }
+
+    fftwf_execute(level.plan);
+
+    const auto norm = static_cast<double>(level.power.size() * level.power.size());
+
+    for (uint i = 0U; i < level.power.size(); i++) {
+      level.power[i] = static_cast<double>(level.complex_output[i][0] * level.complex_output[i][0] +
+                                           level.complex_output[i][1] * level.complex_output[i][1]) /
+                       norm;
+    }
+
+    level.mapping.map(level.power, level.mapped_db);
+
+    for (uint n = 0U; n < level.points.size(); n++) {
+      output_db[level.points[n]] = level.mapped_db[n];
+    }
+  }
+}
+
+auto MultiResolutionSpectrum::get_rate() const -> uint {
+  return rate;
+}
+
+auto MultiResolutionSpectrum::get_frequencies() const -> const std::vector<double>& {
+  return x_axis;
+}
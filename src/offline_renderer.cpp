@@ -0,0 +1,427 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "offline_renderer.hpp"
+#include <sndfile.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sndfile.hh>
+#include <span>
+#include <thread>
+#include <utility>
+#include "effects_base.hpp"
+#include "resampler.hpp"
+#include "tags_schema.hpp"
+#include "util.hpp"
+
+namespace {
+
+auto output_format(const int& input_format, const uint& rate) -> int {
+  // The container of the input is kept, but with float samples when it allows them so nothing is quantized again.
+
+  SF_INFO info{};
+
+  info.samplerate = static_cast<int>(rate);
+  info.channels = 2;
+
+  for (const auto format : {(input_format & SF_FORMAT_TYPEMASK) | SF_FORMAT_FLOAT, input_format}) {
+    info.format = format;
+
+    if (sf_format_check(&info) != 0) {
+      return format;
+    }
+  }
+
+  return SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+}
+
+}  // namespace
+
+OfflineRenderer::OfflineRenderer(const PresetType& preset_type, const Options& options) : options(options) {
+  const std::string schema = (preset_type == PresetType::output) ? tags::schema::id_output : tags::schema::id_input;
+
+  schema_base_path = "/" + schema + "/";
+
+  std::replace(schema_base_path.begin(), schema_base_path.end(), '.', '/');
+
+  auto* settings = g_settings_new(schema.c_str());
+
+  plugin_names = util::gchar_array_to_vector(g_settings_get_strv(settings, "plugins"));
+
+  g_object_unref(settings);
+
+  this->options.quantum = std::max(this->options.quantum, 1U);
+}
+
+auto OfflineRenderer::create_chain() const -> Chain {
+  Chain chain;
+
+  for (const auto& name : plugin_names) {
+    if (auto plugin = EffectsBase::create_plugin(name, log_tag, schema_base_path, nullptr); plugin != nullptr) {
+      chain.push_back(plugin);
+    }
+  }
+
+  return chain;
+}
+
+auto OfflineRenderer::prepare_chain(const uint& rate) const -> Chain {
+  auto chain = create_chain();
+
+  for (auto& plugin : chain) {
+    plugin->prepare_offline(rate, options.quantum);
+  }
+
+  return chain;
+}
+
+void OfflineRenderer::release_chain(Chain& chain) {
+  while (g_main_context_iteration(nullptr, 0) != 0) {
+  }
+
+  chain.clear();
+}
+
+auto OfflineRenderer::render_rate(const std::filesystem::path& input) const -> uint {
+  if (options.rate != 0U) {
+    return options.rate;
+  }
+
+  SndfileHandle file(input.string());
+
+  return (file.error() == SF_ERR_NO_ERROR) ? static_cast<uint>(file.samplerate()) : 0U;
+}
+
+auto OfflineRenderer::render(const std::filesystem::path& input, const std::filesystem::path& output) -> bool {
+  if (std::filesystem::is_directory(input)) {
+    return render_directory(input, output);
+  }
+
+  auto chain = prepare_chain(render_rate(input));
+
+  const auto success = render_file(chain, input, output);
+
+  release_chain(chain);
+
+  return success;
+}
+
+auto OfflineRenderer::render_directory(const std::filesystem::path& input_dir, const std::filesystem::path& output_dir)
+    -> bool {
+  std::vector<std::filesystem::path> files;
+
+  for (const auto& entry : std::filesystem::directory_iterator(input_dir)) {
+    if (!entry.is_regular_file()) {
+      continue;
+    }
+
+    if (SndfileHandle file(entry.path().string()); file.error() != SF_ERR_NO_ERROR) {
+      util::debug(log_tag + "skipping " + entry.path().string() + ": " + file.strError());
+
+      continue;
+    }
+
+    files.push_back(entry.path());
+  }
+
+  if (files.empty()) {
+    util::warning(log_tag + "no audio files in " + input_dir.string());
+
+    return false;
+  }
+
+  std::ranges::sort(files);
+
+  std::error_code error;
+
+  std::filesystem::create_directories(output_dir, error);
+
+  if (error) {
+    util::warning(log_tag + "could not create " + output_dir.string() + ": " + error.message());
+
+    return false;
+  }
+
+  const auto max_threads = (options.n_threads != 0U) ? options.n_threads : std::thread::hardware_concurrency();
+
+  const auto n_threads = std::clamp(static_cast<size_t>(max_threads), static_cast<size_t>(1U), files.size());
+
+  /*
+    The plugins connect to GSettings and load their LV2 bundles in the constructor, and some of them finish setup()
+    in an idle callback. So this thread creates and prepares a new chain for every file, hands it to a worker that only
+    runs the DSP and destroys it when the worker gives it back. No state is carried from one file to the next.
+  */
+
+  struct Job {
+    size_t file = 0U;
+
+    Chain chain;
+  };
+
+  std::mutex jobs_mutex;
+  std::condition_variable jobs_cv;
+
+  std::deque<Job> queued, rendered;
+
+  bool stop = false;
+
+  std::atomic<bool> success = true;
+
+  std::vector<std::thread> workers;
+
+  for (size_t n = 0U; n < n_threads; n++) {
+    workers.emplace_back([&, this]() {
+      while (true) {
+        Job job;
+
+        {
+          std::unique_lock<std::mutex> lock(jobs_mutex);
+
+          jobs_cv.wait(lock, [&] { return stop || !queued.empty(); });
+
+          if (queued.empty()) {
+            return;
+          }
+
+          job = std::move(queued.front());
+
+          queued.pop_front();
+        }
+
+        if (!render_file(job.chain, files[job.file], output_dir / files[job.file].filename())) {
+          success = false;
+        }
+
+        std::scoped_lock<std::mutex> lock(jobs_mutex);
+
+        rendered.push_back(std::move(job));
+
+        jobs_cv.notify_all();
+      }
+    });
+  }
+
+  size_t next_file = 0U;
+  size_t n_in_flight = 0U;
+
+  while (next_file < files.size() || n_in_flight > 0U) {
+    // One chain waiting in the queue per worker is enough to keep them busy while the next one is prepared.
+
+    if (next_file < files.size() && n_in_flight < 2U * n_threads) {
+      Job job{.file = next_file, .chain = prepare_chain(render_rate(files[next_file]))};
+
+      next_file++;
+      n_in_flight++;
+
+      std::scoped_lock<std::mutex> lock(jobs_mutex);
+
+      queued.push_back(std::move(job));
+
+      jobs_cv.notify_all();
+
+      continue;
+    }
+
+    std::deque<Job> done;
+
+    {
+      std::unique_lock<std::mutex> lock(jobs_mutex);
+
+      jobs_cv.wait(lock, [&] { return !rendered.empty(); });
+
+      done.swap(rendered);
+    }
+
+    for (auto& job : done) {
+      release_chain(job.chain);
+
+      n_in_flight--;
+    }
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(jobs_mutex);
+
+    stop = true;
+
+    jobs_cv.notify_all();
+  }
+
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return success;
+}
+
+auto OfflineRenderer::render_file(Chain& chain,
+                                  const std::filesystem::path& input,
+                                  const std::filesystem::path& output) const -> bool {
+  SndfileHandle in_file(input.string());
+
+  if (in_file.error() != SF_ERR_NO_ERROR || in_file.channels() <= 0) {
+    util::warning(log_tag + "could not open " + input.string() + ": " + in_file.strError());
+
+    return false;
+  }
+
+  const auto file_rate = static_cast<uint>(in_file.samplerate());
+  const auto rate = (options.rate != 0U) ? options.rate : file_rate;
+  const auto n_channels = static_cast<size_t>(in_file.channels());
+  const auto quantum = static_cast<size_t>(options.quantum);
+
+  SndfileHandle out_file(output.string(), SFM_WRITE, output_format(in_file.format(), rate), 2, static_cast<int>(rate));
+
+  if (out_file.error() != SF_ERR_NO_ERROR) {
+    util::warning(log_tag + "could not create " + output.string() + ": " + out_file.strError());
+
+    return false;
+  }
+
+  std::unique_ptr<Resampler> resampler;
+
+  if (rate != file_rate) {
+    resampler = std::make_unique<Resampler>(file_rate, rate, 2);
+  }
+
+  std::vector<float> file_buffer(quantum * n_channels), file_left(quantum), file_right(quantum);
+
+  // frames already at the render rate waiting to fill a block
+  std::vector<float> pending_left, pending_right;
+
+  std::vector<float> left_a(quantum), right_a(quantum), left_b(quantum), right_b(quantum);
+
+  std::vector<float> output_buffer(2U * quantum);
+
+  size_t n_frames_in = 0U;   // input frames given to the chain
+  size_t n_frames_out = 0U;  // frames written to the output file
+  size_t n_skip = 0U;        // latency frames that still have to be dropped
+
+  bool end_of_input = false;
+  bool latency_measured = false;
+
+  const auto t_start = std::chrono::steady_clock::now();
+
+  // After the end of the input the chain is fed silence until the frames held back by its latency come out.
+
+  while (!end_of_input || !pending_left.empty() || n_frames_out < n_frames_in) {
+    while (!end_of_input && pending_left.size() < quantum) {
+      const auto n = static_cast<size_t>(in_file.readf(file_buffer.data(), static_cast<sf_count_t>(quantum)));
+
+      end_of_input = n < quantum;
+
+      // mono files go to both channels and only the first two channels of multichannel files are used
+
+      for (size_t i = 0U; i < n; i++) {
+        file_left[i] = file_buffer[i * n_channels];
+        file_right[i] = file_buffer[i * n_channels + ((n_channels > 1U) ? 1U : 0U)];
+      }
+
+      const auto l = std::span(file_left.data(), n);
+      const auto r = std::span(file_right.data(), n);
+
+      if (resampler != nullptr) {
+        resampler->process(l, r, end_of_input);
+
+        pending_left.insert(pending_left.end(), resampler->get_output_left().begin(),
+                            resampler->get_output_left().end());
+
+        pending_right.insert(pending_right.end(), resampler->get_output_right().begin(),
+                             resampler->get_output_right().end());
+      } else {
+        pending_left.insert(pending_left.end(), l.begin(), l.end());
+        pending_right.insert(pending_right.end(), r.begin(), r.end());
+      }
+    }
+
+    // The chain was prepared for a single block size, so the last block is padded instead of shortened.
+
+    const auto n_valid = std::min(pending_left.size(), quantum);
+
+    std::copy_n(pending_left.begin(), n_valid, left_a.begin());
+    std::copy_n(pending_right.begin(), n_valid, right_a.begin());
+
+    std::fill(left_a.begin() + static_cast<std::ptrdiff_t>(n_valid), left_a.end(), 0.0F);
+    std::fill(right_a.begin() + static_cast<std::ptrdiff_t>(n_valid), right_a.end(), 0.0F);
+
+    pending_left.erase(pending_left.begin(), pending_left.begin() + static_cast<std::ptrdiff_t>(n_valid));
+    pending_right.erase(pending_right.begin(), pending_right.begin() + static_cast<std::ptrdiff_t>(n_valid));
+
+    n_frames_in += n_valid;
+
+    std::span<float> left_in = left_a;
+    std::span<float> right_in = right_a;
+    std::span<float> left_out = left_b;
+    std::span<float> right_out = right_b;
+
+    for (auto& plugin : chain) {
+      plugin->process_offline(left_in, right_in, left_out, right_out, rate);
+
+      // the output of this plugin is the input of the next one
+
+      std::swap(left_in, left_out);
+      std::swap(right_in, right_out);
+    }
+
+    if (!latency_measured) {
+      float latency = 0.0F;
+
+      for (auto& plugin : chain) {
+        latency += plugin->get_latency_seconds();
+      }
+
+      n_skip = static_cast<size_t>(std::lrint(latency * static_cast<float>(rate)));
+
+      latency_measured = true;
+
+      util::debug(log_tag + input.filename().string() + " chain latency: " + util::to_string(n_skip) + " frames");
+    }
+
+    const auto offset = std::min(n_skip, quantum);
+
+    n_skip -= offset;
+
+    const auto n_write = std::min(quantum - offset, n_frames_in - n_frames_out);
+
+    for (size_t i = 0U; i < n_write; i++) {
+      output_buffer[2U * i] = left_in[offset + i];
+      output_buffer[2U * i + 1U] = right_in[offset + i];
+    }
+
+    out_file.writef(output_buffer.data(), static_cast<sf_count_t>(n_write));
+
+    n_frames_out += n_write;
+  }
+
+  const auto elapsed =
+      std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - t_start).count();
+
+  const auto duration = static_cast<double>(n_frames_out) / static_cast<double>(rate);
+
+  util::info(log_tag + "rendered " + output.string() + ": " + util::to_string(duration, "") + " s of audio in " +
+             util::to_string(elapsed, "") + " s (" + util::to_string(duration / std::max(elapsed, 1e-9), "") +
+             "x real time)");
+
+  return true;
+}
@@ -19,17 +19,41 @@
 
 #include "output_level.hpp"
 
+namespace {
+
+void store_max(std::atomic<float>& target, const float& value) {
+  auto current = target.load();
+
+  while (value > current && !target.compare_exchange_weak(current, value)) {
+  }
+}
+
+}  // namespace
+
 OutputLevel::OutputLevel(const std::string& tag,
                          const std::string& schema,
                          const std::string& schema_path,
                          PipeManager* pipe_manager)
-    : PluginBase(tag, "output_level", tags::plugin_package::ee, schema, schema_path, pipe_manager) {}
+    : PluginBase(tag, "output_level", tags::plugin_package::ee, schema, schema_path, pipe_manager) {
+  tap_L.resize(4096U);
+  tap_R.resize(4096U);
+
+  true_peak_tap_L.resize(16384U);
+  true_peak_tap_R.resize(16384U);
+
+  chunk_L.resize(1024U);
+  chunk_R.resize(1024U);
+
+  analysis_job_id = AnalysisThread::get().add_job([this]() { analyze(); });
+}
 
 OutputLevel::~OutputLevel() {
   if (connected_to_pw) {
     disconnect_from_pw();
   }
 
+  AnalysisThread::get().remove_job(analysis_job_id);
+
   util::debug(log_tag + name + " destroyed");
 }
 
@@ -45,12 +69,65 @@ void OutputLevel::process(std::span<float>& left_in,
   std::copy(left_in.begin(), left_in.end(), left_out.begin());
   std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
+  if (tap.external) {
+    // the tapped plugin runs earlier in the same graph cycle, so everything it wrote is measured here
+
+    while (true) {
+      const auto n = std::min({tap.left.read_available(), tap.right.read_available(), tap_L.size()});
 
-    if (send_notifications) {
-      notify();
+      if (n == 0U) {
+        break;
+      }
+
+      std::span<float> l(tap_L.data(), n);
+      std::span<float> r(tap_R.data(), n);
+
+      tap.left.pop(l);
+      tap.right.pop(r);
+
+      measure(l, r);
     }
+  } else if (post_messages) {
+    measure(left_out, right_out);
+  }
+
+  if (post_messages && send_notifications) {
+    // the analysis thread may still be working on the last samples. Their true peak goes to the next notification.
+
+    const auto peak_L = true_peak_L.exchange(0.0F);
+    const auto peak_R = true_peak_R.exchange(0.0F);
+
+    input_peak_left = std::max(input_peak_left, peak_L);
+    input_peak_right = std::max(input_peak_right, peak_R);
+    output_peak_left = std::max(output_peak_left, peak_L);
+    output_peak_right = std::max(output_peak_right, peak_R);
+
+    notify();
+  }
+}
+
+void OutputLevel::measure(std::span<float>& left, std::span<float>& right) {
+  get_peaks(left, right, left, right);
+
+  true_peak_tap_L.push(left);
+  true_peak_tap_R.push(right);
+
+  AnalysisThread::get().wake();
+}
+
+void OutputLevel::analyze() {
+  while (true) {
+    const auto n = std::min({true_peak_tap_L.read_available(), true_peak_tap_R.read_available(), chunk_L.size()});
+
+    if (n == 0U) {
+      break;
+    }
+
+    true_peak_tap_L.pop(std::span(chunk_L.data(), n));
+    true_peak_tap_R.pop(std::span(chunk_R.data(), n));
+
+    store_max(true_peak_L, true_peak_detector_L.process(std::span<const float>(chunk_L.data(), n)));
+    store_max(true_peak_R, true_peak_detector_R.process(std::span<const float>(chunk_R.data(), n)));
   }
 }
 
@@ -18,6 +18,7 @@
  */
 
 #include "pipe_manager.hpp"
+#include "tracer.hpp"
 
 namespace {
 
@@ -1066,6 +1067,8 @@ void on_registry_global(void* data,
     return;
   }
 
+  const tracer::Span span("registry global", "pipewire", type);
+
   auto* const pm = static_cast<PipeManager*>(data);
 
   if (g_strcmp0(type, PW_TYPE_INTERFACE_Node) == 0) {
@@ -1419,6 +1422,12 @@ void on_registry_global(void* data,
   }
 }
 
+void on_registry_global_remove([[maybe_unused]] void* data, [[maybe_unused]] uint32_t id) {
+  // The objects we care about are removed through their proxies. This is only here for the tracer.
+
+  tracer::instant("registry global remove", "pipewire");
+}
+
 void on_core_error(void* data, uint32_t id, int seq, int res, const char* message) {
   auto* const pm = static_cast<PipeManager*>(data);
 
@@ -1468,11 +1477,13 @@ const struct pw_core_events core_events = {.version = PW_VERSION_CORE_EVENTS,
 
 const struct pw_registry_events registry_events = {
     .global = on_registry_global,
+    .global_remove = on_registry_global_remove,
 };
 
 }  // namespace
 
-PipeManager::PipeManager() : header_version(pw_get_headers_version()), library_version(pw_get_library_version()) {
+PipeManager::PipeManager(const Backend& backend)
+    : header_version(pw_get_headers_version()), library_version(pw_get_library_version()) {
   pw_init(nullptr, nullptr);
 
   spa_zero(core_listener);
@@ -1509,7 +1520,32 @@ PipeManager::PipeManager() : header_version(pw_get_headers_version()), library_v
     util::error("could not create PipeWire context");
   }
 
-  core = pw_context_connect(context, nullptr, 0);
+  if (backend == Backend::in_process) {
+    /*
+      We create nodes, links and the default metadata ourselves. Which factories the client configuration loads
+      depends on the PipeWire version and on the user configuration. Loading a module whose factory already exists
+      fails, so only the missing ones are loaded.
+    */
+
+    for (const auto& [factory, module] : std::to_array<std::pair<const char*, const char*>>(
+             {{"adapter", "libpipewire-module-adapter"},
+              {"metadata", "libpipewire-module-metadata"},
+              {"link-factory", "libpipewire-module-link-factory"}})) {
+      if (pw_context_find_factory(context, factory) != nullptr) {
+        continue;
+      }
+
+      if (pw_context_load_module(context, module, nullptr, nullptr) == nullptr) {
+        util::error("could not load the PipeWire module " + std::string(module));
+      }
+
+      util::debug("loaded the PipeWire module " + std::string(module));
+    }
+
+    core = pw_context_connect_self(context, nullptr, 0);
+  } else {
+    core = pw_context_connect(context, nullptr, 0);
+  }
 
   if (core == nullptr) {
     util::error("context connection failed");
@@ -1525,6 +1561,25 @@ PipeManager::PipeManager() : header_version(pw_get_headers_version()), library_v
 
   pw_core_add_listener(core, &core_listener, &core_events, this);
 
+  /*
+    Without a session manager nobody creates the default metadata object or configures the ports of our virtual
+    devices. The in_process backend does both.
+  */
+
+  const auto* auto_port_config =
+      (backend == Backend::in_process) ? "{ mode = dsp monitor = true position = preserve }" : nullptr;
+
+  if (backend == Backend::in_process) {
+    pw_properties* props_metadata = pw_properties_new(nullptr, nullptr);
+
+    pw_properties_set(props_metadata, PW_KEY_METADATA_NAME, "default");
+
+    proxy_default_metadata = static_cast<pw_proxy*>(pw_core_create_object(
+        core, "metadata", PW_TYPE_INTERFACE_Metadata, PW_VERSION_METADATA, &props_metadata->dict, 0));
+
+    pw_properties_free(props_metadata);
+  }
+
   // loading Easy Effects sink
 
   pw_properties* props_sink = pw_properties_new(nullptr, nullptr);
@@ -1539,6 +1594,7 @@ PipeManager::PipeManager() : header_version(pw_get_headers_version()), library_v
   pw_properties_set(props_sink, "audio.position", "FL,FR");
   pw_properties_set(props_sink, "monitor.channel-volumes", "false");
   pw_properties_set(props_sink, "priority.session", "0");
+  pw_properties_set(props_sink, "adapter.auto-port-config", auto_port_config);
 
   proxy_stream_output_sink = static_cast<pw_proxy*>(
       pw_core_create_object(core, "adapter", PW_TYPE_INTERFACE_Node, PW_VERSION_NODE, &props_sink->dict, 0));
@@ -1558,6 +1614,7 @@ PipeManager::PipeManager() : header_version(pw_get_headers_version()), library_v
   pw_properties_set(props_source, "audio.position", "FL,FR");
   pw_properties_set(props_source, "monitor.channel-volumes", "false");
   pw_properties_set(props_source, "priority.session", "0");
+  pw_properties_set(props_source, "adapter.auto-port-config", auto_port_config);
 
   proxy_stream_input_source = static_cast<pw_proxy*>(
       pw_core_create_object(core, "adapter", PW_TYPE_INTERFACE_Node, PW_VERSION_NODE, &props_source->dict, 0));
@@ -1603,6 +1660,10 @@ PipeManager::~PipeManager() {
   pw_proxy_destroy(proxy_stream_output_sink);
   pw_proxy_destroy(proxy_stream_input_source);
 
+  if (proxy_default_metadata != nullptr) {
+    pw_proxy_destroy(proxy_default_metadata);
+  }
+
   util::debug("Destroying PipeWire registry...");
   pw_proxy_destroy((struct pw_proxy*)registry);
 
@@ -1731,6 +1792,10 @@ auto PipeManager::link_nodes(const uint& output_node_id,
                              const uint& input_node_id,
                              const bool& probe_link,
                              const bool& link_passive) -> std::vector<pw_proxy*> {
+  const auto trace_detail = util::to_string(output_node_id) + " -> " + util::to_string(input_node_id);
+
+  const tracer::Span span("link nodes", "pipewire", trace_detail.c_str());
+
   std::vector<pw_proxy*> list;
   std::vector<PortInfo> list_output_ports;
   std::vector<PortInfo> list_input_ports;
@@ -1839,11 +1904,33 @@ void PipeManager::unlock() const {
 }
 
 void PipeManager::sync_wait_unlock() const {
+  const auto t0 = std::chrono::steady_clock::now();
+
   pw_core_sync(core, PW_ID_CORE, 0);
 
   pw_thread_loop_wait(thread_loop);
 
   pw_thread_loop_unlock(thread_loop);
+
+  if (const auto delay = round_trip_delay_us.load(std::memory_order_relaxed); delay != 0U) {
+    std::this_thread::sleep_for(std::chrono::microseconds(delay));
+  }
+
+  const auto t1 = std::chrono::steady_clock::now();
+
+  n_round_trips.fetch_add(1U, std::memory_order_relaxed);
+
+  round_trip_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(),
+                          std::memory_order_relaxed);
+}
+
+auto PipeManager::get_round_trip_stats() const -> RoundTripStats {
+  return {.n_round_trips = n_round_trips.load(), .wait_ns = round_trip_ns.load()};
+}
+
+void PipeManager::reset_round_trip_stats() {
+  n_round_trips = 0U;
+  round_trip_ns = 0U;
 }
 
 auto PipeManager::wait_full() const -> int {
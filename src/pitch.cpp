@@ -26,6 +26,7 @@ Pitch::Pitch(const std::string& tag,
     : PluginBase(tag, tags::plugin_name::pitch, tags::plugin_package::sound_touch, schema, schema_path, pipe_manager) {
   quick_seek = g_settings_get_boolean(settings, "quick-seek") != 0;
   anti_alias = g_settings_get_boolean(settings, "anti-alias") != 0;
+  low_latency = g_settings_get_boolean(settings, "low-latency") != 0;
 
   sequence_length_ms = g_settings_get_int(settings, "sequence-length");
   seek_window_ms = g_settings_get_int(settings, "seek-window");
@@ -42,21 +43,19 @@ Pitch::Pitch(const std::string& tag,
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto* self = static_cast<Pitch*>(user_data);
 
-                                            util::idle_add([&, self] {
-                                              self->data_mutex.lock();
-
-                                              self->soundtouch_ready = false;
-
-                                              self->data_mutex.unlock();
+                                            util::idle_add([&, self] { self->reset_soundtouch(); });
+                                          }),
+                                          this));
 
-                                              self->init_soundtouch();
+  // the processing windows change the delay, so the output buffer is rebuilt from scratch
 
-                                              self->data_mutex.lock();
+  gconnections.push_back(g_signal_connect(settings, "changed::low-latency",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                            auto* self = static_cast<Pitch*>(user_data);
 
-                                              self->soundtouch_ready = true;
+                                            self->low_latency = g_settings_get_boolean(settings, key) != 0;
 
-                                              self->data_mutex.unlock();
-                                            });
+                                            util::idle_add([&, self] { self->reset_soundtouch(); });
                                           }),
                                           this));
 
@@ -188,21 +187,18 @@ void Pitch::setup() {
 
   latency_n_frames = 0U;
 
-  if (data.size() != static_cast<size_t>(n_samples) * 2) {
-    data.resize(2U * static_cast<size_t>(n_samples));
-  }
-
-  deque_out_L.resize(0U);
-  deque_out_R.resize(0U);
+  // setup() runs on the realtime thread. The buffers are allocated on the main thread while soundtouch_ready is false.
 
   util::idle_add([&, this] {
     if (soundtouch_ready) {
       return;
     }
 
+    allocate_buffers();
+
     init_soundtouch();
 
-    std::scoped_lock<std::mutex> lock(data_mutex);
+    std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
     soundtouch_ready = true;
   });
@@ -212,7 +208,7 @@ void Pitch::process(std::span<float>& left_in,
                     std::span<float>& right_in,
                     std::span<float>& left_out,
                     std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass || !soundtouch_ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -221,9 +217,7 @@ void Pitch::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   for (size_t n = 0U; n < left_in.size(); n++) {
     data[n * 2U] = left_in[n];
@@ -237,56 +231,66 @@ void Pitch::process(std::span<float>& left_in,
   do {
     n_received = snd_touch->receiveSamples(data.data(), n_samples);
 
-    for (size_t n = 0U; n < n_received; n++) {
-      deque_out_L.push_back(data[n * 2U]);
-      deque_out_R.push_back(data[n * 2U + 1U]);
-    }
-
+    fifo_out.push(std::span<const float>(data.data(), 2U * n_received));
   } while (n_received != 0);
 
-  if (deque_out_L.size() >= left_out.size()) {
-    for (float& v : left_out) {
-      v = deque_out_L.front();
+  /*
+    Until SoundTouch has filled its processing windows it does not give us enough samples. The missing ones are
+    added as silence in front of the output and this padding is the delay added by the plugin.
 
-      deque_out_L.pop_front();
-    }
+    With a tempo above 1 SoundTouch keeps returning fewer samples than it receives and the gaps are filled with
+    silence too, but that is not delay. So the padding stops counting once it covers the initial latency of
+    SoundTouch, one input sequence and one quantum.
 
-    for (float& v : right_out) {
-      v = deque_out_R.front();
+    With a tempo or rate below 1 SoundTouch returns more samples than it receives and the buffer grows without
+    bound. Dropping the excess would cut the output in every quantum, so in low latency mode tempo and rate are not
+    allowed below 1 instead. There the backlog only comes from the bursts of SoundTouch and it is trimmed as a last
+    resort. In the normal mode the output is delayed by the backlog, as it always was.
+  */
 
-      deque_out_R.pop_front();
-    }
-  } else {
-    const uint offset = left_out.size() - deque_out_L.size();
+  const auto n_interleaved = 2U * left_out.size();
+
+  const auto max_latency = static_cast<uint>(snd_touch->getSetting(SETTING_INITIAL_LATENCY) +
+                                             snd_touch->getSetting(SETTING_NOMINAL_INPUT_SEQUENCE)) +
+                           n_samples;
 
-    if (offset != latency_n_frames) {
-      latency_n_frames = offset;
+  if (const auto available = fifo_out.read_available(); available < n_interleaved) {
+    const auto missing = n_interleaved - available;
+
+    fifo_out.push_fill(missing, 0.0F);
+
+    if (latency_n_frames < max_latency) {
+      latency_n_frames = std::min(latency_n_frames + static_cast<uint>(missing / 2U), max_latency);
 
       notify_latency = true;
     }
+  }
 
-    for (uint n = 0U; !deque_out_L.empty() && n < left_out.size(); n++) {
-      if (n < offset) {
-        left_out[n] = 0.0F;
-        right_out[n] = 0.0F;
-      } else {
-        left_out[n] = deque_out_L.front();
-        right_out[n] = deque_out_R.front();
+  if (latency_n_frames > max_latency) {
+    // shorter processing windows lower the limit
 
-        deque_out_R.pop_front();
-        deque_out_L.pop_front();
-      }
-    }
+    latency_n_frames = max_latency;
+
+    notify_latency = true;
+  }
+
+  fifo_out.pop(std::span<float>(data.data(), n_interleaved));
+
+  if (const auto backlog = fifo_out.read_available(); low_latency && backlog > 2U * latency_n_frames) {
+    fifo_out.discard(backlog - 2U * latency_n_frames);
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
+  for (size_t n = 0U; n < left_out.size(); n++) {
+    left_out[n] = data[n * 2U];
+    right_out[n] = data[n * 2U + 1U];
   }
 
+  apply_output_gain(left_out, right_out, output_gain);
+
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
 
     util::idle_add([=, this]() {
       if (!post_messages || latency.empty()) {
@@ -301,12 +305,8 @@ void Pitch::process(std::span<float>& left_in,
     notify_latency = false;
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
-    if (send_notifications) {
-      notify();
-    }
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
@@ -315,7 +315,7 @@ void Pitch::set_semitones() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   snd_touch->setPitchSemiTones(semitones);
 }
@@ -325,9 +325,9 @@ void Pitch::set_sequence_length() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  snd_touch->setSetting(SETTING_SEQUENCE_MS, sequence_length_ms);
+  snd_touch->setSetting(SETTING_SEQUENCE_MS, low_latency ? low_latency_sequence_ms : sequence_length_ms);
 }
 
 void Pitch::set_seek_window() {
@@ -335,9 +335,9 @@ void Pitch::set_seek_window() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  snd_touch->setSetting(SETTING_SEEKWINDOW_MS, seek_window_ms);
+  snd_touch->setSetting(SETTING_SEEKWINDOW_MS, low_latency ? low_latency_seek_window_ms : seek_window_ms);
 }
 
 void Pitch::set_overlap_length() {
@@ -345,9 +345,9 @@ void Pitch::set_overlap_length() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  snd_touch->setSetting(SETTING_OVERLAP_MS, overlap_length_ms);
+  snd_touch->setSetting(SETTING_OVERLAP_MS, low_latency ? low_latency_overlap_ms : overlap_length_ms);
 }
 
 void Pitch::set_quick_seek() {
@@ -355,7 +355,7 @@ void Pitch::set_quick_seek() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   snd_touch->setSetting(SETTING_USE_QUICKSEEK, static_cast<int>(quick_seek));
 }
@@ -365,7 +365,7 @@ void Pitch::set_anti_alias() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   snd_touch->setSetting(SETTING_USE_AA_FILTER, static_cast<int>(anti_alias));
 }
@@ -375,9 +375,11 @@ void Pitch::set_tempo_difference() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  snd_touch->setTempoChange(tempo_difference);
+  // In low latency mode nothing is slowed down. See the comment in process().
+
+  snd_touch->setTempoChange(low_latency ? std::max(tempo_difference, 0.0) : tempo_difference);
 }
 
 void Pitch::set_rate_difference() {
@@ -385,9 +387,9 @@ void Pitch::set_rate_difference() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
-  snd_touch->setRateChange(rate_difference);
+  snd_touch->setRateChange(low_latency ? std::max(rate_difference, 0.0) : rate_difference);
 }
 
 void Pitch::init_soundtouch() {
@@ -406,6 +408,44 @@ void Pitch::init_soundtouch() {
   set_overlap_length();
   set_tempo_difference();
   set_rate_difference();
+
+  util::debug(log_tag + name + " soundtouch initial latency: " +
+              util::to_string(snd_touch->getSetting(SETTING_INITIAL_LATENCY)) + " frames");
+}
+
+void Pitch::allocate_buffers() {
+  const auto quantum = std::max(static_cast<size_t>(n_samples), static_cast<size_t>(max_quantum));
+
+  data.resize(2U * quantum);
+
+  /*
+    Tempo and rate changes make SoundTouch return more or less samples than it receives. We leave enough room for
+    a few quanta plus one full processing sequence.
+  */
+
+  fifo_out.resize(2U * (4U * quantum + rate / 10U));
+}
+
+void Pitch::reset_soundtouch() {
+  data_mutex.lock();
+
+  soundtouch_ready = false;
+
+  data_mutex.unlock();
+
+  allocate_buffers();
+
+  init_soundtouch();
+
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
+
+  fifo_out.clear();
+
+  latency_n_frames = 0U;
+
+  notify_latency = true;
+
+  soundtouch_ready = true;
 }
 
 auto Pitch::get_latency_seconds() -> float {
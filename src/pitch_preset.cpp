@@ -39,6 +39,8 @@ void PitchPreset::save(nlohmann::json& json) {
 
   json[section][instance_name]["anti-alias"] = g_settings_get_boolean(settings, "anti-alias") != 0;
 
+  json[section][instance_name]["low-latency"] = g_settings_get_boolean(settings, "low-latency") != 0;
+
   json[section][instance_name]["sequence-length"] = g_settings_get_int(settings, "sequence-length");
 
   json[section][instance_name]["seek-window"] = g_settings_get_int(settings, "seek-window");
@@ -50,6 +52,8 @@ void PitchPreset::save(nlohmann::json& json) {
   json[section][instance_name]["rate-difference"] = g_settings_get_double(settings, "rate-difference");
 
   json[section][instance_name]["semitones"] = g_settings_get_double(settings, "semitones");
+
+  json[section][instance_name]["async-mode"] = g_settings_get_boolean(settings, "async-mode") != 0;
 }
 
 void PitchPreset::load(const nlohmann::json& json) {
@@ -63,6 +67,8 @@ void PitchPreset::load(const nlohmann::json& json) {
 
   update_key<bool>(json.at(section).at(instance_name), settings, "anti-alias", "anti-alias");
 
+  update_key<bool>(json.at(section).at(instance_name), settings, "low-latency", "low-latency");
+
   update_key<int>(json.at(section).at(instance_name), settings, "sequence-length", "sequence-length");
 
   update_key<int>(json.at(section).at(instance_name), settings, "seek-window", "seek-window");
@@ -74,4 +80,6 @@ void PitchPreset::load(const nlohmann::json& json) {
   update_key<double>(json.at(section).at(instance_name), settings, "rate-difference", "rate-difference");
 
   update_key<double>(json.at(section).at(instance_name), settings, "semitones", "semitones");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "async-mode", "async-mode");
 }
@@ -46,7 +46,7 @@ struct _PitchBox {
 
   GtkSpinButton *semitones, *sequence_length, *seek_window, *overlap_length, *tempo_difference, *rate_difference;
 
-  GtkSwitch *quick_seek, *anti_alias;
+  GtkSwitch *quick_seek, *anti_alias, *low_latency;
 
   GSettings* settings;
 
@@ -75,36 +75,49 @@ void setup(PitchBox* self, std::shared_ptr<Pitch> pitch, const std::string& sche
 
   pitch->set_post_messages(true);
 
-  self->data->connections.push_back(pitch->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
-
-  self->data->connections.push_back(pitch->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
-
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+  self->data->connections.push_back(pitch->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
+
+  self->data->connections.push_back(pitch->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
+
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   gtk_label_set_text(self->plugin_credit, ui::get_plugin_credit_translated(self->data->pitch->package).c_str());
 
   gsettings_bind_widgets<"input-gain", "output-gain">(self->settings, self->input_gain, self->output_gain);
 
-  gsettings_bind_widgets<"quick-seek", "anti-alias", "sequence-length", "seek-window", "overlap-length",
+  gsettings_bind_widgets<"quick-seek", "anti-alias", "low-latency", "sequence-length", "seek-window", "overlap-length",
                          "tempo-difference", "rate-difference", "semitones">(
-      self->settings, self->quick_seek, self->anti_alias, self->sequence_length, self->seek_window,
+      self->settings, self->quick_seek, self->anti_alias, self->low_latency, self->sequence_length, self->seek_window,
       self->overlap_length, self->tempo_difference, self->rate_difference, self->semitones);
+
+  // the low latency profile overrides the processing windows
+
+  g_settings_bind(self->settings, "low-latency", self->sequence_length, "sensitive",
+                  static_cast<GSettingsBindFlags>(G_SETTINGS_BIND_DEFAULT | G_SETTINGS_BIND_INVERT_BOOLEAN));
+
+  g_settings_bind(self->settings, "low-latency", self->seek_window, "sensitive",
+                  static_cast<GSettingsBindFlags>(G_SETTINGS_BIND_DEFAULT | G_SETTINGS_BIND_INVERT_BOOLEAN));
+
+  g_settings_bind(self->settings, "low-latency", self->overlap_length, "sensitive",
+                  static_cast<GSettingsBindFlags>(G_SETTINGS_BIND_DEFAULT | G_SETTINGS_BIND_INVERT_BOOLEAN));
 }
 
 void dispose(GObject* object) {
@@ -165,6 +178,7 @@ void pitch_box_class_init(PitchBoxClass* klass) {
 
   gtk_widget_class_bind_template_child(widget_class, PitchBox, quick_seek);
   gtk_widget_class_bind_template_child(widget_class, PitchBox, anti_alias);
+  gtk_widget_class_bind_template_child(widget_class, PitchBox, low_latency);
   gtk_widget_class_bind_template_child(widget_class, PitchBox, sequence_length);
   gtk_widget_class_bind_template_child(widget_class, PitchBox, seek_window);
   gtk_widget_class_bind_template_child(widget_class, PitchBox, overlap_length);
@@ -18,6 +18,12 @@
  */
 
 #include "plugin_base.hpp"
+#include <algorithm>
+#include <cmath>
+#include "level_kernels.hpp"
+#include "rt_audit.hpp"
+#include "startup_timer.hpp"
+#include "tracer.hpp"
 
 namespace {
 
@@ -31,7 +37,15 @@ void on_process(void* userdata, spa_io_position* position) {
     return;
   }
 
+  const auto t_start = std::chrono::steady_clock::now();
+
+  // Nothing on the realtime thread is exempt. What setup() does is audited too, but reported under its own label.
+
+  const rt_audit::Scope audit_scope(d->pb->name.c_str());
+
   if (rate != d->pb->rate || n_samples != d->pb->n_samples) {
+    const rt_audit::Scope setup_audit_scope(d->pb->audit_setup_label.c_str());
+
     d->pb->rate = rate;
     d->pb->n_samples = n_samples;
 
@@ -41,14 +55,41 @@ void on_process(void* userdata, spa_io_position* position) {
     std::ranges::fill(d->pb->dummy_left, 0.0F);
     std::ranges::fill(d->pb->dummy_right, 0.0F);
 
-    d->pb->clock_start = std::chrono::system_clock::now();
+    d->pb->clock_start = t_start;
+
+    d->pb->next_clock_position = 0U;
+
+    if (d->pb->async_mode) {
+      d->pb->request_async_setup();
+    } else {
+      d->pb->async_setup_pending = true;
+    }
+  }
+
+  // Without the async worker setup() runs here. This also covers a request the worker was stopped before handling.
+
+  if (!d->pb->async_mode && d->pb->async_setup_pending.exchange(false)) {
+    const rt_audit::Scope setup_audit_scope(d->pb->audit_setup_label.c_str());
+
+    const tracer::Span span("setup", "plugin", d->pb->name.c_str());
 
     d->pb->setup();
   }
 
-  d->pb->delta_t = 0.001F * static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                   std::chrono::system_clock::now() - d->pb->clock_start)
-                                                   .count());
+  if (d->pb->next_clock_position != 0U && position->clock.position != d->pb->next_clock_position) {
+    d->pb->n_clock_jumps.fetch_add(1U, std::memory_order_relaxed);
+  }
+
+  d->pb->next_clock_position = position->clock.position + n_samples;
+
+  d->pb->graph_rate.store(rate, std::memory_order_relaxed);
+  d->pb->graph_quantum.store(n_samples, std::memory_order_relaxed);
+
+  const tracer::Span span("process", "plugin", d->pb->name.c_str());
+
+  d->pb->delta_t =
+      0.001F *
+      static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(t_start - d->pb->clock_start).count());
 
   d->pb->send_notifications = d->pb->delta_t >= d->pb->notification_time_window;
 
@@ -89,7 +130,13 @@ void on_process(void* userdata, spa_io_position* position) {
     right_out = d->pb->dummy_right;
   }
 
-  if (!d->pb->enable_probe) {
+  // the plugins are allowed to change the input buffers, so the input taps have to be written first
+
+  d->pb->write_analyzer_taps(AnalyzerTap::Position::input, left_in, right_in);
+
+  if (d->pb->async_mode && !d->pb->enable_probe) {
+    d->pb->process_async(left_in, right_in, left_out, right_out);
+  } else if (!d->pb->enable_probe) {
     d->pb->process(left_in, right_in, left_out, right_out);
   } else {
     auto* probe_left = static_cast<float*>(pw_filter_get_dsp_buffer(d->probe_left, n_samples));
@@ -108,11 +155,28 @@ void on_process(void* userdata, spa_io_position* position) {
     }
   }
 
+  d->pb->write_analyzer_taps(AnalyzerTap::Position::output, left_out, right_out);
+
+  startup_timer::mark_first_audio();
+
   if (d->pb->send_notifications) {
-    d->pb->clock_start = std::chrono::system_clock::now();
+    d->pb->clock_start = t_start;
 
     d->pb->send_notifications = false;
   }
+
+  // DSP load as a fraction of the quantum period
+
+  const auto busy_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t_start).count());
+
+  const auto period_ns = static_cast<uint64_t>(n_samples) * 1000000000U / rate;
+
+  d->pb->dsp_load.record(busy_ns, period_ns);
+
+  if (auto* chain = d->pb->chain_dsp_load.load(std::memory_order_relaxed); chain != nullptr) {
+    chain->accumulate(position->clock.position, busy_ns, period_ns, d->pb->dsp_load);
+  }
 }
 
 auto update_filter(struct spa_loop* loop, bool async, uint32_t seq, const void* data, size_t size, void* user_data)
@@ -121,7 +185,8 @@ auto update_filter(struct spa_loop* loop, bool async, uint32_t seq, const void*
 
   spa_process_latency_info latency_info{};
 
-  latency_info.ns = static_cast<uint64_t>(self->latency_value * 1000000000.0F);
+  latency_info.ns =
+      static_cast<uint64_t>((self->latency_value + self->get_async_latency_seconds()) * 1000000000.0F);
 
   std::array<char, 1024U> buffer{};
 
@@ -179,6 +244,8 @@ PluginBase::PluginBase(std::string tag,
       enable_probe(enable_probe),
       settings(g_settings_new_with_path(schema.c_str(), schema_path.c_str())),
       pm(pipe_manager) {
+  audit_setup_label = name + " setup";
+
   std::string description;
 
   if (name != "output_level" && name != "spectrum") {
@@ -201,6 +268,96 @@ PluginBase::PluginBase(std::string tag,
 
   pf_data.pb = this;
 
+  // Without a PipeManager the plugin is driven by process_offline() and no PipeWire filter is created.
+
+  if (pm != nullptr) {
+    create_filter(description);
+  }
+
+  /*
+    Heavy plugins can be moved out of the PipeWire realtime thread. Only the plugins whose schema has the async-mode
+    key offer this option.
+  */
+
+  if (util::gsettings_has_key(settings, "async-mode")) {
+    async_enabled = g_settings_get_boolean(settings, "async-mode") != 0;
+
+    gconnections.push_back(g_signal_connect(settings, "changed::async-mode",
+                                            G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                              auto* self = static_cast<PluginBase*>(user_data);
+
+                                              self->async_enabled = g_settings_get_boolean(settings, key) != 0;
+
+                                              if (!self->connected_to_pw) {
+                                                return;
+                                              }
+
+                                              if (self->async_enabled) {
+                                                self->start_async_worker();
+                                              } else {
+                                                self->stop_async_worker();
+                                              }
+
+                                              self->update_filter_params();
+
+                                              self->latency.emit();
+                                            }),
+                                            this));
+  }
+
+  /*
+    Plugins with independent per channel states can process the right channel on a helper thread. Only the plugins
+    whose schema has the parallel-channels key offer this option.
+  */
+
+  if (util::gsettings_has_key(settings, "parallel-channels")) {
+    if (g_settings_get_boolean(settings, "parallel-channels") != 0) {
+      channel_worker.start();
+    }
+
+    gconnections.push_back(g_signal_connect(settings, "changed::parallel-channels",
+                                            G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                                              auto* self = static_cast<PluginBase*>(user_data);
+
+                                              std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
+
+                                              if (g_settings_get_boolean(settings, key) != 0) {
+                                                self->channel_worker.start();
+                                              } else {
+                                                self->channel_worker.stop();
+                                              }
+                                            }),
+                                            this));
+  }
+}
+
+PluginBase::~PluginBase() {
+  post_messages = false;
+
+  stop_async_worker();
+
+  if (pm != nullptr) {
+    pm->lock();
+
+    if (listener.link.next != nullptr || listener.link.prev != nullptr) {
+      spa_hook_remove(&listener);
+    }
+
+    pw_filter_destroy(filter);
+
+    pm->sync_wait_unlock();
+  }
+
+  for (auto& handler_id : gconnections) {
+    g_signal_handler_disconnect(settings, handler_id);
+  }
+
+  gconnections.clear();
+
+  g_object_unref(settings);
+}
+
+void PluginBase::create_filter(const std::string& description) {
   const auto filter_name = "ee_" + log_tag.substr(0U, log_tag.size() - 2U) + "_" + name;
 
   pm->lock();
@@ -291,28 +448,6 @@ PluginBase::PluginBase(std::string tag,
   pm->sync_wait_unlock();
 }
 
-PluginBase::~PluginBase() {
-  post_messages = false;
-
-  pm->lock();
-
-  if (listener.link.next != nullptr || listener.link.prev != nullptr) {
-    spa_hook_remove(&listener);
-  }
-
-  pw_filter_destroy(filter);
-
-  pm->sync_wait_unlock();
-
-  for (auto& handler_id : gconnections) {
-    g_signal_handler_disconnect(settings, handler_id);
-  }
-
-  gconnections.clear();
-
-  g_object_unref(settings);
-}
-
 void PluginBase::set_post_messages(const bool& state) {
   post_messages = state;
 }
@@ -321,7 +456,11 @@ void PluginBase::reset_settings() {
   util::reset_all_keys_except(settings);
 }
 
-auto PluginBase::connect_to_pw() -> bool {
+auto PluginBase::request_connection_to_pw() -> bool {
+  if (connection_requested) {
+    return true;
+  }
+
   connected_to_pw = false;
   can_get_node_id = false;
   state = PW_FILTER_STATE_UNCONNECTED;
@@ -338,6 +477,22 @@ auto PluginBase::connect_to_pw() -> bool {
 
   initialize_listener();
 
+  pm->unlock();
+
+  connection_requested = true;
+
+  return true;
+}
+
+auto PluginBase::connect_to_pw() -> bool {
+  if (!request_connection_to_pw()) {
+    return false;
+  }
+
+  connection_requested = false;
+
+  pm->lock();
+
   pm->sync_wait_unlock();
 
   while (!can_get_node_id) {
@@ -367,6 +522,10 @@ auto PluginBase::connect_to_pw() -> bool {
 
   connected_to_pw = true;
 
+  if (async_enabled) {
+    start_async_worker();
+  }
+
   util::debug(log_tag + name + " successfully connected to PipeWire graph");
 
   return true;
@@ -397,9 +556,12 @@ void PluginBase::disconnect_from_pw() {
   pw_filter_disconnect(filter);
 
   connected_to_pw = false;
+  connection_requested = false;
 
   pm->sync_wait_unlock();
 
+  stop_async_worker();
+
   node_id = SPA_ID_INVALID;
 }
 
@@ -456,21 +618,51 @@ void PluginBase::get_peaks(const std::span<float>& left_in,
     return;
   }
 
-  // input level
+  auto left = left_in;
+  auto right = right_in;
+
+  apply_input_gain(left, right, 1.0F);
+  apply_output_gain(left_out, right_out, 1.0F);
+}
 
-  float peak_l = std::ranges::max(left_in);
-  float peak_r = std::ranges::max(right_in);
+auto PluginBase::attach_analyzer_tap(AnalyzerTap* tap) -> bool {
+  for (auto& slot : analyzer_taps) {
+    if (slot.load() == tap) {
+      return true;
+    }
+  }
 
-  input_peak_left = (peak_l > input_peak_left) ? peak_l : input_peak_left;
-  input_peak_right = (peak_r > input_peak_right) ? peak_r : input_peak_right;
+  for (auto& slot : analyzer_taps) {
+    AnalyzerTap* expected = nullptr;
 
-  // output level
+    if (slot.compare_exchange_strong(expected, tap)) {
+      return true;
+    }
+  }
 
-  peak_l = std::ranges::max(left_out);
-  peak_r = std::ranges::max(right_out);
+  util::warning(log_tag + name + ": no free analyzer tap slot");
 
-  output_peak_left = (peak_l > output_peak_left) ? peak_l : output_peak_left;
-  output_peak_right = (peak_r > output_peak_right) ? peak_r : output_peak_right;
+  return false;
+}
+
+void PluginBase::detach_analyzer_tap(AnalyzerTap* tap) {
+  for (auto& slot : analyzer_taps) {
+    AnalyzerTap* expected = tap;
+
+    slot.compare_exchange_strong(expected, nullptr);
+  }
+}
+
+void PluginBase::write_analyzer_taps(const AnalyzerTap::Position& position,
+                                     const std::span<float>& left,
+                                     const std::span<float>& right) {
+  for (auto& slot : analyzer_taps) {
+    auto* tap = slot.load(std::memory_order_acquire);
+
+    if (tap != nullptr && tap->position.load(std::memory_order_relaxed) == position) {
+      tap->write(left, right);
+    }
+  }
 }
 
 void PluginBase::setup_input_output_gain() {
@@ -498,28 +690,384 @@ void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, con
     return;
   }
 
-  std::ranges::for_each(left, [&](auto& v) { v *= gain; });
-  std::ranges::for_each(right, [&](auto& v) { v *= gain; });
+  level_kernels::apply_gain(left, right, gain);
+}
+
+void PluginBase::apply_input_gain(std::span<float>& left, std::span<float>& right, const float& gain) {
+  if (!post_messages) {
+    if (gain != 1.0F) {
+      apply_gain(left, right, gain);
+    }
+
+    return;
+  }
+
+  /*
+    The meters of the plugins show the sample peak. Oversampling for the true peak costs too much to run on every
+    block of every plugin, so it is only done by the Level Meter and OutputLevel on the analysis thread.
+  */
+
+  const auto levels_l = level_kernels::apply_gain_and_measure(left, gain);
+  const auto levels_r = level_kernels::apply_gain_and_measure(right, gain);
+
+  input_peak_left = std::max(levels_l.peak, input_peak_left);
+  input_peak_right = std::max(levels_r.peak, input_peak_right);
+
+  input_power_left += levels_l.sum_of_squares;
+  input_power_right += levels_r.sum_of_squares;
+
+  input_power_count += left.size();
+}
+
+void PluginBase::apply_output_gain(std::span<float>& left, std::span<float>& right, const float& gain) {
+  if (!post_messages) {
+    if (gain != 1.0F) {
+      apply_gain(left, right, gain);
+    }
+
+    return;
+  }
+
+  const auto levels_l = level_kernels::apply_gain_and_measure(left, gain);
+  const auto levels_r = level_kernels::apply_gain_and_measure(right, gain);
+
+  output_peak_left = std::max(levels_l.peak, output_peak_left);
+  output_peak_right = std::max(levels_r.peak, output_peak_right);
+
+  output_power_left += levels_l.sum_of_squares;
+  output_power_right += levels_r.sum_of_squares;
+
+  output_power_count += left.size();
 }
 
 void PluginBase::notify() {
+  const auto rms_db = [](const float& power, const size_t& count) {
+    return (count > 0U) ? util::linear_to_db(std::sqrt(power / static_cast<float>(count))) : util::minimum_db_level;
+  };
+
   const auto input_peak_db_l = util::linear_to_db(input_peak_left);
   const auto input_peak_db_r = util::linear_to_db(input_peak_right);
 
   const auto output_peak_db_l = util::linear_to_db(output_peak_left);
   const auto output_peak_db_r = util::linear_to_db(output_peak_right);
 
-  input_level.emit(input_peak_db_l, input_peak_db_r);
-  output_level.emit(output_peak_db_l, output_peak_db_r);
+  input_level.emit(input_peak_db_l, input_peak_db_r, rms_db(input_power_left, input_power_count),
+                   rms_db(input_power_right, input_power_count));
+
+  output_level.emit(output_peak_db_l, output_peak_db_r, rms_db(output_power_left, output_power_count),
+                    rms_db(output_power_right, output_power_count));
 
   input_peak_left = util::minimum_linear_level;
   input_peak_right = util::minimum_linear_level;
   output_peak_left = util::minimum_linear_level;
   output_peak_right = util::minimum_linear_level;
+
+  input_power_left = 0.0F;
+  input_power_right = 0.0F;
+  output_power_left = 0.0F;
+  output_power_right = 0.0F;
+
+  input_power_count = 0U;
+  output_power_count = 0U;
 }
 
 void PluginBase::update_probe_links() {}
 
+auto PluginBase::get_async_latency_seconds() const -> float {
+  if (!async_mode || rate == 0U) {
+    return 0.0F;
+  }
+
+  // The block processed by the worker is delivered one quantum later.
+
+  return static_cast<float>(n_samples) / static_cast<float>(rate);
+}
+
+auto PluginBase::get_channel_worker_stats() const -> ChannelWorker::Stats {
+  return channel_worker.get_stats();
+}
+
+auto PluginBase::get_lock_stats() const -> MonitoredMutex::Stats {
+  return data_mutex.get_stats();
+}
+
+auto PluginBase::get_settings() const -> GSettings* {
+  return settings;
+}
+
+void PluginBase::start_async_worker() {
+  if (async_worker.joinable() || enable_probe) {
+    return;
+  }
+
+  for (auto& slot : async_slots) {
+    slot.in_left.resize(async_capacity);
+    slot.in_right.resize(async_capacity);
+    slot.out_left.resize(async_capacity);
+    slot.out_right.resize(async_capacity);
+
+    slot.n_samples = 0U;
+    slot.state = AsyncSlotState::free;
+  }
+
+  async_index = 0U;
+  async_cycle = 0U;
+  async_overruns = 0U;
+
+  async_worker_running = true;
+
+  async_worker = std::thread([this]() { async_worker_loop(); });
+
+  /*
+    The worker should preempt normal threads but never the PipeWire data thread. If we are not allowed to use a
+    realtime policy the worker just runs with the default one.
+  */
+
+  sched_param param{};
+
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+  if (pthread_setschedparam(async_worker.native_handle(), SCHED_FIFO, &param) != 0) {
+    util::debug(log_tag + name + " could not set the realtime priority of the async worker");
+  }
+
+  async_mode = true;
+
+  util::debug(log_tag + name + " async mode enabled");
+}
+
+void PluginBase::stop_async_worker() {
+  if (!async_worker.joinable()) {
+    async_mode = false;
+
+    return;
+  }
+
+  /*
+    While the worker is being joined the realtime thread keeps queueing blocks that nobody processes and outputs
+    silence. It may only call process() itself after the worker is gone.
+  */
+
+  async_worker_running = false;
+
+  async_semaphore.release();
+
+  async_worker.join();
+
+  async_mode = false;
+
+  util::debug(log_tag + name + " async mode disabled");
+}
+
+void PluginBase::request_async_setup() {
+  /*
+    Queued blocks have the old quantum and finished ones were processed with the old settings. Both are dropped. The
+    block the worker is busy with is discarded by the worker itself when it sees the new generation.
+  */
+
+  async_generation.fetch_add(1U);
+
+  for (auto& slot : async_slots) {
+    auto expected = AsyncSlotState::queued;
+
+    if (!slot.state.compare_exchange_strong(expected, AsyncSlotState::free) && expected == AsyncSlotState::done) {
+      slot.state = AsyncSlotState::free;
+    }
+  }
+
+  // raised after the old blocks are dropped, so the worker never gives one of them to the new setup
+
+  async_setup_pending = true;
+
+  async_semaphore.release();
+}
+
+void PluginBase::run_async_setup() {
+  const tracer::Span span("setup", "plugin", name.c_str());
+
+  setup();
+
+  update_filter_params();
+
+  util::idle_add([this]() { latency.emit(); });
+}
+
+void PluginBase::async_worker_loop() {
+  while (async_worker_running) {
+    async_semaphore.acquire();
+
+    if (!async_worker_running) {
+      break;
+    }
+
+    if (async_setup_pending.exchange(false)) {
+      run_async_setup();
+    }
+
+    for (auto& slot : async_slots) {
+      auto expected = AsyncSlotState::queued;
+
+      if (!slot.state.compare_exchange_strong(expected, AsyncSlotState::busy)) {
+        continue;
+      }
+
+      /*
+        The realtime thread raises the setup request before it queues a block with the new quantum, so a block claimed
+        here is never processed before the setup it needs.
+      */
+
+      if (async_setup_pending.exchange(false)) {
+        run_async_setup();
+      }
+
+      if (slot.generation != async_generation.load()) {
+        slot.state = AsyncSlotState::free;
+
+        continue;
+      }
+
+      std::span<float> l_in(slot.in_left.data(), slot.n_samples);
+      std::span<float> r_in(slot.in_right.data(), slot.n_samples);
+      std::span<float> l_out(slot.out_left.data(), slot.n_samples);
+      std::span<float> r_out(slot.out_right.data(), slot.n_samples);
+
+      process(l_in, r_in, l_out, r_out);
+
+      // the quantum may have changed while process() was running
+
+      slot.state = (slot.generation == async_generation.load()) ? AsyncSlotState::done : AsyncSlotState::free;
+    }
+  }
+}
+
+void PluginBase::process_async(std::span<float>& left_in,
+                               std::span<float>& right_in,
+                               std::span<float>& left_out,
+                               std::span<float>& right_out) {
+  const auto n = static_cast<uint>(left_out.size());
+
+  if (n > async_capacity) {
+    process(left_in, right_in, left_out, right_out);
+
+    return;
+  }
+
+  /*
+    Output the block the worker received one quantum ago. A block that was finished too late to be output in its own
+    cycle is discarded, otherwise it would come out of order.
+  */
+
+  auto& previous = async_slots[async_index ^ 1U];
+
+  const auto previous_state = previous.state.load();
+
+  if (previous_state == AsyncSlotState::done && previous.n_samples == n && previous.cycle + 1U == async_cycle &&
+      previous.generation == async_generation.load()) {
+    std::copy_n(previous.out_left.begin(), n, left_out.begin());
+    std::copy_n(previous.out_right.begin(), n, right_out.begin());
+
+    previous.state = AsyncSlotState::free;
+  } else {
+    if (previous_state == AsyncSlotState::done) {
+      previous.state = AsyncSlotState::free;
+    }
+
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
+
+    async_overruns++;
+  }
+
+  // Hand the current block to the worker. If it is still busy with this slot the block is dropped.
+
+  auto& current = async_slots[async_index];
+
+  const auto state = current.state.load();
+
+  if (state == AsyncSlotState::free || state == AsyncSlotState::done) {
+    std::copy_n(left_in.begin(), n, current.in_left.begin());
+    std::copy_n(right_in.begin(), n, current.in_right.begin());
+
+    current.n_samples = n;
+    current.cycle = async_cycle;
+    current.generation = async_generation.load();
+
+    current.state = AsyncSlotState::queued;
+
+    async_semaphore.release();
+  }
+
+  async_index ^= 1U;
+
+  async_cycle++;
+}
+
 void PluginBase::update_filter_params() {
+  if (pm == nullptr) {
+    return;
+  }
+
   pw_loop_invoke(pw_thread_loop_get_loop(pm->thread_loop), update_filter, 1, nullptr, 0, false, this);
 }
+
+void PluginBase::setup_offline(const uint& sample_rate, const uint& block_size) {
+  rate = sample_rate;
+  n_samples = block_size;
+
+  dummy_left.resize(block_size);
+  dummy_right.resize(block_size);
+
+  std::ranges::fill(dummy_left, 0.0F);
+  std::ranges::fill(dummy_right, 0.0F);
+
+  setup();
+}
+
+void PluginBase::prepare_offline(const uint& sample_rate, const uint& block_size) {
+  if (sample_rate == 0U || block_size == 0U) {
+    return;
+  }
+
+  setup_offline(sample_rate, block_size);
+
+  // Without a running main loop the idle callbacks queued by setup() are dispatched here.
+
+  while (g_main_context_iteration(nullptr, 0) != 0) {
+  }
+
+  wait_setup();
+}
+
+void PluginBase::wait_setup() {}
+
+void PluginBase::process_offline(std::span<float>& left_in,
+                                 std::span<float>& right_in,
+                                 std::span<float>& left_out,
+                                 std::span<float>& right_out,
+                                 const uint& sample_rate) {
+  const auto n = static_cast<uint>(left_in.size());
+
+  if (n == 0U) {
+    return;
+  }
+
+  if (sample_rate != rate || n != n_samples) {
+    // Not prepared for this block. Calling setup() here would run it on the worker thread.
+
+    std::ranges::copy(left_in, left_out.begin());
+    std::ranges::copy(right_in, right_out.begin());
+
+    return;
+  }
+
+  // There is no graph to take a sidechain from, so the probe inputs are silent.
+
+  if (enable_probe) {
+    std::span l(dummy_left.data(), n);
+    std::span r(dummy_right.data(), n);
+
+    process(left_in, right_in, left_out, right_out, l, r);
+  } else {
+    process(left_in, right_in, left_out, right_out);
+  }
+}
@@ -35,9 +35,9 @@ struct _PreferencesSpectrum {
 
   GtkColorDialogButton *color_button, *axis_color_button;
 
-  GtkDropDown* type;
+  GtkDropDown *type, *mode, *fft_size, *octave_smoothing;
 
-  GtkSpinButton *n_points, *height, *line_width, *minimum_frequency, *maximum_frequency;
+  GtkSpinButton *overlap, *n_points, *waterfall_duration, *height, *line_width, *minimum_frequency, *maximum_frequency;
 
   GSettings* settings;
 
@@ -96,10 +96,15 @@ void preferences_spectrum_class_init(PreferencesSpectrumClass* klass) {
 
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, show);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, type);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, mode);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, fft_size);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, overlap);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, octave_smoothing);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, fill);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, n_points);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, line_width);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, height);
+  gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, waterfall_duration);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, show_bar_border);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, rounded_corners);
   gtk_widget_class_bind_template_child(widget_class, PreferencesSpectrum, dynamic_y_scale);
@@ -133,6 +138,10 @@ void preferences_spectrum_init(PreferencesSpectrum* self) {
 
   prepare_spinbuttons<"px">(self->height, self->line_width);
 
+  prepare_spinbutton<"%">(self->overlap);
+
+  prepare_spinbutton<"s">(self->waterfall_duration);
+
   g_signal_connect(self->minimum_frequency, "output", G_CALLBACK(+[](GtkSpinButton* button, gpointer user_data) {
                      return parse_spinbutton_output(button, "Hz");
                    }),
@@ -179,13 +188,19 @@ void preferences_spectrum_init(PreferencesSpectrum* self) {
 
   // spectrum section gsettings bindings
 
-  gsettings_bind_widgets<"show", "fill", "rounded-corners", "show-bar-border", "dynamic-y-scale", "n-points", "height",
-                         "line-width", "minimum-frequency", "maximum-frequency">(
+  gsettings_bind_widgets<"show", "fill", "rounded-corners", "show-bar-border", "dynamic-y-scale", "overlap", "n-points",
+                         "waterfall-duration", "height", "line-width", "minimum-frequency", "maximum-frequency">(
       self->settings, self->show, self->fill, self->rounded_corners, self->show_bar_border, self->dynamic_y_scale,
-      self->n_points, self->height, self->line_width, self->minimum_frequency, self->maximum_frequency);
+      self->overlap, self->n_points, self->waterfall_duration, self->height, self->line_width, self->minimum_frequency, self->maximum_frequency);
 
   ui::gsettings_bind_enum_to_combo_widget(self->settings, "type", self->type);
 
+  ui::gsettings_bind_enum_to_combo_widget(self->settings, "mode", self->mode);
+
+  ui::gsettings_bind_enum_to_combo_widget(self->settings, "fft-size", self->fft_size);
+
+  ui::gsettings_bind_enum_to_combo_widget(self->settings, "octave-smoothing", self->octave_smoothing);
+
   // Spectrum gsettings signals connections
 
   self->data->gconnections.push_back(g_signal_connect(
@@ -18,6 +18,7 @@
  */
 
 #include "presets_manager.hpp"
+#include "tracer.hpp"
 
 PresetsManager::PresetsManager()
     : user_config_dir(g_get_user_config_dir()),
@@ -387,138 +388,81 @@ void PresetsManager::remove(const PresetType& preset_type, const std::string& na
 }
 
 auto PresetsManager::load_preset_file(const PresetType& preset_type, const std::string& name) -> bool {
-  nlohmann::json json;
-
-  std::vector<std::string> plugins;
-
-  std::vector<std::filesystem::path> conf_dirs;
-
-  std::filesystem::path input_file;
+  const auto conf_dir = (preset_type == PresetType::output) ? user_output_dir : user_input_dir;
 
-  auto preset_found = false;
+  const auto input_file = conf_dir / std::filesystem::path{name + json_ext};
 
-  // Load the plugin order based on the input/output pipeline.
-  switch (preset_type) {
-    case PresetType::output: {
-      conf_dirs.push_back(user_output_dir);
-
-      for (const auto& dir : conf_dirs) {
-        input_file = dir / std::filesystem::path{name + json_ext};
+  if (!std::filesystem::exists(input_file)) {
+    util::debug("can't find the preset " + name + " on the filesystem");
 
-        if (std::filesystem::exists(input_file)) {
-          preset_found = true;
-
-          break;
-        }
-      }
-
-      if (preset_found) {
-        try {
-          std::ifstream is(input_file);
+    return false;
+  }
 
-          is >> json;
+  return load_preset_from_path(preset_type, input_file);
+}
 
-          for (const auto& p : json.at("output").at("plugins_order").get<std::vector<std::string>>()) {
-            for (const auto& v : tags::plugin_name::list) {
-              if (p.starts_with(v)) {
-                /*
-                  Old format presets do not have the instance id number in the filter names. They are equal to the
-                  base name.
-                */
-
-                if (p != v) {
-                  plugins.push_back(p);
-                } else {
-                  plugins.push_back(p + "#0");
-                }
-
-                break;
-              }
-            }
-          }
+auto PresetsManager::load_preset_from_path(const PresetType& preset_type, const std::filesystem::path& input_file)
+    -> bool {
+  const auto preset_name = input_file.stem().string();
 
-        } catch (const nlohmann::json::exception& e) {
-          notify_error(PresetError::pipeline_format);
+  const tracer::Span span("load preset", "presets", preset_name.c_str());
 
-          util::warning(e.what());
+  nlohmann::json json;
 
-          return false;
-        } catch (...) {
-          notify_error(PresetError::pipeline_generic);
+  std::vector<std::string> plugins;
 
-          return false;
-        }
+  const auto section = (preset_type == PresetType::output) ? "output" : "input";
 
-        g_settings_set_strv(soe_settings, "plugins", util::make_gchar_pointer_vector(plugins).data());
-      } else {
-        util::debug("can't find the preset " + name + " on the filesystem");
+  // Load the plugin order based on the input/output pipeline.
+  try {
+    const tracer::Span parse_span("parse preset", "presets", preset_name.c_str());
 
-        return false;
-      }
+    std::ifstream is(input_file);
 
-      break;
-    }
-    case PresetType::input: {
-      conf_dirs.push_back(user_input_dir);
+    is >> json;
 
-      for (const auto& dir : conf_dirs) {
-        input_file = dir / std::filesystem::path{name + json_ext};
+    for (const auto& p : json.at(section).at("plugins_order").get<std::vector<std::string>>()) {
+      for (const auto& v : tags::plugin_name::list) {
+        if (p.starts_with(v)) {
+          /*
+            Old format presets do not have the instance id number in the filter names. They are equal to the
+            base name.
+          */
 
-        if (std::filesystem::exists(input_file)) {
-          preset_found = true;
+          if (p != v) {
+            plugins.push_back(p);
+          } else {
+            plugins.push_back(p + "#0");
+          }
 
           break;
         }
       }
+    }
 
-      if (preset_found) {
-        try {
-          std::ifstream is(input_file);
-
-          is >> json;
-
-          for (const auto& p : json.at("input").at("plugins_order").get<std::vector<std::string>>()) {
-            for (const auto& v : tags::plugin_name::list) {
-              if (p.starts_with(v)) {
-                /*
-                  Old format presets do not have the instance id number in the filter names. They are equal to the
-                  base name.
-                */
-
-                if (p != v) {
-                  plugins.push_back(p);
-                } else {
-                  plugins.push_back(p + "#0");
-                }
-
-                break;
-              }
-            }
-          }
-
-        } catch (const nlohmann::json::exception& e) {
-          notify_error(PresetError::pipeline_format);
+  } catch (const nlohmann::json::exception& e) {
+    notify_error(PresetError::pipeline_format);
 
-          util::warning(e.what());
+    util::warning(e.what());
 
-          return false;
-        } catch (...) {
-          notify_error(PresetError::pipeline_generic);
+    return false;
+  } catch (...) {
+    notify_error(PresetError::pipeline_generic);
 
-          return false;
-        }
+    return false;
+  }
 
-        g_settings_set_strv(sie_settings, "plugins", util::make_gchar_pointer_vector(plugins).data());
-      } else {
-        util::debug("can't find the preset " + name + " on the filesystem");
+  {
+    // Changing the list rebuilds the effects pipeline
 
-        return false;
-      }
+    const tracer::Span order_span("apply plugins order", "presets", preset_name.c_str());
 
-      break;
-    }
+    g_settings_set_strv((preset_type == PresetType::output) ? soe_settings : sie_settings, "plugins",
+                        util::make_gchar_pointer_vector(plugins).data());
   }
 
+  const tracer::Span parameters_span("apply parameters", "presets", preset_name.c_str());
+
   // After the plugin order list, load the blocklist and then apply the parameters of the loaded plugins.
   if (load_blocklist(preset_type, json) && read_plugins_preset(preset_type, plugins, json)) {
     util::debug("successfully loaded preset: " + input_file.string());
@@ -19,10 +19,19 @@
 
 #include "resampler.hpp"
 
-Resampler::Resampler(const int& input_rate, const int& output_rate) : output(1, 0) {
+Resampler::Resampler(const int& input_rate, const int& output_rate, const int& n_channels) : output(1, 0) {
   resample_ratio = static_cast<double>(output_rate) / static_cast<double>(input_rate);
 
-  src_state = src_new(SRC_SINC_FASTEST, 1, nullptr);
+  src_state = src_new(SRC_SINC_FASTEST, n_channels, nullptr);
+}
+
+void Resampler::reserve(const size_t& max_input_frames) {
+  const auto max_output_frames = static_cast<size_t>(std::ceil(1.5 * resample_ratio * max_input_frames)) + 1U;
+
+  interleaved_in.reserve(2U * max_input_frames);
+  output.reserve(2U * max_output_frames);
+  output_left.reserve(max_output_frames);
+  output_right.reserve(max_output_frames);
 }
 
 Resampler::~Resampler() {
@@ -25,17 +25,25 @@ RNNoise::RNNoise(const std::string& tag,
                  PipeManager* pipe_manager)
     : PluginBase(tag, tags::plugin_name::rnnoise, tags::plugin_package::rnnoise, schema, schema_path, pipe_manager),
       enable_vad(g_settings_get_boolean(settings, "enable-vad")),
+      enable_gate(g_settings_get_boolean(settings, "enable-gate")),
       vad_thres(g_settings_get_double(settings, "vad-thres") / 100.0F),
       data_L(0),
       data_R(0) {
   data_L.reserve(blocksize);
   data_R.reserve(blocksize);
-  data_tmp.reserve(blocksize);
+  data_tmp_L.reserve(blocksize);
+  data_tmp_R.reserve(blocksize);
 
   const auto key_v = g_settings_get_double(settings, "wet");
 
   wet_ratio = (key_v <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(key_v));
 
+  gate.set_rate(rnnoise_rate);
+  gate.set_threshold(static_cast<float>(g_settings_get_double(settings, "gate-threshold")));
+
+  // 10 frames of 480 samples at 48 kHz. The network state is refreshed every 100 ms while the gate is closed.
+  gate.set_keep_warm_interval(10U);
+
   gconnections.push_back(g_signal_connect(settings, "changed::model-path",
                                           G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                                             auto* self = static_cast<RNNoise*>(user_data);
@@ -73,6 +81,22 @@ RNNoise::RNNoise(const std::string& tag,
                                           }),
                                           this));
 
+  gconnections.push_back(g_signal_connect(settings, "changed::enable-gate",
+                                          G_CALLBACK(+[](GSettings* settings, char* key, RNNoise* self) {
+                                            std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
+
+                                            self->enable_gate = g_settings_get_boolean(settings, key);
+
+                                            self->gate.reset();
+                                          }),
+                                          this));
+
+  gconnections.push_back(g_signal_connect(
+      settings, "changed::gate-threshold", G_CALLBACK(+[](GSettings* settings, char* key, RNNoise* self) {
+        self->gate.set_threshold(static_cast<float>(g_settings_get_double(settings, key)));
+      }),
+      this));
+
   g_signal_connect(settings, "changed::vad-thres", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                      auto self = static_cast<RNNoise*>(user_data);
 
@@ -114,6 +138,7 @@ RNNoise::RNNoise(const std::string& tag,
   util::warning("The RNNoise library was not available at compilation time. The noise reduction filter won't work");
 
   enable_vad = false;
+  enable_gate = false;
 #endif
 }
 
@@ -122,7 +147,7 @@ RNNoise::~RNNoise() {
     disconnect_from_pw();
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   resampler_ready = false;
 
@@ -134,7 +159,7 @@ RNNoise::~RNNoise() {
 }
 
 void RNNoise::setup() {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   resampler_ready = false;
 
@@ -148,6 +173,8 @@ void RNNoise::setup() {
   deque_out_L.resize(0U);
   deque_out_R.resize(0U);
 
+  gate.reset();
+
   resampler_inL = std::make_unique<Resampler>(rate, rnnoise_rate);
   resampler_inR = std::make_unique<Resampler>(rate, rnnoise_rate);
 
@@ -161,7 +188,7 @@ void RNNoise::process(std::span<float>& left_in,
                       std::span<float>& right_in,
                       std::span<float>& left_out,
                       std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass || !rnnoise_ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -170,9 +197,7 @@ void RNNoise::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in, input_gain);
 
   if (resample) {
     if (resampler_ready) {
@@ -246,14 +271,12 @@ void RNNoise::process(std::span<float>& left_in,
     }
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_output_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(log_tag + name + " latency: " + util::to_string(latency_value, "") + " s");
+    rt_log::debug("{}{} latency: {} s", log_tag, name, latency_value);
 
     util::idle_add([=, this]() {
       if (!post_messages || latency.empty()) {
@@ -268,12 +291,8 @@ void RNNoise::process(std::span<float>& left_in,
     notify_latency = false;
   }
 
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
-    if (send_notifications) {
-      notify();
-    }
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
@@ -315,6 +334,42 @@ auto RNNoise::get_model_from_file() -> RNNModel* {
   return m;
 }
 
+void RNNoise::process_frame(std::vector<float>& data,
+                            std::vector<float>& data_tmp,
+                            DenoiseState* state,
+                            float& vad_prob,
+                            int& vad_grace) {
+  if (state == nullptr) {
+    return;
+  }
+
+  std::ranges::for_each(data, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
+
+  data_tmp = data;
+
+  vad_prob = rnnoise_process_frame(state, data.data(), data.data());
+
+  if (enable_vad) {
+    if (vad_prob >= vad_thres) {
+      vad_grace = release;
+    }
+
+    if (vad_grace < 0) {
+      std::ranges::fill(data, 0.0F);
+
+      return;
+    }
+
+    --vad_grace;
+  }
+
+  for (size_t i = 0U; i < data.size(); i++) {
+    data[i] = data[i] * wet_ratio + data_tmp[i] * (1.0F - wet_ratio);
+
+    data[i] *= inv_short_max;
+  }
+}
+
 void RNNoise::free_rnnoise() {
   rnnoise_ready = false;
 
@@ -44,6 +44,14 @@ void RNNoisePreset::save(nlohmann::json& json) {
   json[section][instance_name]["wet"] = g_settings_get_double(settings, "wet");
 
   json[section][instance_name]["release"] = g_settings_get_double(settings, "release");
+
+  json[section][instance_name]["enable-gate"] = g_settings_get_boolean(settings, "enable-gate") != 0;
+
+  json[section][instance_name]["gate-threshold"] = g_settings_get_double(settings, "gate-threshold");
+
+  json[section][instance_name]["async-mode"] = g_settings_get_boolean(settings, "async-mode") != 0;
+
+  json[section][instance_name]["parallel-channels"] = g_settings_get_boolean(settings, "parallel-channels") != 0;
 }
 
 void RNNoisePreset::load(const nlohmann::json& json) {
@@ -62,4 +70,12 @@ void RNNoisePreset::load(const nlohmann::json& json) {
   update_key<double>(json.at(section).at(instance_name), settings, "wet", "wet");
 
   update_key<double>(json.at(section).at(instance_name), settings, "release", "release");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "enable-gate", "enable-gate");
+
+  update_key<double>(json.at(section).at(instance_name), settings, "gate-threshold", "gate-threshold");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "async-mode", "async-mode");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "parallel-channels", "parallel-channels");
 }
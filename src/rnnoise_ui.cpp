@@ -56,14 +56,14 @@ struct _RNNoiseBox {
 
   GtkScale *input_gain, *output_gain;
 
-  GtkSpinButton *vad_thres, *wet, *release;
+  GtkSpinButton *vad_thres, *wet, *release, *gate_threshold;
 
   GtkLevelBar *input_level_left, *input_level_right, *output_level_left, *output_level_right;
 
   GtkLabel *active_model_name, *model_active_state, *model_error_state, *input_level_left_label,
       *input_level_right_label, *output_level_left_label, *output_level_right_label, *plugin_credit;
 
-  GtkSwitch* enable_vad;
+  GtkSwitch *enable_vad, *enable_gate;
 
   GtkListView* listview;
 
@@ -230,32 +230,36 @@ void setup(RNNoiseBox* self,
     });
   }));
 
-  self->data->connections.push_back(rnnoise->input_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
+  self->data->connections.push_back(rnnoise->input_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
 
-      update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
-                   self->input_level_right_label, left, right);
-    });
-  }));
+          update_level(self->input_level_left, self->input_level_left_label, self->input_level_right,
+                       self->input_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
-  self->data->connections.push_back(rnnoise->output_level.connect([=](const float left, const float right) {
-    util::idle_add([=]() {
-      if (get_ignore_filter_idle_add(serial)) {
-        return;
-      }
+  self->data->connections.push_back(rnnoise->output_level.connect(
+      [=](const float left, const float right, const float left_rms, const float right_rms) {
+        util::idle_add([=]() {
+          if (get_ignore_filter_idle_add(serial)) {
+            return;
+          }
 
-      update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
-                   self->output_level_right_label, left, right);
-    });
-  }));
+          update_level(self->output_level_left, self->output_level_left_label, self->output_level_right,
+                       self->output_level_right_label, left, right, left_rms, right_rms);
+        });
+      }));
 
   gtk_label_set_text(self->plugin_credit, ui::get_plugin_credit_translated(self->data->rnnoise->package).c_str());
 
-  gsettings_bind_widgets<"input-gain", "output-gain", "enable-vad", "vad-thres", "wet", "release">(
-      self->settings, self->input_gain, self->output_gain, self->enable_vad, self->vad_thres, self->wet, self->release);
+  gsettings_bind_widgets<"input-gain", "output-gain", "enable-vad", "vad-thres", "wet", "release", "enable-gate",
+                         "gate-threshold">(self->settings, self->input_gain, self->output_gain, self->enable_vad,
+                                           self->vad_thres, self->wet, self->release, self->enable_gate,
+                                           self->gate_threshold);
 
   g_settings_bind_with_mapping(
       self->settings, "model-path", self->selection_model, "selected", G_SETTINGS_BIND_DEFAULT,
@@ -378,6 +382,8 @@ void rnnoise_box_class_init(RNNoiseBoxClass* klass) {
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, vad_thres);
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, wet);
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, release);
+  gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, enable_gate);
+  gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, gate_threshold);
 
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, string_list);
   gtk_widget_class_bind_template_child(widget_class, RNNoiseBox, selection_model);
@@ -404,6 +410,8 @@ void rnnoise_box_init(RNNoiseBox* self) {
 
   prepare_spinbutton<"%">(self->vad_thres);
 
+  prepare_spinbutton<"dB">(self->gate_threshold);
+
   // The following spinbuttons can assume -inf
   prepare_spinbuttons<"dB", false>(self->wet);
 
@@ -0,0 +1,415 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "rt_audit.hpp"
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "util.hpp"
+
+// glibc functions behind malloc and friends. They are not replaced here, so the wrappers can call them.
+extern "C" {
+auto __libc_malloc(size_t size) -> void*;
+auto __libc_calloc(size_t n, size_t size) -> void*;
+auto __libc_realloc(void* ptr, size_t size) -> void*;
+auto __libc_memalign(size_t alignment, size_t size) -> void*;
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+constexpr size_t max_frames = 24U;
+
+constexpr size_t max_sites = 1024U;
+
+constexpr size_t frames_to_skip = 2U;  // record() and the wrapper
+
+struct Site {
+  std::atomic<uint64_t> key = 0U;  // 0 marks a free slot
+
+  std::atomic<bool> ready = false;
+
+  std::atomic<uint64_t> count = 0U;
+
+  const char* kind = nullptr;
+
+  std::array<char, 32U> plugin{};
+
+  std::array<void*, max_frames> frames{};
+
+  int n_frames = 0;
+
+  bool reported = false;  // only touched by the reporter thread
+};
+
+// Fixed size and constant initialized because malloc may be called before main().
+std::array<Site, max_sites> sites;
+
+std::atomic<bool> enabled = false;
+
+std::atomic<uint64_t> n_dropped = 0U;
+
+thread_local const char* current_plugin = nullptr;
+
+thread_local bool recording = false;
+
+std::thread reporter;
+
+std::mutex reporter_mutex;
+
+std::condition_variable reporter_cv;
+
+bool reporter_running = false;
+
+auto site_hash(const char* kind, const char* plugin, void* const* frames, const int& n_frames) -> uint64_t {
+  // FNV-1a
+
+  uint64_t h = 14695981039346656037U;
+
+  const auto add = [&](const uint64_t& value) {
+    h ^= value;
+    h *= 1099511628211U;
+  };
+
+  add(reinterpret_cast<uintptr_t>(kind));
+
+  for (const auto* c = plugin; *c != '\0'; c++) {
+    add(static_cast<uint64_t>(*c));
+  }
+
+  for (int n = 0; n < n_frames; n++) {
+    add(reinterpret_cast<uintptr_t>(frames[n]));
+  }
+
+  return (h != 0U) ? h : 1U;
+}
+
+/*
+  Called by the wrappers in every thread, so the common path is a single thread local read. Inside a scope it does
+  not allocate: the table has a fixed size and backtrace() was already used once by start().
+*/
+
+void record(const char* kind) {
+  if (current_plugin == nullptr || recording || !enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  recording = true;
+
+  std::array<void*, max_frames> frames{};
+
+  const auto n_frames = backtrace(frames.data(), static_cast<int>(max_frames));
+
+  const auto key = site_hash(kind, current_plugin, frames.data(), n_frames);
+
+  for (size_t n = 0U, slot = key % max_sites; n < max_sites; n++, slot = (slot + 1U) % max_sites) {
+    auto& site = sites[slot];
+
+    auto slot_key = site.key.load(std::memory_order_acquire);
+
+    if (slot_key == 0U) {
+      if (site.key.compare_exchange_strong(slot_key, key, std::memory_order_acq_rel)) {
+        site.kind = kind;
+        site.frames = frames;
+        site.n_frames = n_frames;
+
+        size_t c = 0U;
+
+        for (; c < site.plugin.size() - 1U && current_plugin[c] != '\0'; c++) {
+          site.plugin[c] = current_plugin[c];
+        }
+
+        site.plugin[c] = '\0';
+
+        site.count.fetch_add(1U, std::memory_order_relaxed);
+
+        site.ready.store(true, std::memory_order_release);
+
+        recording = false;
+
+        return;
+      }
+    }
+
+    if (slot_key == key) {
+      site.count.fetch_add(1U, std::memory_order_relaxed);
+
+      recording = false;
+
+      return;
+    }
+  }
+
+  n_dropped.fetch_add(1U, std::memory_order_relaxed);
+
+  recording = false;
+}
+
+auto demangle(const std::string& symbol) -> std::string {
+  // backtrace_symbols() gives "binary(mangled+offset) [address]"
+
+  const auto begin = symbol.find('(');
+  const auto end = symbol.find('+', begin);
+
+  if (begin == std::string::npos || end == std::string::npos || end == begin + 1U) {
+    return symbol;
+  }
+
+  int status = 0;
+
+  auto* name = abi::__cxa_demangle(symbol.substr(begin + 1U, end - begin - 1U).c_str(), nullptr, nullptr, &status);
+
+  if (status != 0 || name == nullptr) {
+    return symbol;
+  }
+
+  std::string output = symbol.substr(0U, begin + 1U) + name + symbol.substr(end);
+
+  std::free(name);
+
+  return output;
+}
+
+void report_new_sites() {
+  for (auto& site : sites) {
+    if (site.reported || !site.ready.load(std::memory_order_acquire)) {
+      continue;
+    }
+
+    site.reported = true;
+
+    std::string text = "rt audit: " + std::string(site.kind) + " called by " + site.plugin.data() +
+                       " in the realtime thread\n";
+
+    if (auto** symbols = backtrace_symbols(site.frames.data(), site.n_frames); symbols != nullptr) {
+      for (int n = frames_to_skip; n < site.n_frames; n++) {
+        text += "    " + demangle(symbols[n]) + "\n";
+      }
+
+      std::free(static_cast<void*>(symbols));
+    }
+
+    util::warning(text);
+  }
+}
+
+template <typename F>
+auto next_symbol(const char* name) -> F {
+  return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+
+}  // namespace
+
+namespace rt_audit {
+
+Scope::Scope(const char* plugin_name) : previous_plugin(current_plugin) {
+  current_plugin = plugin_name;
+}
+
+Scope::~Scope() {
+  current_plugin = previous_plugin;
+}
+
+void start() {
+  // The first backtrace() loads the unwinder, which allocates. It must not happen inside a scope.
+
+  std::array<void*, 4U> frames{};
+
+  backtrace(frames.data(), static_cast<int>(frames.size()));
+
+  reporter_running = true;
+
+  reporter = std::thread([]() {
+    std::unique_lock<std::mutex> lock(reporter_mutex);
+
+    while (reporter_running) {
+      reporter_cv.wait_for(lock, std::chrono::seconds(1));
+
+      report_new_sites();
+    }
+  });
+
+  enabled = true;
+
+  util::warning("rt audit: enabled");
+}
+
+void stop() {
+  enabled = false;
+
+  if (reporter.joinable()) {
+    {
+      std::scoped_lock<std::mutex> lock(reporter_mutex);
+
+      reporter_running = false;
+    }
+
+    reporter_cv.notify_one();
+
+    reporter.join();
+  }
+
+  report_new_sites();
+
+  std::map<std::string, std::map<std::string, uint64_t>> summary;
+
+  for (const auto& site : sites) {
+    if (site.ready.load(std::memory_order_acquire)) {
+      summary[site.plugin.data()][site.kind] += site.count.load();
+    }
+  }
+
+  for (const auto& [plugin, kinds] : summary) {
+    std::string text = "rt audit: " + plugin + ":";
+
+    for (const auto& [kind, count] : kinds) {
+      text += " " + util::to_string(count) + " " + kind;
+    }
+
+    util::warning(text);
+  }
+
+  if (const auto dropped = n_dropped.load(); dropped > 0U) {
+    util::warning("rt audit: " + util::to_string(dropped) + " violations did not fit in the table");
+  }
+}
+
+}  // namespace rt_audit
+
+// Replacements. Outside a scope they only forward the call.
+
+extern "C" {
+
+auto malloc(size_t size) noexcept -> void* {
+  record("malloc");
+
+  return __libc_malloc(size);
+}
+
+auto calloc(size_t n, size_t size) noexcept -> void* {
+  record("calloc");
+
+  return __libc_calloc(n, size);
+}
+
+auto realloc(void* ptr, size_t size) noexcept -> void* {
+  record("realloc");
+
+  return __libc_realloc(ptr, size);
+}
+
+auto aligned_alloc(size_t alignment, size_t size) noexcept -> void* {
+  record("aligned_alloc");
+
+  return __libc_memalign(alignment, size);
+}
+
+auto memalign(size_t alignment, size_t size) noexcept -> void* {
+  record("memalign");
+
+  return __libc_memalign(alignment, size);
+}
+
+auto posix_memalign(void** ptr, size_t alignment, size_t size) noexcept -> int {
+  record("posix_memalign");
+
+  *ptr = __libc_memalign(alignment, size);
+
+  return (*ptr != nullptr) ? 0 : ENOMEM;
+}
+
+void free(void* ptr) noexcept {
+  if (ptr != nullptr) {
+    record("free");
+  }
+
+  __libc_free(ptr);
+}
+
+auto pthread_mutex_lock(pthread_mutex_t* mutex) noexcept -> int {
+  static auto* real = next_symbol<int (*)(pthread_mutex_t*)>("pthread_mutex_lock");
+
+  record("pthread_mutex_lock");
+
+  return real(mutex);
+}
+
+auto read(int fd, void* buffer, size_t count) -> ssize_t {
+  static auto* real = next_symbol<ssize_t (*)(int, void*, size_t)>("read");
+
+  record("read");
+
+  return real(fd, buffer, count);
+}
+
+auto write(int fd, const void* buffer, size_t count) -> ssize_t {
+  static auto* real = next_symbol<ssize_t (*)(int, const void*, size_t)>("write");
+
+  record("write");
+
+  return real(fd, buffer, count);
+}
+
+auto poll(pollfd* fds, nfds_t n_fds, int timeout) -> int {
+  static auto* real = next_symbol<int (*)(pollfd*, nfds_t, int)>("poll");
+
+  record("poll");
+
+  return real(fds, n_fds, timeout);
+}
+
+auto nanosleep(const timespec* duration, timespec* remaining) -> int {
+  static auto* real = next_symbol<int (*)(const timespec*, timespec*)>("nanosleep");
+
+  record("nanosleep");
+
+  return real(duration, remaining);
+}
+
+auto clock_nanosleep(clockid_t clock, int flags, const timespec* request, timespec* remaining) -> int {
+  static auto* real = next_symbol<int (*)(clockid_t, int, const timespec*, timespec*)>("clock_nanosleep");
+
+  record("clock_nanosleep");
+
+  return real(clock, flags, request, remaining);
+}
+
+auto usleep(useconds_t duration) -> int {
+  static auto* real = next_symbol<int (*)(useconds_t)>("usleep");
+
+  record("usleep");
+
+  return real(duration);
+}
+}
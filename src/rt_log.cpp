@@ -0,0 +1,202 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "rt_log.hpp"
+#include <fmt/args.h>
+#include <fmt/format.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+/*
+  Bounded multi producer queue. Every cell has a sequence number telling whether it is free for the producer that
+  claimed its position or ready for the consumer. Producers never wait: they give up when the queue is full.
+*/
+
+class Ring {
+ public:
+  Ring() {
+    for (size_t n = 0U; n < capacity; n++) {
+      cells[n].sequence.store(n, std::memory_order_relaxed);
+    }
+  }
+
+  auto push(const rt_log::Entry& entry) -> bool {
+    auto position = write_position.load(std::memory_order_relaxed);
+
+    while (true) {
+      auto& cell = cells[position % capacity];
+
+      const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+      if (sequence == position) {
+        if (write_position.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+          cell.entry = entry;
+
+          cell.sequence.store(position + 1U, std::memory_order_release);
+
+          return true;
+        }
+      } else if (sequence < position) {
+        return false;  // full
+      } else {
+        position = write_position.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Only one consumer
+  auto pop(rt_log::Entry& entry) -> bool {
+    auto& cell = cells[read_position % capacity];
+
+    if (cell.sequence.load(std::memory_order_acquire) != read_position + 1U) {
+      return false;
+    }
+
+    entry = cell.entry;
+
+    cell.sequence.store(read_position + capacity, std::memory_order_release);
+
+    read_position++;
+
+    return true;
+  }
+
+ private:
+  static constexpr size_t capacity = 256U;
+
+  struct Cell {
+    std::atomic<size_t> sequence = 0U;
+
+    rt_log::Entry entry;
+  };
+
+  std::array<Cell, capacity> cells;
+
+  std::atomic<size_t> write_position = 0U;
+
+  size_t read_position = 0U;
+};
+
+Ring ring;
+
+std::atomic<uint64_t> n_dropped = 0U;
+
+std::atomic<bool> running = false;
+
+std::thread consumer;
+
+void emit(const rt_log::Entry& entry) {
+  fmt::dynamic_format_arg_store<fmt::format_context> store;
+
+  for (size_t n = 0U; n < entry.n_args; n++) {
+    const auto& arg = entry.args[n];
+
+    switch (arg.type) {
+      case rt_log::Arg::Type::integer:
+        store.push_back(arg.integer);
+        break;
+      case rt_log::Arg::Type::unsigned_integer:
+        store.push_back(arg.unsigned_integer);
+        break;
+      case rt_log::Arg::Type::real:
+        store.push_back(arg.real);
+        break;
+      case rt_log::Arg::Type::real_float:
+        store.push_back(static_cast<float>(arg.real));
+        break;
+      case rt_log::Arg::Type::text:
+        store.push_back(std::string(arg.text.data()));
+        break;
+    }
+  }
+
+  std::string message;
+
+  try {
+    message = fmt::vformat(entry.format, store);
+  } catch (const fmt::format_error& e) {
+    message = std::string(entry.format) + " (" + e.what() + ")";
+  }
+
+  switch (entry.level) {
+    case rt_log::Level::warning:
+      util::warning(message, entry.location);
+      break;
+    case rt_log::Level::info:
+      util::info(message, entry.location);
+      break;
+    default:
+      util::debug(message, entry.location);
+      break;
+  }
+}
+
+void drain() {
+  rt_log::Entry entry;
+
+  while (ring.pop(entry)) {
+    emit(entry);
+  }
+
+  if (const auto dropped = n_dropped.exchange(0U); dropped > 0U) {
+    util::warning(util::to_string(dropped) + " realtime log messages were dropped because the queue was full");
+  }
+}
+
+}  // namespace
+
+namespace rt_log {
+
+void push(const Entry& entry) {
+  if (!ring.push(entry)) {
+    n_dropped.fetch_add(1U, std::memory_order_relaxed);
+  }
+}
+
+void start() {
+  if (running.exchange(true)) {
+    return;
+  }
+
+  // Polling keeps the producers free of system calls. The messages are only for debugging, so a small delay is fine.
+
+  consumer = std::thread([]() {
+    while (running.load()) {
+      drain();
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    drain();
+  });
+}
+
+void stop() {
+  if (!running.exchange(false)) {
+    return;
+  }
+
+  consumer.join();
+}
+
+}  // namespace rt_log
@@ -0,0 +1,76 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "silence_gate.hpp"
+#include <algorithm>
+#include <cmath>
+
+void SilenceGate::set_rate(const uint& value) {
+  rate = value;
+
+  update_constants();
+}
+
+void SilenceGate::set_threshold(const float& db) {
+  // The detector works on the mean square, so the threshold is converted to linear power.
+
+  threshold = std::pow(10.0F, db / 10.0F);
+}
+
+void SilenceGate::set_hold_time(const float& seconds) {
+  hold_time = seconds;
+
+  update_constants();
+}
+
+void SilenceGate::set_fade_time(const float& seconds) {
+  fade_time = seconds;
+
+  update_constants();
+}
+
+void SilenceGate::set_keep_warm_interval(const uint& n_frames) {
+  keep_warm_interval = std::max(n_frames, 1U);
+}
+
+void SilenceGate::reset() {
+  gain = 1.0F;
+  target = 1.0F;
+
+  skipped_frames = 0U;
+  hold_remaining = hold_samples;
+}
+
+void SilenceGate::open() {
+  hold_remaining = hold_samples;
+
+  target = 1.0F;
+}
+
+auto SilenceGate::is_open() const -> bool {
+  return target == 1.0F || gain > 0.0F;
+}
+
+void SilenceGate::update_constants() {
+  hold_samples = static_cast<uint>(std::lrint(hold_time * static_cast<float>(rate)));
+
+  const auto fade_samples = std::max(static_cast<float>(std::lrint(fade_time * static_cast<float>(rate))), 1.0F);
+
+  step = 1.0F / fade_samples;
+}
@@ -23,22 +23,48 @@ Spectrum::Spectrum(const std::string& tag,
                    const std::string& schema,
                    const std::string& schema_path,
                    PipeManager* pipe_manager)
-    : PluginBase(tag, "spectrum", tags::plugin_package::ee, schema, schema_path, pipe_manager), fftw_ready(true) {
-  real_input.resize(n_bands);
-  output.resize(n_bands / 2U + 1U);
+    : PluginBase(tag, "spectrum", tags::plugin_package::ee, schema, schema_path, pipe_manager) {
+  chunk_L.resize(1024U);
+  chunk_R.resize(1024U);
 
-  complex_output = fftwf_alloc_complex(n_bands);
-
-  plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n_bands), real_input.data(), complex_output, FFTW_ESTIMATE);
+  init_fft(512U << g_settings_get_enum(settings, "fft-size"), g_settings_get_int(settings, "overlap"));
 
   g_signal_connect(settings, "changed::show", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
                      auto* self = static_cast<Spectrum*>(user_data);
 
-                     std::scoped_lock<std::mutex> lock(self->data_mutex);
+                     std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                      self->bypass = g_settings_get_boolean(settings, key) == 0;
                    }),
                    this);
+
+  g_signal_connect(settings, "changed::fft-size", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                     auto* self = static_cast<Spectrum*>(user_data);
+
+                     self->init_fft(512U << g_settings_get_enum(settings, key),
+                                    g_settings_get_int(settings, "overlap"));
+                   }),
+                   this);
+
+  g_signal_connect(settings, "changed::overlap", G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                     auto* self = static_cast<Spectrum*>(user_data);
+
+                     self->init_fft(512U << g_settings_get_enum(settings, "fft-size"),
+                                    g_settings_get_int(settings, key));
+                   }),
+                   this);
+
+  for (const auto* signal : {"changed::mode", "changed::fft-size", "changed::n-points", "changed::minimum-frequency",
+                          "changed::maximum-frequency", "changed::octave-smoothing"}) {
+    g_signal_connect(settings, signal, G_CALLBACK(+[](GSettings* settings, char* key, gpointer user_data) {
+                       auto* self = static_cast<Spectrum*>(user_data);
+
+                       self->init_multi_resolution();
+                     }),
+                     this);
+  }
+
+  analysis_job_id = AnalysisThread::get().add_job([this]() { analyze(); });
 }
 
 Spectrum::~Spectrum() {
@@ -46,7 +72,9 @@ Spectrum::~Spectrum() {
     disconnect_from_pw();
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  AnalysisThread::get().remove_job(analysis_job_id);
+
+  std::scoped_lock<std::mutex> lock(analysis_mutex);
 
   fftw_ready = false;
 
@@ -54,84 +82,257 @@ Spectrum::~Spectrum() {
     fftwf_free(complex_output);
   }
 
-  fftwf_destroy_plan(plan);
+  if (plan != nullptr) {
+    fftwf_destroy_plan(plan);
+  }
 
   util::debug(log_tag + name + " destroyed");
 }
 
-void Spectrum::setup() {
-  deque_in_mono.resize(0U);
-
-  std::ranges::fill(real_input, 0.0F);
-
+void Spectrum::init_fft(const uint& fft_size, const int& overlap) {
   /*
-    real_input size is hardcoded to 8192. THe same maxium buffer size hardcoded in PipeWire
-    https://gitlab.freedesktop.org/pipewire/pipewire/-/blob/master/src/pipewire/filter.c#L48. If we reevei a smaller
-    array we have to insert some zeros in the beginning.
+    Everything is allocated and planned before taking the lock so the analysis thread is not blocked by the FFTW
+    planner. The plan keeps pointing to the right memory after the swap because std::vector::swap does not move the
+    elements.
   */
 
-  if (n_samples < real_input.size()) {
-    while (deque_in_mono.size() != real_input.size() - n_samples) {
-      deque_in_mono.push_back(0.0F);
+  std::vector<float> new_input(fft_size, 0.0F);
+  std::vector<float> new_window(fft_size);
+  std::vector<float> new_history(fft_size, 0.0F);
+  std::vector<float> new_accumulated(fft_size / 2U + 1U, 0.0F);
+  std::vector<double> new_output(fft_size / 2U + 1U, 0.0);
+
+  // https://en.wikipedia.org/wiki/Hann_function
+
+  for (uint n = 0U; n < fft_size; n++) {
+    new_window[n] = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
+                                            static_cast<float>(fft_size - 1U)));
+  }
+
+  auto* new_complex_output = fftwf_alloc_complex(fft_size / 2U + 1U);
+
+  auto* new_plan =
+      fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), new_input.data(), new_complex_output, FFTW_ESTIMATE);
+
+  analysis_mutex.lock();
+
+  std::swap(plan, new_plan);
+  std::swap(complex_output, new_complex_output);
+
+  real_input.swap(new_input);
+  window.swap(new_window);
+  history.swap(new_history);
+  accumulated.swap(new_accumulated);
+  output.swap(new_output);
+
+  n_bands = fft_size;
+
+  hop_size = (overlap > 0) ? std::max(fft_size * static_cast<uint>(100 - overlap) / 100U, 1U) : 0U;
+
+  history_pos = 0U;
+  samples_since_fft = 0U;
+  n_accumulated = 0U;
+
+  fftw_ready = true;
+
+  analysis_mutex.unlock();
+
+  if (new_plan != nullptr) {
+    fftwf_destroy_plan(new_plan);
+  }
+
+  if (new_complex_output != nullptr) {
+    fftwf_free(new_complex_output);
+  }
+
+  util::debug(log_tag + name + " fft size: " + util::to_string(n_bands) + ", hop: " + util::to_string(hop_size));
+}
+
+void Spectrum::init_multi_resolution() {
+  std::unique_ptr<MultiResolutionSpectrum> new_analyzer;
+
+  if (util::gsettings_get_string(settings, "mode") == "Multi-resolution" && rate != 0U) {
+    const auto min_freq = static_cast<double>(g_settings_get_int(settings, "minimum-frequency"));
+    const auto max_freq = static_cast<double>(g_settings_get_int(settings, "maximum-frequency"));
+
+    const auto smoothing = SpectrumMapping::octave_fraction(g_settings_get_enum(settings, "octave-smoothing"));
+
+    new_analyzer = std::make_unique<MultiResolutionSpectrum>(
+        rate, 512U << g_settings_get_enum(settings, "fft-size"),
+        util::logspace(min_freq, max_freq, g_settings_get_int(settings, "n-points")), smoothing);
+  }
+
+  // the old analyzer is destroyed after the lock is released
+
+  analysis_mutex.lock();
+
+  multi_resolution.swap(new_analyzer);
+
+  analysis_mutex.unlock();
+}
+
+void Spectrum::setup() {
+  util::idle_add([this]() {
+    if (multi_resolution != nullptr && multi_resolution->get_rate() == rate) {
+      return;
     }
+
+    init_multi_resolution();
+  });
+}
+
+void Spectrum::run_fft() {
+  // unwrapping the circular buffer so the oldest sample goes to the beginning of the window
+
+  const auto n_tail = n_bands - history_pos;
+
+  for (uint n = 0U; n < n_tail; n++) {
+    real_input[n] = history[history_pos + n] * window[n];
+  }
+
+  for (uint n = n_tail; n < n_bands; n++) {
+    real_input[n] = history[n - n_tail] * window[n];
+  }
+
+  fftwf_execute(plan);
+
+  const auto norm = static_cast<float>(accumulated.size() * accumulated.size());
+
+  for (uint i = 0U; i < accumulated.size(); i++) {
+    accumulated[i] +=
+        (complex_output[i][0] * complex_output[i][0] + complex_output[i][1] * complex_output[i][1]) / norm;
   }
+
+  n_accumulated++;
+
+  samples_since_fft = 0U;
 }
 
 void Spectrum::process(std::span<float>& left_in,
                        std::span<float>& right_in,
                        std::span<float>& left_out,
                        std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   std::copy(left_in.begin(), left_in.end(), left_out.begin());
   std::copy(right_in.begin(), right_in.end(), right_out.begin());
 
-  if (bypass || !fftw_ready) {
+  // nothing is analyzed while no chart is showing the spectrum
+
+  if (bypass || !post_messages) {
     return;
   }
 
-  for (uint n = 0U; n < left_in.size(); n++) {
-    deque_in_mono.push_back(0.5F * (left_in[n] + right_in[n]));
+  if (!tap.external) {
+    tap.write(left_in, right_in);
   }
 
-  for (size_t n = 0; n < deque_in_mono.size(); n++) {
-    if (n < real_input.size()) {
-      // https :  // en.wikipedia.org/wiki/Hann_function
+  if (send_notifications) {
+    frame_due = true;
+  }
 
-      const float w = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
-                                              static_cast<float>(real_input.size() - 1U)));
+  AnalysisThread::get().wake();
+}
 
-      real_input[n] = deque_in_mono[n] * w;
-    }
+void Spectrum::analyze() {
+  std::scoped_lock<std::mutex> lock(analysis_mutex);
+
+  if (!fftw_ready) {
+    return;
   }
 
-  size_t count = 0U;
+  while (true) {
+    const auto n_read = std::min({tap.left.read_available(), tap.right.read_available(), chunk_L.size()});
 
-  while (count < n_samples && !deque_in_mono.empty()) {
-    deque_in_mono.pop_front();
+    if (n_read == 0U) {
+      break;
+    }
 
-    count++;
-  }
+    tap.left.pop(std::span(chunk_L.data(), n_read));
+    tap.right.pop(std::span(chunk_R.data(), n_read));
 
-  fftwf_execute(plan);
+    if (multi_resolution != nullptr) {
+      for (size_t n = 0U; n < n_read; n++) {
+        chunk_L[n] = 0.5F * (chunk_L[n] + chunk_R[n]);
+      }
 
-  for (uint i = 0U; i < output.size(); i++) {
-    float sqr = complex_output[i][0] * complex_output[i][0] + complex_output[i][1] * complex_output[i][1];
+      multi_resolution->add_samples(std::span<const float>(chunk_L.data(), n_read));
+
+      continue;
+    }
+
+    /*
+      With overlap the spectra computed every hop are averaged until the next frame is due. A hop can be shorter than
+      a chunk, so the chunk is written in steps that end where a transform is due. Without overlap the transform only
+      runs when the UI is going to receive a new frame.
+    */
+
+    for (size_t offset = 0U; offset < n_read;) {
+      auto n = n_read - offset;
 
-    sqr /= static_cast<float>(output.size() * output.size());
+      if (hop_size != 0U) {
+        n = std::min(n, static_cast<size_t>(samples_since_fft < hop_size ? hop_size - samples_since_fft : 1U));
+      }
+
+      for (size_t k = offset; k < offset + n; k++) {
+        history[history_pos] = 0.5F * (chunk_L[k] + chunk_R[k]);
+
+        if (++history_pos == n_bands) {
+          history_pos = 0U;
+        }
+      }
+
+      offset += n;
+
+      samples_since_fft += n;
+
+      if (hop_size != 0U && samples_since_fft >= hop_size) {
+        run_fft();
+      }
+    }
+  }
 
-    output[i] = static_cast<double>(sqr);
+  if (!frame_due.exchange(false)) {
+    return;
   }
 
-  if (send_notifications) {
-    util::idle_add([=, this]() {
-      if (bypass) {
+  if (multi_resolution != nullptr) {
+    const auto t0 = std::chrono::steady_clock::now();
+
+    multi_resolution->compute(output_db);
+
+    const auto cost = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    util::idle_add([=, this, frequencies = multi_resolution->get_frequencies(), magnitudes = output_db]() {
+      if (bypass || !post_messages) {
         return;
       }
 
-      power.emit(rate, output.size(), output);
+      log_power.emit(frequencies, magnitudes, cost);
     });
+
+    return;
   }
+
+  if (n_accumulated == 0U) {
+    run_fft();
+  }
+
+  for (uint i = 0U; i < output.size(); i++) {
+    output[i] = static_cast<double>(accumulated[i] / static_cast<float>(n_accumulated));
+  }
+
+  std::ranges::fill(accumulated, 0.0F);
+
+  n_accumulated = 0U;
+
+  util::idle_add([=, this, magnitudes = output]() {
+    if (bypass || !post_messages) {
+      return;
+    }
+
+    power.emit(rate, magnitudes.size(), magnitudes);
+  });
 }
 
 auto Spectrum::get_latency_seconds() -> float {
@@ -0,0 +1,141 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spectrum_mapping.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "util.hpp"
+
+auto SpectrumMapping::octave_fraction(const int& index) -> double {
+  constexpr std::array<double, 6> fractions{0.0, 1.0 / 24.0, 1.0 / 12.0, 1.0 / 6.0, 1.0 / 3.0, 1.0};
+
+  return fractions.at(static_cast<size_t>(std::clamp(index, 0, static_cast<int>(fractions.size()) - 1)));
+}
+
+void SpectrumMapping::init(const uint& rate,
+                           const uint& n_bins,
+                           const std::vector<double>& x_axis,
+                           const double& smoothing) {
+  this->rate = rate;
+  this->n_bins = n_bins;
+
+  first_bin.clear();
+  offsets.clear();
+  weights.clear();
+
+  if (n_bins < 2U || x_axis.empty()) {
+    return;
+  }
+
+  // The analyzer returns fft_size / 2 + 1 bins going from 0 Hz to the Nyquist frequency.
+
+  const auto bin_width = 0.5 * static_cast<double>(rate) / static_cast<double>(n_bins - 1U);
+
+  const auto last_bin = static_cast<double>(n_bins - 1U);
+
+  const auto n_points = x_axis.size();
+
+  const auto half_smoothing = std::pow(2.0, 0.5 * smoothing);
+
+  first_bin.resize(n_points);
+  offsets.resize(n_points + 1U);
+
+  for (size_t n = 0U; n < n_points; n++) {
+    const auto f = x_axis[n];
+
+    auto f_low = (n > 0U) ? std::sqrt(x_axis[n - 1U] * f) : f;
+    auto f_high = (n + 1U < n_points) ? std::sqrt(f * x_axis[n + 1U]) : f;
+
+    // the points at the edges get a band that is symmetric in octaves
+
+    if (n == 0U) {
+      f_low = f * f / f_high;
+    }
+
+    if (n + 1U == n_points) {
+      f_high = f * f / f_low;
+    }
+
+    f_low = std::min(f_low, f / half_smoothing);
+    f_high = std::max(f_high, f * half_smoothing);
+
+    const auto k_low = std::clamp(std::ceil(f_low / bin_width), 0.0, last_bin);
+    const auto k_high = std::clamp(std::floor(f_high / bin_width), 0.0, last_bin);
+
+    offsets[n] = static_cast<uint>(weights.size());
+
+    if (k_high >= k_low) {
+      // dense region: average of the bins inside the band
+
+      const auto count = static_cast<uint>(k_high - k_low) + 1U;
+
+      first_bin[n] = static_cast<uint>(k_low);
+
+      weights.insert(weights.end(), count, 1.0 / static_cast<double>(count));
+    } else {
+      // sparse region: interpolation between the two closest bins
+
+      const auto k = std::clamp(f / bin_width, 0.0, last_bin - 1.0);
+
+      const auto k0 = std::floor(k);
+
+      const auto t = k - k0;
+
+      first_bin[n] = static_cast<uint>(k0);
+
+      weights.push_back(1.0 - t);
+      weights.push_back(t);
+    }
+  }
+
+  offsets[n_points] = static_cast<uint>(weights.size());
+}
+
+auto SpectrumMapping::is_valid(const uint& rate, const uint& n_bins) const -> bool {
+  return !first_bin.empty() && this->rate == rate && this->n_bins == n_bins;
+}
+
+void SpectrumMapping::map(const std::vector<double>& bins, std::vector<double>& output_db) const {
+  const auto n_points = first_bin.size();
+
+  output_db.resize(n_points);
+
+  if (bins.size() != n_bins) {
+    std::ranges::fill(output_db, util::minimum_db_level);
+
+    return;
+  }
+
+  for (size_t n = 0U; n < n_points; n++) {
+    const auto* w = weights.data() + offsets[n];
+    const auto* b = bins.data() + first_bin[n];
+
+    const auto count = offsets[n + 1U] - offsets[n];
+
+    double v = 0.0;
+
+    for (uint m = 0U; m < count; m++) {
+      v += w[m] * b[m];
+    }
+
+    output_db[n] = (v > 0.0) ? std::max(10.0 * std::log10(v), static_cast<double>(util::minimum_db_level))
+                             : static_cast<double>(util::minimum_db_level);
+  }
+}
@@ -34,7 +34,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(g_signal_connect(
       settings, "changed::enable-denoise", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->enable_denoise = g_settings_get_boolean(settings, key);
 
@@ -50,7 +50,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(g_signal_connect(
       settings, "changed::noise-suppression", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->noise_suppression = g_settings_get_int(settings, key);
 
@@ -66,7 +66,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(
       g_signal_connect(settings, "changed::enable-agc", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-                         std::scoped_lock<std::mutex> lock(self->data_mutex);
+                         std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                          self->enable_agc = g_settings_get_boolean(settings, key);
 
@@ -82,7 +82,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(
       g_signal_connect(settings, "changed::enable-vad", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-                         std::scoped_lock<std::mutex> lock(self->data_mutex);
+                         std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
                          self->enable_vad = g_settings_get_boolean(settings, key);
 
@@ -98,7 +98,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(g_signal_connect(
       settings, "changed::vad-probability-start", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->vad_probability_start = g_settings_get_int(settings, key);
 
@@ -114,7 +114,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(g_signal_connect(
       settings, "changed::vad-probability-continue", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->vad_probability_continue = g_settings_get_int(settings, key);
 
@@ -130,7 +130,7 @@ Speex::Speex(const std::string& tag,
 
   gconnections.push_back(g_signal_connect(
       settings, "changed::enable-dereverb", G_CALLBACK(+[](GSettings* settings, char* key, Speex* self) {
-        std::scoped_lock<std::mutex> lock(self->data_mutex);
+        std::scoped_lock<MonitoredMutex> lock(self->data_mutex);
 
         self->enable_dereverb = g_settings_get_boolean(settings, key);
 
@@ -153,7 +153,7 @@ Speex::~Speex() {
     disconnect_from_pw();
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   free_speex();
 
@@ -161,7 +161,7 @@ Speex::~Speex() {
 }
 
 void Speex::setup() {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   latency_n_frames = 0U;
 
@@ -214,7 +214,7 @@ void Speex::process(std::span<float>& left_in,
                     std::span<float>& right_in,
                     std::span<float>& left_out,
                     std::span<float>& right_out) {
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  std::scoped_lock<MonitoredMutex> lock(data_mutex);
 
   if (bypass || !speex_ready) {
     std::copy(left_in.begin(), left_in.end(), left_out.begin());
@@ -223,44 +223,16 @@ void Speex::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
-
-
-  for (size_t i = 0; i < n_samples; i++) {
-    data_L[i] = static_cast<spx_int16_t>(left_in[i] * (SHRT_MAX + 1));
+  apply_input_gain(left_in, right_in, input_gain);
 
-    data_R[i] = static_cast<spx_int16_t>(right_in[i] * (SHRT_MAX + 1));
-  }
-
-  if (speex_preprocess_run(state_left, data_L.data()) == 1) {
-    for (size_t i = 0; i < n_samples; i++) {
-      left_out[i] = static_cast<float>(data_L[i]) * inv_short_max;
-    }
-  } else {
-    std::ranges::fill(left_out, 0.0F);
-  }
 
-  if (speex_preprocess_run(state_right, data_R.data()) == 1) {
-    for (size_t i = 0; i < n_samples; i++) {
-      right_out[i] = static_cast<float>(data_R[i]) * inv_short_max;
-    }
-  } else {
-    std::ranges::fill(right_out, 0.0F);
-  }
+  channel_worker.run([&]() { process_channel(left_in, left_out, data_L, state_left); },
+                     [&]() { process_channel(right_in, right_out, data_R, state_right); });
 
+  apply_output_gain(left_out, right_out, output_gain);
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (post_messages) {
-    get_peaks(left_in, right_in, left_out, right_out);
-
-    if (send_notifications) {
-      notify();
-    }
+  if (post_messages && send_notifications) {
+    notify();
   }
 }
 
@@ -279,6 +251,23 @@ void Speex::free_speex() {
 }
 
 
+void Speex::process_channel(const std::span<float>& in,
+                            std::span<float>& out,
+                            std::vector<spx_int16_t>& data,
+                            SpeexPreprocessState* state) {
+  for (size_t i = 0; i < n_samples; i++) {
+    data[i] = static_cast<spx_int16_t>(in[i] * (SHRT_MAX + 1));
+  }
+
+  if (speex_preprocess_run(state, data.data()) == 1) {
+    for (size_t i = 0; i < n_samples; i++) {
+      out[i] = static_cast<float>(data[i]) * inv_short_max;
+    }
+  } else {
+    std::ranges::fill(out, 0.0F);
+  }
+}
+
 auto Speex::get_latency_seconds() -> float {
   return latency_value;
 }
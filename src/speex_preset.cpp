@@ -49,6 +49,8 @@ void SpeexPreset::save(nlohmann::json& json) {
       g_settings_get_int(settings, "vad-probability-continue");
 
   json[section][instance_name]["enable-dereverb"] = g_settings_get_boolean(settings, "enable-dereverb") != 0;
+
+  json[section][instance_name]["parallel-channels"] = g_settings_get_boolean(settings, "parallel-channels") != 0;
 }
 
 void SpeexPreset::load(const nlohmann::json& json) {
@@ -72,4 +74,6 @@ void SpeexPreset::load(const nlohmann::json& json) {
                   "probability-continue");
 
   update_key<bool>(json.at(section).at(instance_name), settings, "enable-dereverb", "enable-dereverb");
+
+  update_key<bool>(json.at(section).at(instance_name), settings, "parallel-channels", "parallel-channels");
 }
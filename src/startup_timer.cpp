@@ -0,0 +1,104 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "startup_timer.hpp"
+#include <fmt/core.h>
+#include <mutex>
+#include "rt_log.hpp"
+#include "tracer.hpp"
+#include "util.hpp"
+
+namespace {
+
+// Dynamic initialization runs before main(), so this is close enough to the start of the process.
+const uint64_t process_start_ns = tracer::now_ns();
+
+std::atomic<uint64_t> first_audio_ns = 0U;
+
+std::mutex phases_mutex;
+
+std::vector<startup_timer::Record> phases;
+
+auto to_seconds(const uint64_t& t) -> double {
+  return static_cast<double>(t - process_start_ns) * 1e-9;
+}
+
+}  // namespace
+
+namespace startup_timer {
+
+std::atomic<bool> audio_seen = false;
+
+void on_first_audio() {
+  // Several chains may get their first buffer in the same cycle. Only one of them records it.
+
+  if (audio_seen.exchange(true)) {
+    return;
+  }
+
+  const auto t = tracer::now_ns();
+
+  first_audio_ns.store(t, std::memory_order_release);
+
+  tracer::instant("first processed audio", "startup");
+
+  rt_log::info("time to first processed audio: {:.3f} s", to_seconds(t));
+}
+
+auto get_first_audio_seconds() -> double {
+  const auto t = first_audio_ns.load(std::memory_order_acquire);
+
+  return (t != 0U) ? to_seconds(t) : -1.0;
+}
+
+auto get_phases() -> std::vector<Record> {
+  std::scoped_lock<std::mutex> lock(phases_mutex);
+
+  return phases;
+}
+
+void report() {
+  std::string text;
+
+  for (const auto& record : get_phases()) {
+    text += fmt::format("{}{}: {:.3f} s", text.empty() ? "" : ", ", record.name, record.end - record.start);
+  }
+
+  util::info(fmt::format("startup phases: {}. Ready {:.3f} s after the start of the process", text,
+                         to_seconds(tracer::now_ns())));
+}
+
+Phase::Phase(const char* name) : name(name), start_ns(tracer::now_ns()) {}
+
+Phase::~Phase() {
+  const auto end_ns = tracer::now_ns();
+
+  if (tracer::is_enabled()) {
+    tracer::record(name, "startup", nullptr, start_ns, end_ns);
+  }
+
+  util::debug(fmt::format("startup phase {} took {:.3f} s", name, static_cast<double>(end_ns - start_ns) * 1e-9));
+
+  std::scoped_lock<std::mutex> lock(phases_mutex);
+
+  phases.push_back({.name = name, .start = to_seconds(start_ns), .end = to_seconds(end_ns)});
+}
+
+}  // namespace startup_timer
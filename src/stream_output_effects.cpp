@@ -216,6 +216,10 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
   // link plugins
 
   if (!list.empty()) {
+    // Asking PipeWire for all the filters at once is much faster than waiting for each one in turn.
+
+    request_filters_connection(list);
+
     for (const auto& name : list) {
       if (!plugins.contains(name)) {
         continue;
@@ -0,0 +1,270 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include "tracer.hpp"
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include "util.hpp"
+
+namespace {
+
+constexpr size_t ring_size = 8192U;
+
+// Threads that record after all the rings were claimed are not traced.
+constexpr size_t max_rings = 48U;
+
+struct Event {
+  const char* name = nullptr;
+
+  const char* category = nullptr;
+
+  std::array<char, 48U> detail{};
+
+  uint64_t start_ns = 0U;
+
+  uint64_t end_ns = 0U;
+};
+
+struct ThreadRing {
+  // written by the owner before its first event is published
+
+  long tid = 0;
+
+  std::array<char, 16U> thread_name{};
+
+  std::array<Event, ring_size> events;
+
+  std::atomic<uint64_t> n_written = 0U;  // only the owner thread writes it
+};
+
+std::once_flag pool_flag;
+
+// Allocated by enable() before tracing starts and never freed, as threads may record at any time.
+std::atomic<ThreadRing*> pool = nullptr;
+
+std::atomic<size_t> n_claimed = 0U;
+
+std::atomic<size_t> n_untraced_threads = 0U;
+
+thread_local ThreadRing* local_ring = nullptr;
+
+thread_local bool local_ring_claimed = false;
+
+std::mutex path_mutex;
+
+std::string output_path = (std::filesystem::temp_directory_path() / "easyeffects-trace.json").string();
+
+// Runs on the thread that records. Nothing here allocates, locks or touches the file system.
+auto claim_ring() -> ThreadRing* {
+  auto* rings = pool.load(std::memory_order_acquire);
+
+  if (rings == nullptr) {
+    return nullptr;
+  }
+
+  local_ring_claimed = true;
+
+  const auto slot = n_claimed.fetch_add(1U, std::memory_order_relaxed);
+
+  if (slot >= max_rings) {
+    n_untraced_threads.fetch_add(1U, std::memory_order_relaxed);
+
+    return nullptr;
+  }
+
+  rings[slot].tid = syscall(SYS_gettid);
+
+  prctl(PR_GET_NAME, rings[slot].thread_name.data());
+
+  return &rings[slot];
+}
+
+}  // namespace
+
+namespace tracer {
+
+std::atomic<bool> enabled = false;
+
+void enable() {
+  std::call_once(pool_flag, []() { pool.store(new ThreadRing[max_rings], std::memory_order_release); });
+
+  enabled = true;
+
+  util::info("tracing enabled. The trace will be written to " + get_output_path());
+}
+
+void disable() {
+  enabled = false;
+}
+
+void set_output_path(const std::string& path) {
+  std::scoped_lock<std::mutex> lock(path_mutex);
+
+  output_path = path;
+}
+
+auto get_output_path() -> std::string {
+  std::scoped_lock<std::mutex> lock(path_mutex);
+
+  return output_path;
+}
+
+void record(const char* name,
+            const char* category,
+            const char* detail,
+            const uint64_t& start_ns,
+            const uint64_t& end_ns) {
+  if (local_ring == nullptr) {
+    if (local_ring_claimed) {
+      return;
+    }
+
+    local_ring = claim_ring();
+
+    if (local_ring == nullptr) {
+      return;
+    }
+  }
+
+  const auto n = local_ring->n_written.load(std::memory_order_relaxed);
+
+  auto& event = local_ring->events[n % ring_size];
+
+  event.name = name;
+  event.category = category;
+  event.start_ns = start_ns;
+  event.end_ns = end_ns;
+
+  size_t c = 0U;
+
+  if (detail != nullptr) {
+    for (; c < event.detail.size() - 1U && detail[c] != '\0'; c++) {
+      event.detail[c] = detail[c];
+    }
+  }
+
+  event.detail[c] = '\0';
+
+  local_ring->n_written.store(n + 1U, std::memory_order_release);
+}
+
+auto dump(const std::string& path) -> bool {
+  struct Snapshot {
+    long tid = 0;
+
+    std::string thread_name;
+
+    std::vector<Event> events;  // oldest first
+  };
+
+  std::vector<Snapshot> snapshots;
+
+  /*
+    The owners keep writing while we copy. Events that may have been overwritten during the copy are identified by
+    reading the counter again and are dropped. Nothing is locked, so the JSON can take as long as it needs.
+  */
+
+  if (auto* rings = pool.load(std::memory_order_acquire); rings != nullptr) {
+    const auto n_rings = std::min(n_claimed.load(std::memory_order_relaxed), max_rings);
+
+    for (size_t r = 0U; r < n_rings; r++) {
+      const auto& ring = rings[r];
+
+      const auto n_end = ring.n_written.load(std::memory_order_acquire);
+
+      if (n_end == 0U) {
+        continue;
+      }
+
+      const auto n_begin = (n_end > ring_size) ? n_end - ring_size : 0U;
+
+      std::vector<Event> events(ring.events.begin(), ring.events.end());
+
+      const auto n_after_copy = ring.n_written.load(std::memory_order_acquire);
+      const auto n_valid = (n_after_copy > ring_size) ? n_after_copy - ring_size : 0U;
+
+      auto& snapshot = snapshots.emplace_back();
+
+      snapshot.tid = ring.tid;
+      snapshot.thread_name = ring.thread_name.data();
+
+      for (auto n = std::max(n_begin, n_valid); n < n_end; n++) {
+        snapshot.events.push_back(events[n % ring_size]);
+      }
+    }
+  }
+
+  if (const auto n = n_untraced_threads.load(); n != 0U) {
+    util::warning(util::to_string(n) + " threads were not traced because all the " + util::to_string(max_rings) +
+                  " rings were in use");
+  }
+
+  const auto pid = getpid();
+
+  auto trace_events = nlohmann::json::array();
+
+  for (const auto& snapshot : snapshots) {
+    trace_events.push_back({{"name", "thread_name"},
+                            {"ph", "M"},
+                            {"pid", pid},
+                            {"tid", snapshot.tid},
+                            {"args", {{"name", snapshot.thread_name}}}});
+
+    for (const auto& event : snapshot.events) {
+      const std::string detail = event.detail.data();
+
+      const auto name = detail.empty() ? std::string(event.name) : std::string(event.name) + " " + detail;
+
+      trace_events.push_back({{"name", name},
+                              {"cat", event.category},
+                              {"ph", (event.end_ns == event.start_ns) ? "i" : "X"},
+                              {"ts", static_cast<double>(event.start_ns) / 1000.0},
+                              {"dur", static_cast<double>(event.end_ns - event.start_ns) / 1000.0},
+                              {"pid", pid},
+                              {"tid", snapshot.tid},
+                              {"args", {{"detail", detail}}}});
+    }
+  }
+
+  std::ofstream output(path);
+
+  if (!output.is_open()) {
+    util::warning("could not write the trace to " + path);
+
+    return false;
+  }
+
+  output << nlohmann::json({{"traceEvents", trace_events}, {"displayTimeUnit", "ms"}}).dump();
+
+  util::info("trace written to " + path);
+
+  return output.good();
+}
+
+}  // namespace tracer
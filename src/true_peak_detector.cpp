@@ -0,0 +1,93 @@
+/*
+ *  Copyright © 2017-2023 Wellington Wallace
+ *
+ *  This file is part of Easy Effects.
+ *
+ *  Easy Effects is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Easy Effects is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "true_peak_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+TruePeakDetector::TruePeakDetector() {
+  /*
+    Hann windowed sinc with the cutoff at the original Nyquist frequency. Its center is on a multiple of the
+    oversampling factor, so phase 0 only has one non zero tap.
+  */
+
+  constexpr auto length = n_phases * n_taps;
+  constexpr auto center = static_cast<double>(length) / 2.0;
+
+  for (uint p = 0U; p < n_phases; p++) {
+    double sum = 0.0;
+
+    for (uint k = 0U; k < n_taps; k++) {
+      const auto x = (static_cast<double>(n_phases * k + p) - center) / static_cast<double>(n_phases);
+
+      const auto sinc = (x == 0.0) ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+
+      const auto window = 0.5 + 0.5 * std::cos(std::numbers::pi * x * n_phases / (center + 1.0));
+
+      coefficients[k][p] = static_cast<float>(sinc * window);
+
+      sum += sinc * window;
+    }
+
+    // unity gain at DC for every phase
+
+    for (uint k = 0U; k < n_taps; k++) {
+      coefficients[k][p] = static_cast<float>(coefficients[k][p] / sum);
+    }
+  }
+}
+
+void TruePeakDetector::reset() {
+  history.fill(0.0F);
+}
+
+auto TruePeakDetector::process(const std::span<const float>& input) -> float {
+  std::array<float, n_phases> peak{};
+
+  for (size_t offset = 0U; offset < input.size(); offset += chunk_size) {
+    const auto n = std::min(input.size() - offset, static_cast<size_t>(chunk_size));
+
+    std::copy_n(input.begin() + offset, n, history.begin() + n_taps - 1U);
+
+    filter_chunk(n, peak);
+  }
+
+  return std::ranges::max(peak);
+}
+
+void TruePeakDetector::filter_chunk(const size_t& n, std::array<float, n_phases>& peak) {
+  for (size_t i = 0U; i < n; i++) {
+    std::array<float, n_phases> y{};
+
+    for (uint k = 0U; k < n_taps; k++) {
+      const auto x = history[i + n_taps - 1U - k];
+
+      for (uint p = 0U; p < n_phases; p++) {
+        y[p] += x * coefficients[k][p];
+      }
+    }
+
+    for (uint p = 0U; p < n_phases; p++) {
+      peak[p] = std::max(peak[p], std::fabs(y[p]));
+    }
+  }
+
+  std::copy_n(history.begin() + n, n_taps - 1U, history.begin());
+}
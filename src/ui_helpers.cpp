@@ -29,6 +29,42 @@ std::map<uint, bool> map_ignore_filter_idle_add;
 
 GSettings* global_app_settings = nullptr;
 
+constexpr auto rms_level_key = "ee-rms-level";
+
+auto on_level_query_tooltip(GtkWidget* widget,
+                            int x,
+                            int y,
+                            gboolean keyboard_mode,
+                            GtkTooltip* tooltip,
+                            gpointer user_data) -> gboolean {
+  const auto* rms = static_cast<float*>(user_data);
+
+  gtk_tooltip_set_text(tooltip, fmt::format("{0} {1:.1f} dB", _("RMS"), *rms).c_str());
+
+  return 1;
+}
+
+/*
+  The rms level is only stored on the level bar. Its tooltip text is built when GTK asks for it instead of on every
+  level update.
+*/
+
+void set_rms_level(GtkLevelBar* level_bar, const float& rms) {
+  auto* value = static_cast<float*>(g_object_get_data(G_OBJECT(level_bar), rms_level_key));
+
+  if (value == nullptr) {
+    value = g_new0(float, 1);
+
+    g_object_set_data_full(G_OBJECT(level_bar), rms_level_key, value, g_free);
+
+    gtk_widget_set_has_tooltip(GTK_WIDGET(level_bar), 1);
+
+    g_signal_connect(level_bar, "query-tooltip", G_CALLBACK(on_level_query_tooltip), value);
+  }
+
+  *value = rms;
+}
+
 }  // namespace
 
 namespace ui {
@@ -191,7 +227,9 @@ void update_level(GtkLevelBar* w_left,
                   GtkLevelBar* w_right,
                   GtkLabel* w_right_label,
                   const float& left,
-                  const float& right) {
+                  const float& right,
+                  const float& left_rms,
+                  const float& right_rms) {
   if (!GTK_IS_LEVEL_BAR(w_left) || !GTK_IS_LABEL(w_left_label) || !GTK_IS_LEVEL_BAR(w_right) ||
       !GTK_IS_LABEL(w_right_label)) {
     return;
@@ -218,6 +256,11 @@ void update_level(GtkLevelBar* w_left,
     gtk_level_bar_set_value(w_right, 0.0);
     gtk_label_set_text(w_right_label, "-99");
   }
+
+  // the bars show the peak and their tooltips show the rms level
+
+  set_rms_level(w_left, left_rms);
+  set_rms_level(w_right, right_rms);
 }
 
 auto get_plugin_credit_translated(const std::string& plugin_package) -> std::string {
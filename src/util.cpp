@@ -242,6 +242,18 @@ auto gsettings_get_range(GSettings* settings, const char* key) -> std::pair<std:
   return {min_v, max_v};
 }
 
+auto gsettings_has_key(GSettings* settings, const char* key) -> bool {
+  GSettingsSchema* schema = nullptr;
+
+  g_object_get(settings, "settings-schema", &schema, nullptr);
+
+  const auto has_key = g_settings_schema_has_key(schema, key) != 0;
+
+  g_settings_schema_unref(schema);
+
+  return has_key;
+}
+
 auto add_new_blocklist_entry(GSettings* settings, const std::string& name) -> bool {
   if (name.empty()) {
     return false;